@@ -0,0 +1,596 @@
+#define _GNU_SOURCE
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <malloc.h>
+#include <linux/perf_event.h>
+
+#include "schedule.h"
+#include "execution_manager.h"
+#include "trace.h"
+#include "simulator.h"
+#include "journal.h"
+#include "em_numa.h"
+
+/*
+ * em-bench: repeatable benchmark suite for the scheduling core.
+ * Every case prints one JSON object with ops/sec and latency percentiles (ns),
+ * the whole run is a single JSON document on stdout.
+ */
+
+#define BENCH_TIMELINE_SLOTS 1000      // Distinct release times of the synthetic schedules
+#define BENCH_RESULT_BATCH 256          // set_result calls between two schedule_reset
+#define BENCH_TASK_NAMES 100            // Distinct task names of the footprint schedule
+#define BENCH_NUMA_CHASE 1024           // Dependent loads per NUMA access sample
+#define BENCH_TASK_IDS G_MAXUINT16      // Task ids are 16 bits: past this, activations reuse ids (one result slot per id)
+
+/* Every case above BENCH_TASK_IDS activations schedules several windows of the same tasks, "distinct_tasks" reports how many */
+#define BENCH_DISTINCT_TASKS(n) MIN((n), BENCH_TASK_IDS)
+
+/* --- Options --- */
+
+static gboolean opt_quick = FALSE;
+static gint opt_max_tasks = 1000000;
+static gint opt_threads = 4;
+static gint opt_result_ops = 20000;
+static gint opt_cycles = 200;
+static gint opt_period_ms = 5;
+static gint opt_load_us = 200;
+static gint opt_sim_tasks = 100000;
+static gint opt_guard_us = 200;
+static gint opt_numa_mb = 64;
+
+static GOptionEntry bench_entries[] = {
+    { "quick", 'q', 0, G_OPTION_ARG_NONE, &opt_quick, "Small sizes, for smoke runs", NULL },
+    { "max-tasks", 'n', 0, G_OPTION_ARG_INT, &opt_max_tasks, "Largest schedule to build (default 1000000)", "N" },
+    { "threads", 't', 0, G_OPTION_ARG_INT, &opt_threads, "Concurrent schedule_set_result threads (default 4)", "N" },
+    { "result-ops", 'r', 0, G_OPTION_ARG_INT, &opt_result_ops, "schedule_set_result calls per thread (default 20000)", "N" },
+    { "cycles", 'c', 0, G_OPTION_ARG_INT, &opt_cycles, "Release latency cycles (default 200)", "N" },
+    { "period-ms", 'p', 0, G_OPTION_ARG_INT, &opt_period_ms, "Release latency period in ms (default 5)", "MS" },
+    { "load-us", 'l', 0, G_OPTION_ARG_INT, &opt_load_us, "Synthetic task_exec load in us (default 200)", "US" },
+    { "sim-tasks", 's', 0, G_OPTION_ARG_INT, &opt_sim_tasks, "Tasks of the one hour simulated schedule (default 100000)", "N" },
+    { "guard-us", 'g', 0, G_OPTION_ARG_INT, &opt_guard_us, "Initial guard of the precise release run, 0 skips it (default 200)", "US" },
+    { "numa-mb", 'm', 0, G_OPTION_ARG_INT, &opt_numa_mb, "Task data chased by the NUMA placement cases (default 64)", "MB" },
+    G_OPTION_ENTRY_NULL
+};
+
+
+/* -----------------Helper Functions ----------------- */
+
+static inline gint64 now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (gint64)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void silent_print(const gchar *string) {
+    (void)string;
+}
+
+static gint compare_gint64(const void *a, const void *b) {
+    gint64 x = *(const gint64 *)a, y = *(const gint64 *)b;
+    return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+static gint64 percentile(const gint64 *sorted, gsize n, gdouble q) {
+    if (n == 0) return 0;
+    gsize idx = (gsize)(q * (gdouble)(n - 1));
+    return sorted[idx];
+}
+
+static gboolean first_result = TRUE;
+
+/* Sorts the samples in place and prints one result object */
+static void report_run(const gchar *name, const gchar *params, gint64 *samples, gsize n, gint64 total_ns, const gchar *unit) {
+    qsort(samples, n, sizeof(gint64), compare_gint64);
+    gdouble ops_per_sec = (total_ns > 0) ? (gdouble)n * 1e9 / (gdouble)total_ns : 0.0;
+
+    fprintf(stdout, "%s\n    {\"name\":\"%s\",%s,\"ops\":%" G_GSIZE_FORMAT ",\"ops_per_sec\":%.1f,"
+                    "\"latency_%s\":{\"p50\":%ld,\"p90\":%ld,\"p99\":%ld,\"p999\":%ld,\"max\":%ld}}",
+            first_result ? "" : ",", name, params, n, ops_per_sec, unit,
+            (long)percentile(samples, n, 0.50), (long)percentile(samples, n, 0.90),
+            (long)percentile(samples, n, 0.99), (long)percentile(samples, n, 0.999),
+            (long)(n ? samples[n - 1] : 0));
+    fflush(stdout);
+    first_result = FALSE;
+}
+
+static gpointer noop_task(gpointer data) {
+    (void)data;
+    return NULL;
+}
+
+/* Same load for every job of the latency case: a global instead of one pooled input per task */
+static gint bench_load_us = 0;
+
+static gpointer busy_task(gpointer data) {
+    (void)data;
+    gint64 load_ns = (gint64)g_atomic_int_get(&bench_load_us) * 1000;
+    gint64 end = now_ns() + load_ns;
+    while (now_ns() < end) {
+        /* Synthetic CPU load */
+    }
+    return NULL;
+}
+
+/* Hardware cache miss counter of the calling thread, -1 when perf events are not allowed */
+static gint cache_miss_counter_open(void) {
+    struct perf_event_attr attr = { 0 };
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (gint)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static gint64 cache_miss_counter_read(gint fd) {
+    guint64 value = 0;
+    if (fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value)) return -1;
+    return (gint64)value;
+}
+
+static gint rt_policy(void) {
+    struct rlimit rl;
+    if (geteuid() == 0) return SCHED_FIFO;
+    if (getrlimit(RLIMIT_RTPRIO, &rl) == 0 && rl.rlim_cur > 0) return SCHED_FIFO;
+    return SCHED_OTHER;
+}
+
+
+/* ----------------- Schedule build ----------------- */
+
+static void bench_schedule_build(gint n_tasks) {
+    gint64 *samples = g_new(gint64, n_tasks);
+    schedule_t *sched = schedule_new("bench-build", "0.0.1");
+
+    gint64 begin = now_ns();
+    for (gint i = 0; i < n_tasks; i++) {
+        gint64 start = i % BENCH_TIMELINE_SLOTS;
+        gint64 t0 = now_ns();
+        schedule_add_task(sched, (guint16)(i % BENCH_TASK_IDS), "bench", noop_task, SCHED_OTHER, 0,
+                          0, 1, NULL, start, start + 10, NULL);
+        samples[i] = now_ns() - t0;
+    }
+    gint64 total = now_ns() - begin;
+
+    gchar *params = g_strdup_printf("\"tasks\":%d,\"distinct_tasks\":%d", n_tasks, BENCH_DISTINCT_TASKS(n_tasks));
+    report_run("schedule_add_task", params, samples, n_tasks, total, "ns");
+
+    /* schedule_reset over the same schedule */
+    const gint resets = 20;
+    begin = now_ns();
+    for (gint i = 0; i < resets; i++) {
+        gint64 t0 = now_ns();
+        schedule_reset(sched);
+        samples[i] = now_ns() - t0;
+    }
+    total = now_ns() - begin;
+    report_run("schedule_reset", params, samples, resets, total, "ns");
+
+    gint64 t0 = now_ns();
+    schedule_free(sched);
+    samples[0] = now_ns() - t0;
+    report_run("schedule_free", params, samples, 1, samples[0], "ns");
+
+    g_free(params);
+    g_free(samples);
+}
+
+
+/* ----------------- Results contention ----------------- */
+
+typedef struct {
+    schedule_t *sched;
+    guint16 task_id;
+    gint ops;
+    gint64 *samples;
+    GMutex *reset_lock;
+} result_worker_t;
+
+static gpointer result_worker_func(gpointer data) {
+    result_worker_t *w = (result_worker_t *)data;
+    for (gint i = 0; i < w->ops; i++) {
+        gint64 t0 = now_ns();
+        schedule_set_result(w->sched, w->task_id, "{}");
+        w->samples[i] = now_ns() - t0;
+
+        /* Keep the output lists short, otherwise the append cost dominates */
+        if ((i + 1) % BENCH_RESULT_BATCH == 0 && w->reset_lock && g_mutex_trylock(w->reset_lock)) {
+            schedule_reset(w->sched);
+            g_mutex_unlock(w->reset_lock);
+        }
+    }
+    return NULL;
+}
+
+static void bench_set_result(gint n_threads, gint ops, gboolean shared_task) {
+    schedule_t *sched = schedule_new("bench-results", "0.0.1");
+    for (gint t = 0; t < n_threads; t++) {
+        schedule_add_task(sched, (guint16)(t + 1), "bench", noop_task, SCHED_OTHER, 0, 0, 255, NULL, 0, 10, NULL);
+    }
+
+    GMutex reset_lock;
+    g_mutex_init(&reset_lock);
+    result_worker_t *workers = g_new0(result_worker_t, n_threads);
+    GThread **threads = g_new0(GThread *, n_threads);
+    gint64 *samples = g_new(gint64, (gsize)n_threads * ops);
+
+    gint64 begin = now_ns();
+    for (gint t = 0; t < n_threads; t++) {
+        workers[t].sched = sched;
+        workers[t].task_id = shared_task ? 1 : (guint16)(t + 1);
+        workers[t].ops = ops;
+        workers[t].samples = samples + (gsize)t * ops;
+        workers[t].reset_lock = &reset_lock;
+        threads[t] = g_thread_new("bench-result", result_worker_func, &workers[t]);
+    }
+    for (gint t = 0; t < n_threads; t++) g_thread_join(threads[t]);
+    gint64 total = now_ns() - begin;
+
+    gchar *params = g_strdup_printf("\"threads\":%d,\"shared_task\":%s", n_threads, shared_task ? "true" : "false");
+    report_run("schedule_set_result", params, samples, (gsize)n_threads * ops, total, "ns");
+
+    g_free(params);
+    g_free(samples);
+    g_free(threads);
+    g_free(workers);
+    g_mutex_clear(&reset_lock);
+    schedule_free(sched);
+}
+
+
+/* ----------------- Completion notification ----------------- */
+
+typedef struct {
+    schedule_t *sched;
+    gint ops;
+    gint64 *samples;            // Completion -> wake up latency (us)
+    gint acked;                 // Notifications consumed (atomic)
+} notify_waiter_t;
+
+/* Stands for the dispatcher: wakes up on the completion eventfd */
+static gpointer notify_waiter_func(gpointer data) {
+    notify_waiter_t *w = (notify_waiter_t *)data;
+    struct pollfd pfd = { .fd = w->sched->schedule_completion_fd, .events = POLLIN };
+    while (g_atomic_int_get(&w->acked) < w->ops) {
+        if (poll(&pfd, 1, 100) <= 0) continue;
+        guint64 count;
+        if (read(pfd.fd, &count, sizeof(count)) != sizeof(count)) continue;
+        gint64 latency_us = g_get_monotonic_time() - __atomic_load_n(&w->sched->schedule_last_completion_us, __ATOMIC_RELAXED);
+        w->samples[g_atomic_int_get(&w->acked)] = latency_us;
+        g_atomic_int_inc(&w->acked);
+    }
+    return NULL;
+}
+
+static void bench_completion_notify(gint ops) {
+    ops = MIN(ops, G_MAXUINT16);
+    schedule_t *sched = schedule_new("bench-notify", "0.0.1");
+    if (sched->schedule_completion_fd < 0) {
+        schedule_free(sched);
+        return;
+    }
+    for (gint i = 0; i < ops; i++) {
+        schedule_add_task(sched, (guint16)(i + 1), "bench", noop_task, SCHED_OTHER, 0, 0, 1, NULL, 0, 10, NULL);
+    }
+
+    notify_waiter_t waiter = { sched, ops, g_new(gint64, ops), 0 };
+    GThread *thread = g_thread_new("bench-notify", notify_waiter_func, &waiter);
+
+    /* One completion at a time, each one waits for its notification */
+    gint64 begin = now_ns();
+    for (gint i = 0; i < ops; i++) {
+        schedule_set_result(sched, (guint16)(i + 1), "{}");
+        while (g_atomic_int_get(&waiter.acked) <= i) {
+            /* Spin until the waiter consumed it */
+        }
+    }
+    gint64 total = now_ns() - begin;
+    g_thread_join(thread);
+
+    gchar *params = g_strdup_printf("\"completed\":%s", schedule_is_completed(sched) ? "true" : "false");
+    report_run("completion_notify", params, waiter.samples, ops, total, "us");
+
+    g_free(params);
+    g_free(waiter.samples);
+    schedule_free(sched);
+}
+
+
+/* ----------------- Journal ----------------- */
+
+/* Cost of one journal record on the hot path (stores into a prefaulted shared mapping) */
+static void bench_journal_append(gint ops) {
+    gchar *path = g_build_filename(g_get_tmp_dir(), "em-bench-journal.bin", NULL);
+    journal_t *journal = journal_open(path, JOURNAL_DEFAULT_RECORDS);
+    if (!journal) {
+        g_free(path);
+        return;
+    }
+    guint16 schedule_id = journal_register_schedule(journal, "bench-journal", "0.0.1");
+
+    gint64 *samples = g_new(gint64, ops);
+    gint64 begin = now_ns();
+    for (gint i = 0; i < ops; i++) {
+        gint64 t0 = now_ns();
+        journal_append(journal, JOURNAL_EVENT_COMPLETE, schedule_id, (guint16)i, 0, 0, i, "{}");
+        samples[i] = now_ns() - t0;
+    }
+    gint64 total = now_ns() - begin;
+
+    gchar *params = g_strdup_printf("\"records\":%d", JOURNAL_DEFAULT_RECORDS);
+    report_run("journal_append", params, samples, ops, total, "ns");
+
+    g_free(params);
+    g_free(samples);
+    journal_close(journal);
+    unlink(path);
+    g_free(path);
+}
+
+
+/* ----------------- NUMA placement ----------------- */
+
+/* Load latency of a worker pinned on cpu over task data placed on data_node (random cycle of cache lines) */
+static void bench_numa_access(const gchar *name, gint cpu, gint data_node, gsize bytes, gint rounds) {
+    cpu_set_t saved, set;
+    sched_getaffinity(0, sizeof(saved), &saved);
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) < 0) return;
+
+    gsize n_lines = bytes / 64;
+    gsize *data = em_numa_alloc(n_lines * 64, data_node);
+    if (!data) {
+        sched_setaffinity(0, sizeof(saved), &saved);
+        return;
+    }
+
+    /* 1. One cycle through all the lines (Sattolo), so every load depends on the previous one */
+    gsize *order = g_new(gsize, n_lines);
+    for (gsize i = 0; i < n_lines; i++) order[i] = i;
+    guint64 rng = 0x9E3779B97F4A7C15ULL;
+    for (gsize i = n_lines - 1; i > 0; i--) {
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+        gsize j = rng % i;
+        gsize tmp = order[i]; order[i] = order[j]; order[j] = tmp;
+    }
+    for (gsize i = 0; i < n_lines; i++) data[order[i] * 8] = order[(i + 1) % n_lines] * 8;
+    g_free(order);
+
+    /* 2. Chase */
+    gint64 *samples = g_new(gint64, rounds);
+    volatile gsize idx = 0;
+    gint64 begin = now_ns();
+    for (gint r = 0; r < rounds; r++) {
+        gsize next = idx;
+        gint64 t0 = now_ns();
+        for (gint k = 0; k < BENCH_NUMA_CHASE; k++) next = data[next];
+        samples[r] = (now_ns() - t0) / BENCH_NUMA_CHASE;
+        idx = next;
+    }
+    gint64 total = now_ns() - begin;
+
+    gchar *params = g_strdup_printf("\"cpu\":%d,\"cpu_node\":%d,\"data_node\":%d,\"mapped_node\":%d,\"bytes\":%" G_GSIZE_FORMAT ",\"loads_per_op\":%d",
+                                    cpu, em_numa_node_of_cpu(cpu), data_node, em_numa_node_of_addr(data), n_lines * 64, BENCH_NUMA_CHASE);
+    report_run(name, params, samples, rounds, total, "ns");
+
+    g_free(params);
+    g_free(samples);
+    em_numa_free(data, n_lines * 64);
+    sched_setaffinity(0, sizeof(saved), &saved);
+}
+
+/* Workers of every node against local and remote task data: the gain of the node-local placement */
+static void bench_numa_placement(gint mb, gint rounds) {
+    gint n_nodes = em_numa_node_count();
+    gsize bytes = (gsize)MAX(mb, 1) << 20;
+
+    for (gint node = 0; node < n_nodes; node++) {
+        gint cpu = em_numa_first_cpu_of_node(node);
+        if (cpu < 0) continue;
+        bench_numa_access("numa_local_access", cpu, node, bytes, rounds);
+        if (n_nodes > 1) bench_numa_access("numa_remote_access", cpu, (node + 1) % n_nodes, bytes, rounds);
+    }
+}
+
+
+/* ----------------- Release latency ----------------- */
+
+static void bench_release_latency(gint cycles, gint period_ms, gint load_us, gint guard_us) {
+    gint n_cpus = MIN((gint)g_get_num_processors(), 4);
+    gint policy = rt_policy();
+    gint priority = (policy == SCHED_FIFO) ? 80 : 0;
+
+    g_atomic_int_set(&bench_load_us, load_us);
+
+    /* One synthetic task per core and per period, like cyclictest -t */
+    cycles = MIN(cycles, (G_MAXUINT16 - 1) / n_cpus);
+    schedule_t *sched = schedule_new("bench-latency", "0.0.1");
+    guint16 id = 1;
+    for (gint c = 0; c < cycles; c++) {
+        gint64 start = (gint64)(c + 1) * period_ms;
+        for (gint cpu = 0; cpu < n_cpus; cpu++) {
+            schedule_add_task(sched, id++, "load", busy_task, policy, priority, cpu, 1, NULL,
+                              start, start + period_ms, NULL);
+        }
+    }
+
+    execution_manager_t *em = em_new("em-bench");
+    em->trace = trace_new((guint)id * 4 + 1024, FALSE);
+    if (guard_us > 0) em_enable_precise_release(em, guard_us);
+
+    em_run_schedule(em, sched);
+    g_usleep((gulong)period_ms * 1000);  // Let the last workers finish
+
+    /* Release -> start latency of every job, dispatcher wakeup lateness: the trace records them in us, reported as is */
+    trace_buffer_t *tb = em->trace;
+    guint used = MIN((guint)g_atomic_int_get(&tb->next), tb->capacity);
+    gint64 *release = g_new(gint64, used + 1);
+    gint64 *wakeup = g_new(gint64, used + 1);
+    gsize n_release = 0, n_wakeup = 0;
+    for (guint i = 0; i < used; i++) {
+        trace_event_t *ev = &tb->events[i];
+        if (!g_atomic_int_get(&ev->committed)) continue;
+        if (ev->type == TRACE_EVENT_START) release[n_release++] = ev->arg;
+        else if (ev->type == TRACE_EVENT_WAKEUP) wakeup[n_wakeup++] = ev->arg;
+    }
+
+    gint64 duration_ns = (gint64)(cycles + 1) * period_ms * 1000000LL;
+    gchar *params = g_strdup_printf("\"cpus\":%d,\"cycles\":%d,\"period_ms\":%d,\"load_us\":%d,\"policy\":\"%s\",\"guard_us\":%d",
+                                    n_cpus, cycles, period_ms, load_us, policy == SCHED_FIFO ? "fifo" : "other", guard_us);
+    report_run("release_latency", params, release, n_release, duration_ns, "us");
+    report_run("dispatcher_wakeup_lateness", params, wakeup, n_wakeup, duration_ns, "us");
+
+    g_free(params);
+    g_free(release);
+    g_free(wakeup);
+    em_free(em);
+    schedule_free(sched);
+}
+
+
+/* ----------------- Activation footprint ----------------- */
+
+/* Heap bytes per activation and cache misses of a dispatcher-like scan of the start timeline */
+/* Baseline with the heap records (GString names, GSList chains): 552.6 bytes per activation for 100k tasks */
+static void bench_activation_footprint(gint n_tasks) {
+    gchar names[BENCH_TASK_NAMES][16];
+    for (gint i = 0; i < BENCH_TASK_NAMES; i++) g_snprintf(names[i], sizeof(names[i]), "task-%d", i);
+
+    struct mallinfo2 before = mallinfo2();
+    schedule_t *sched = schedule_new("bench-footprint", "0.0.1");
+    for (gint i = 0; i < n_tasks; i++) {
+        gint64 start = i % BENCH_TIMELINE_SLOTS;
+        schedule_add_task(sched, (guint16)(i % BENCH_TASK_IDS), names[i % BENCH_TASK_NAMES], noop_task, SCHED_FIFO,
+                          (gint8)(1 + i % 50), i % 4, 1, NULL, start, start + 10, NULL);
+    }
+    struct mallinfo2 after = mallinfo2();
+    gdouble bytes_per_activation = (gdouble)(after.uordblks - before.uordblks) / (gdouble)n_tasks;
+
+    gint fd = cache_miss_counter_open();
+    gint64 *samples = g_new(gint64, sched->schedule_start_info->length);
+    gsize n = 0;
+    volatile guint64 sink = 0;
+
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    gint64 begin = now_ns();
+    for (GList *l = sched->schedule_start_info->head; l != NULL; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        gint64 t0 = now_ns();
+        /* The fields handle_initialization reads for every release */
+        for (guint i = 0; i < entry->items->len; i++) {
+            activation_data_t *act = timeline_entry_activation(entry, i);
+            sink += act->task_id + act->cpu_affinity + act->priority + act->policy + act->criticality
+                    + (guint64)(gsize)act->task_exec + (guint64)(gsize)act->input_data;
+        }
+        samples[n++] = now_ns() - t0;
+    }
+    gint64 total = now_ns() - begin;
+    if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    gint64 misses = cache_miss_counter_read(fd);
+    if (fd >= 0) close(fd);
+
+    gchar *params = g_strdup_printf("\"tasks\":%d,\"distinct_tasks\":%d,\"record_bytes\":%" G_GSIZE_FORMAT ",\"heap_bytes_per_activation\":%.1f,\"scan_cache_misses\":%ld",
+                                    n_tasks, BENCH_DISTINCT_TASKS(n_tasks), sizeof(activation_data_t), bytes_per_activation, (long)misses);
+    report_run("activation_scan", params, samples, n, total, "ns");
+
+    g_free(params);
+    g_free(samples);
+    schedule_free(sched);
+}
+
+
+/* ----------------- Virtual time simulation ----------------- */
+
+static void bench_simulate(gint n_tasks) {
+    const gint64 horizon_ms = 3600 * 1000;
+    schedule_t *sched = schedule_new("bench-sim", "0.0.1");
+    for (gint i = 0; i < n_tasks; i++) {
+        gint64 start = (gint64)i * horizon_ms / n_tasks;
+        schedule_add_task(sched, (guint16)(i % BENCH_TASK_IDS), "sim", noop_task, SCHED_FIFO, (gint8)(1 + i % 50),
+                          i % 4, 1, NULL, start, start + 50, NULL);
+    }
+
+    execution_manager_t *em = em_new("em-bench");
+    sim_config_t *cfg = sim_config_new(SIM_EXEC_FIXED, 2000, 1);
+    sim_report_t report;
+
+    gint64 t0 = now_ns();
+    em_simulate_schedule(em, sched, cfg, &report);
+    gint64 sample = now_ns() - t0;
+
+    gchar *params = g_strdup_printf("\"tasks\":%d,\"distinct_tasks\":%d,\"virtual_ms\":%ld,\"misses\":%" G_GUINT64_FORMAT,
+                                    n_tasks, BENCH_DISTINCT_TASKS(n_tasks), (long)(report.virtual_end_ns / EM_NSEC_PER_MSEC), report.deadline_misses);
+    report_run("simulate_schedule", params, &sample, 1, sample, "ns");
+
+    g_free(params);
+    sim_config_free(cfg);
+    em_free(em);
+    schedule_free(sched);
+}
+
+
+
+int main(int argc, char *argv[]) {
+    GError *error = NULL;
+    GOptionContext *context = g_option_context_new("- scheduling core benchmark suite");
+    g_option_context_add_main_entries(context, bench_entries, NULL);
+    if (!g_option_context_parse(context, &argc, &argv, &error)) {
+        g_printerr("[ERROR] em-bench: %s\n", error->message);
+        g_error_free(error);
+        g_option_context_free(context);
+        return 1;
+    }
+    g_option_context_free(context);
+
+    if (opt_quick) {
+        opt_max_tasks = MIN(opt_max_tasks, 10000);
+        opt_result_ops = MIN(opt_result_ops, 2000);
+        opt_cycles = MIN(opt_cycles, 20);
+        opt_sim_tasks = MIN(opt_sim_tasks, 10000);
+        opt_numa_mb = MIN(opt_numa_mb, 16);
+    }
+
+    /* The scheduling core logs through g_print, keep stdout for the JSON report */
+    g_set_print_handler(silent_print);
+
+    fprintf(stdout, "{\"benchmark\":\"em-bench\",\"results\":[");
+
+    for (gint n = 1000; n <= opt_max_tasks; n *= 10) {
+        bench_schedule_build(n);
+    }
+
+    bench_set_result(1, opt_result_ops, FALSE);
+    bench_set_result(opt_threads, opt_result_ops, FALSE);
+    bench_set_result(opt_threads, opt_result_ops, TRUE);
+
+    bench_completion_notify(opt_result_ops);
+
+    bench_journal_append(opt_result_ops);
+
+    bench_activation_footprint(MIN(opt_max_tasks, 100000));
+
+    bench_simulate(opt_sim_tasks);
+
+    bench_numa_placement(opt_numa_mb, opt_result_ops);
+
+    bench_release_latency(opt_cycles, opt_period_ms, opt_load_us, 0);
+    if (opt_guard_us > 0) bench_release_latency(opt_cycles, opt_period_ms, opt_load_us, opt_guard_us);
+
+    fprintf(stdout, "\n]}\n");
+    return 0;
+}
@@ -0,0 +1,96 @@
+#ifndef APERIODIC_SERVER_H
+#define APERIODIC_SERVER_H
+
+#include <glib.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "metrics.h"
+#include "trace.h"
+
+#define APERIODIC_QUEUE_MAX 256         // Pending jobs per server, later submissions are rejected
+#define APERIODIC_DEFAULT_PRIORITY 90   // Above the periodic tasks: fast response, interference bounded by the budget
+
+/* --- Aperiodic Server Structures --- */
+
+/* Event driven job, run once by the server of its core */
+typedef struct {
+    guint32 job_id;
+    guint16 task_id;            // Tag of the job in traces
+    GThreadFunc func;           // Job body, its result is freed
+    gpointer input;
+    GDestroyNotify input_free;  // Releases input after the run, NULL = not owned
+    gint64 submit_ns;           // Monotonic submission time
+    gint64 finish_ns;           // Monotonic completion time (worker)
+} aperiodic_job_t;
+
+/* Budget given back at time_ns, POSIX SCHED_SPORADIC rule */
+typedef struct {
+    gint64 time_ns;
+    gint64 amount_ns;
+} aperiodic_replenishment_t;
+
+/*
+ * Sporadic server of one core: a pinned worker runs the aperiodic jobs in
+ * submission order at the server priority while budget is left. Budget is
+ * the CPU time of the worker; what is consumed from the moment the server
+ * becomes active comes back one period later, so in any window of length
+ * period the periodic tasks see at most capacity of interference. Out of
+ * budget the worker keeps running as SCHED_OTHER (background service).
+ * The dispatcher drives the server with aperiodic_server_update, wakeups
+ * come from event_fd (submissions, completions) and the returned time.
+ */
+typedef struct {
+    gint cpu;
+    gint priority;              // SCHED_FIFO priority with budget, 0 = SCHED_OTHER
+    gint64 capacity_ns;         // Budget per period
+    gint64 period_ns;           // Replenishment period
+
+    /* Job hand-off (lock) */
+    GMutex lock;
+    GCond assigned;
+    GQueue *pending;            // aperiodic_job_t* waiting for budget
+    aperiodic_job_t *current;   // Job handed to the worker, NULL = idle
+    aperiodic_job_t *done;      // Job finished, not accounted yet
+    gboolean stop;
+    guint32 next_job_id;
+    gint event_fd;              // eventfd written on submission and completion
+
+    pthread_t worker;
+    gboolean worker_started;
+    clockid_t worker_clock;     // CPU clock of the worker, the budget meter
+    metrics_t *metrics;         // Set before a run, read by the worker after a hand-off
+    trace_buffer_t *trace;
+
+    /* Sporadic server state (dispatcher only) */
+    gint64 budget_ns;           // Budget left
+    gint64 charged_cpu_ns;      // Worker CPU time already charged
+    gint64 active_since_ns;     // Start of the current active interval, -1 = not active
+    gint64 active_consumed_ns;  // Consumed since active_since_ns, replenished one period later
+    GQueue *replenishments;     // aperiodic_replenishment_t*, by time
+    gboolean busy;              // A job is handed to the worker
+    gboolean demoted;           // Worker running in background, budget exhausted
+
+    /* Statistics */
+    guint64 submitted;          // Atomic
+    guint64 rejected;           // Atomic
+    guint64 served;
+    guint64 exhaustions;
+    gint64 consumed_ns;         // Budget consumed over all the runs
+    gint64 background_ns;       // CPU time run without budget
+    gint64 max_response_ns;
+    gint64 total_response_ns;
+} aperiodic_server_t;
+
+
+/* Aperiodic Server Constructor/Destructor */
+aperiodic_server_t* aperiodic_server_new(gint cpu, gint priority, gint64 capacity_us, gint64 period_us);
+void aperiodic_server_free(aperiodic_server_t *srv);
+
+/* Aperiodic Server Methods */
+guint32 aperiodic_server_submit(aperiodic_server_t *srv, guint16 task_id, GThreadFunc func, gpointer input, GDestroyNotify input_free);
+gint64 aperiodic_server_update(aperiodic_server_t *srv, gint64 now_ns);
+gint64 aperiodic_server_demand_ns(const aperiodic_server_t *srv, gint64 interval_ns);
+void aperiodic_server_print(aperiodic_server_t *srv);
+
+#endif // APERIODIC_SERVER_H
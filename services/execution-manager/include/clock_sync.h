@@ -0,0 +1,76 @@
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <glib.h>
+
+#define CLOCK_SYNC_DEFAULT_PORT 31900
+#define CLOCK_SYNC_DEFAULT_INTERVAL_MS 100
+#define CLOCK_SYNC_SAMPLES 16           // Exchanges kept for the offset/drift fit
+#define CLOCK_SYNC_LOCK_SAMPLES 4       // Exchanges before the estimate is trusted
+#define CLOCK_SYNC_MAX_DRIFT_PPB 500000 // Fitted drift is clamped to +-500 ppm
+
+/* --- Clock Sync Structures --- */
+
+typedef enum {
+    CLOCK_SYNC_MASTER   = 0,    // Owns the common epoch, answers the followers
+    CLOCK_SYNC_FOLLOWER = 1     // Estimates its offset to the master
+} clock_sync_role_t;
+
+/* One two-way exchange, PTP delay request-response style (ns) */
+typedef struct {
+    gint64 local_ns;            // Midpoint of the exchange on the local clock
+    gint64 offset_ns;           // Master minus local: ((t2 - t1) + (t3 - t4)) / 2
+    gint64 delay_ns;            // Round trip without the master turnaround: (t4 - t1) - (t3 - t2)
+} clock_sync_sample_t;
+
+/*
+ * Common timeline of several execution managers. The master answers time
+ * requests on a UDP port with its CLOCK_MONOTONIC timestamps and the epoch
+ * of the group; every follower exchanges with it periodically, keeps the
+ * samples with the smallest round trip (the least queued ones) and fits
+ * offset and drift over them. The estimate is published with a seqlock,
+ * so RT threads can map times without locking.
+ */
+typedef struct {
+    clock_sync_role_t role;
+    gint fd;                    // UDP socket
+    gint stop;                  // Atomic flag for the exchange thread
+    GThread *thread;
+    guint interval_ms;          // Follower exchange period
+    gint64 epoch_ns;            // Group epoch on the master clock (atomic)
+
+    /* Estimate (seqlock, written by the exchange thread only) */
+    gint seq;
+    gint64 ref_ns;              // Local time of the fit
+    gint64 offset_ns;           // Master minus local at ref_ns
+    gint64 drift_ppb;           // Master rate minus local rate
+    gint locked;                // Estimate usable (atomic)
+
+    /* Follower state (exchange thread only) */
+    clock_sync_sample_t samples[CLOCK_SYNC_SAMPLES];
+    guint n_samples;
+    guint32 next_seq;
+
+    /* Statistics (atomic) */
+    guint64 exchanges;
+    guint64 lost;               // Requests without a reply in the period
+    gint64 last_delay_ns;
+    gint64 last_error_ns;       // Last measured offset minus the predicted one
+    gint64 max_error_ns;        // Worst prediction error once locked
+} clock_sync_t;
+
+
+/* Clock Sync Constructor/Destructor */
+clock_sync_t* clock_sync_new_master(gint port);
+clock_sync_t* clock_sync_new_follower(const gchar *host, gint port, guint interval_ms);
+void clock_sync_free(clock_sync_t *cs);
+
+/* Clock Sync Methods (lock-free, safe from RT threads) */
+gboolean clock_sync_is_locked(clock_sync_t *cs);
+gboolean clock_sync_wait_locked(clock_sync_t *cs, gint64 timeout_us);
+gint64 clock_sync_to_master_ns(clock_sync_t *cs, gint64 local_ns);
+gint64 clock_sync_to_local_ns(clock_sync_t *cs, gint64 master_ns);
+gint64 clock_sync_next_boundary_ns(clock_sync_t *cs, gint64 after_local_ns, gint64 period_ns);
+void clock_sync_print(clock_sync_t *cs);
+
+#endif // CLOCK_SYNC_H
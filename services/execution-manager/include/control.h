@@ -0,0 +1,73 @@
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include <glib.h>
+
+#define CONTROL_MAX_LINE 512
+
+/* --- Control Structures --- */
+
+typedef enum {
+    CONTROL_CMD_ADD    = 0,     // New task in a running schedule
+    CONTROL_CMD_REMOVE = 1,     // Drop the activations not released yet
+    CONTROL_CMD_MODIFY = 2,     // Move the next activation (window, priority, cpu, budget)
+    CONTROL_CMD_SUBMIT = 3      // Aperiodic job for the server of a core, on the input of a task
+} control_cmd_t;
+
+/* One parsed command, answered by the dispatcher */
+typedef struct {
+    control_cmd_t cmd;
+    gchar *schedule;            // Schedule name
+    guint16 task_id;
+    gchar *name;                // ADD: task name
+    GThreadFunc task_exec;      // ADD, SUBMIT: registered task function
+    gint input_task;            // ADD: task whose input is shared (required, task functions read it), -1 otherwise
+    gint policy;                // ADD: SCHED_FIFO, SCHED_RR or SCHED_OTHER
+    gint8 priority;
+    gint cpu_affinity;
+    gint64 start_ns;            // Release, offset from the time zero of the run
+    gint64 end_ns;              // Deadline, offset from the time zero of the run
+    gint64 wcet_us;             // Declared execution time, used by the admission test
+    gchar *reply;               // "ACCEPTED ..." or "REJECTED <reason>", written by the dispatcher
+    gboolean done;
+} control_request_t;
+
+/*
+ * Local control socket: one command per line, one reply line per command.
+ * Requests are parsed on the server thread and handed to the dispatcher
+ * through wakeup_fd; the server thread waits for the reply, so commands
+ * are applied one at a time, between two dispatcher events.
+ */
+typedef struct {
+    gchar *socket_path;
+    gint listen_fd;
+    gint wakeup_fd;             // eventfd written for every queued request
+    gint stop;                  // Atomic flag for the server thread
+    GThread *server_thread;
+    GHashTable *tasks;          // Map: task function name -> GThreadFunc, filled before the server starts
+
+    GMutex lock;                // Protects pending, live and the replies
+    GCond replied;
+    GQueue *pending;            // control_request_t* waiting for the dispatcher
+    gboolean live;              // A run accepts requests
+
+    guint64 accepted;           // Atomic
+    guint64 rejected;           // Atomic
+} control_t;
+
+
+/* Control Constructor/Destructor */
+control_t* control_new(void);
+void control_free(control_t *ctl);
+
+/* Control Endpoint */
+void control_register_task(control_t *ctl, const gchar *name, GThreadFunc task_exec);
+gboolean control_start_server(control_t *ctl, const gchar *socket_path);
+void control_stop_server(control_t *ctl);
+
+/* Dispatcher side */
+void control_set_live(control_t *ctl, gboolean live);
+control_request_t* control_next_request(control_t *ctl);
+void control_reply(control_t *ctl, control_request_t *req, gboolean accepted, const gchar *format, ...) G_GNUC_PRINTF(4, 5);
+
+#endif // CONTROL_H
@@ -0,0 +1,83 @@
+#ifndef CPU_BUDGET_H
+#define CPU_BUDGET_H
+
+#include <glib.h>
+#include <signal.h>
+#include <time.h>
+
+#include "schedule.h"
+
+#define CPU_BUDGET_MAX_TASKS 1024           // Task ids above are enforced but not recorded
+#define CPU_BUDGET_SIGNAL (SIGRTMIN + 2)    // Sent to the worker by its CPU time timer
+
+/* --- CPU Budget Structures --- */
+
+/* Budget enforcement of the calling worker, one per thread (TLS) */
+typedef struct {
+    timer_t timer;              // POSIX timer on CLOCK_THREAD_CPUTIME_ID, signals the worker itself
+    volatile sig_atomic_t armed;
+    volatile sig_atomic_t expired;
+    volatile sig_atomic_t deferred; // Expired while holding a resource, applied at its release
+    volatile sig_atomic_t generation;   // Job of the timer, a late signal of a previous job is ignored
+    volatile sig_atomic_t demoted;      // Running as SCHED_OTHER, restored by disarm
+    volatile sig_atomic_t abort_pending; // Abort requested, taken at the next budget checkpoint
+    guint8 action;              // task_budget_action_t
+    gint policy;                // Scheduling of the worker before a demotion
+    struct sched_param param;
+    gint64 start_cpu_ns;        // Thread CPU time when armed
+} cpu_budget_job_t;
+
+/* What happened to a job under its budget, filled by cpu_budget_disarm */
+typedef struct {
+    gint64 cpu_ns;              // CPU time of the job since arm
+    gboolean exhausted;         // Budget exhausted
+    gboolean demoted;           // Finished as SCHED_OTHER
+    gboolean abort_missed;      // Abort requested, but the job finished before reaching a checkpoint
+} cpu_budget_outcome_t;
+
+/* Enforcement record of a task, written by its workers (atomic) */
+typedef struct {
+    guint64 jobs;               // Jobs run with a CPU budget
+    guint64 overruns;           // Jobs that exhausted it
+    guint64 demotions;          // Jobs demoted to SCHED_OTHER (demote action, or abort not taken yet)
+    guint64 aborts;             // Jobs cancelled at a checkpoint
+    guint64 aborts_missed;      // Abort requested, the job completed without reaching a checkpoint
+    gint64 budget_ns;           // Last budget enforced
+    gint64 max_cpu_ns;          // Worst CPU time of a budgeted job (aborted jobs: at cancellation)
+} cpu_budget_task_t;
+
+/*
+ * Per-job CPU time budget, independent of the wall clock deadline: a job
+ * that burns more CPU than planned steals it from the lower priority tasks
+ * of its core even when it still finishes in time. The worker arms a timer
+ * on its own CPU clock before task_exec; on exhaustion the signal handler,
+ * running on the worker, only records it and demotes the job to SCHED_OTHER
+ * for the demote and abort actions. An abort is never issued from the
+ * handler: it is taken at the next budget checkpoint of the job, an explicit
+ * cpu_budget_checkpoint() in task_exec or the release of its last resource.
+ * A job that completes first (a CPU bound loop with no checkpoint) is
+ * recorded as a missed abort. A job holding a resource is demoted when it
+ * releases its last one, never inside a critical section.
+ */
+typedef struct {
+    cpu_budget_task_t tasks[CPU_BUDGET_MAX_TASKS];
+} cpu_budget_stats_t;
+
+
+/* CPU Budget Setup (signal handler, once per process) */
+gboolean cpu_budget_init(void);
+
+/* CPU Budget Enforcement (calling worker) */
+gboolean cpu_budget_arm(gint64 budget_ns, task_budget_action_t action);
+gboolean cpu_budget_disarm(cpu_budget_outcome_t *outcome);
+void cpu_budget_checkpoint(void);
+void cpu_budget_resources_released(void);
+
+/* CPU Budget Records */
+cpu_budget_stats_t* cpu_budget_stats_new(void);
+void cpu_budget_stats_free(cpu_budget_stats_t *stats);
+void cpu_budget_record(cpu_budget_stats_t *stats, guint16 task_id, gint64 budget_ns, const cpu_budget_outcome_t *outcome);
+void cpu_budget_record_abort(cpu_budget_stats_t *stats, guint16 task_id, gint64 budget_ns, const cpu_budget_outcome_t *outcome);
+void cpu_budget_stats_print(cpu_budget_stats_t *stats);
+
+#endif // CPU_BUDGET_H
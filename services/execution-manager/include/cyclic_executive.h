@@ -0,0 +1,76 @@
+#ifndef CYCLIC_EXECUTIVE_H
+#define CYCLIC_EXECUTIVE_H
+
+#include <glib.h>
+#include <pthread.h>
+
+#include "schedule.h"
+#include "execution_manager.h"
+
+/* --- Cyclic Executive Structures --- */
+
+/* Job of a frame, called in place by the core thread */
+typedef struct {
+    GThreadFunc task_exec;      // Task body
+    gpointer input_data;        // Task input (owned by the schedule, never freed here)
+    gint64 deadline_ns;         // Deadline offset in the hyperperiod
+    guint32 input_size;         // Size of a pooled input, 0 for opaque inputs
+    gboolean input_mutable;     // Each job works on the scratch copy of the input
+    guint16 task_id;
+    gint8 priority;             // Order of the job inside its frame (higher first)
+    guint64 completions;        // Written by the core thread only
+    guint64 misses;             // Completions after deadline_ns
+} ce_job_t;
+
+/* Frame: jobs released together on one core, up to the next frame boundary of the core */
+typedef struct {
+    gint64 start_ns;            // Offset of the frame in the hyperperiod
+    gint64 end_ns;              // Next frame boundary of the core (or the hyperperiod end)
+    guint first_job;            // Index of the first job in the core jobs array
+    guint n_jobs;
+    guint64 overruns;           // Executions that crossed end_ns
+    gint64 max_elapsed_ns;      // Worst frame execution time
+} ce_frame_t;
+
+typedef struct ce_table_t ce_table_t;
+
+typedef struct {
+    gint cpu;                   // Core the thread is pinned to
+    GArray *frames;             // ce_frame_t, sorted by start_ns
+    GArray *jobs;               // ce_job_t, in frame order
+    pthread_t thread;
+    ce_table_t *table;
+} ce_core_t;
+
+/* Per-core frame tables of one hyperperiod, compiled once from a static schedule */
+struct ce_table_t {
+    schedule_t *sched;          // Source schedule (not owned)
+    gint64 hyperperiod_ns;      // Length of one cycle
+    GPtrArray *cores;           // ce_core_t*
+    gint priority;              // SCHED_FIFO priority of the core threads, 0 = SCHED_OTHER
+    gint64 time_zero_ns;        // Start of the first cycle on the schedule clock
+    gint64 time_zero_us;        // Same instant on the monotonic clock (trace time base)
+    gint64 sync_zero_ns;        // Start of the first cycle on the master clock, -1 = not coordinated
+    guint cycles;               // Hyperperiods to run
+    execution_manager_t *em;    // Trace and metrics sink of the run
+    guint16 journal_id;         // Schedule index in the result journal
+};
+
+typedef struct {
+    guint64 frames_run;
+    guint64 frame_overruns;
+    guint64 jobs_completed;
+    guint64 deadline_misses;
+    gint64 worst_frame_us;      // Worst frame execution time over all cores
+} ce_report_t;
+
+
+/* Cyclic Executive Constructor/Destructor */
+ce_table_t* ce_table_compile(schedule_t *sched, gint priority);
+void ce_table_free(ce_table_t *table);
+
+/* Cyclic Executive Methods */
+void ce_table_print(ce_table_t *table);
+gboolean em_run_cyclic(execution_manager_t *em, ce_table_t *table, guint cycles, ce_report_t *report);
+
+#endif // CYCLIC_EXECUTIVE_H
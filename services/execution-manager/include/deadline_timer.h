@@ -0,0 +1,50 @@
+#ifndef DEADLINE_TIMER_H
+#define DEADLINE_TIMER_H
+
+#include <glib.h>
+#include <pthread.h>
+
+/* --- Deadline Timer Structures --- */
+
+/* One expiration, fired from the timing thread (func must be thread safe) */
+typedef struct {
+    gint64 target_us;           // Absolute monotonic deadline time
+    GSourceFunc func;           // Expiration handler, its return value is ignored
+    gpointer data;
+    GDestroyNotify destroy;     // Releases data with the timer, fired or not
+} deadline_timer_entry_t;
+
+/*
+ * Expirations are detected by a dedicated thread blocked on an absolute
+ * CLOCK_MONOTONIC timerfd, so a burst of releases on the dispatcher main
+ * loop cannot delay them (and the reverse).
+ */
+typedef struct {
+    GArray *entries;            // deadline_timer_entry_t, sorted by target_us at start (timing thread only while running)
+    GArray *pending;            // deadline_timer_entry_t inserted while running, merged by the timing thread
+    GMutex pending_lock;        // Protects pending and closed
+    gboolean closed;            // Timing thread past its last entry, insertions refused
+    gint timer_fd;              // timerfd armed on the next deadline
+    gint stop_fd;               // eventfd that ends the run before the last deadline
+    gint wake_fd;               // eventfd that makes the timing thread merge the pending entries
+    gint priority;              // SCHED_FIFO priority of the timing thread, 0 = SCHED_OTHER
+    gint cpu;                   // CPU the timing thread is pinned to, -1 = not pinned
+    pthread_t thread;
+    gboolean running;           // TRUE between start and join
+    gint64 max_lateness_us;     // Worst expiry detection delay of the run
+    guint64 fired;              // Expirations handled in the run
+} deadline_timer_t;
+
+
+/* Deadline Timer Constructor/Destructor */
+deadline_timer_t* deadline_timer_new(gint priority, gint cpu);
+void deadline_timer_free(deadline_timer_t *dt);
+
+/* Deadline Timer Methods */
+void deadline_timer_add(deadline_timer_t *dt, gint64 target_us, GSourceFunc func, gpointer data, GDestroyNotify destroy);
+gboolean deadline_timer_insert(deadline_timer_t *dt, gint64 target_us, GSourceFunc func, gpointer data, GDestroyNotify destroy);
+gboolean deadline_timer_start(deadline_timer_t *dt);
+void deadline_timer_stop(deadline_timer_t *dt);
+void deadline_timer_join(deadline_timer_t *dt);
+
+#endif // DEADLINE_TIMER_H
@@ -0,0 +1,26 @@
+#ifndef EM_NUMA_H
+#define EM_NUMA_H
+
+#include <glib.h>
+
+#define EM_NUMA_MAX_NODES 64
+#define EM_NUMA_MAX_CPUS 1024
+
+/*
+ * NUMA topology and memory placement without libnuma: the topology comes
+ * from sysfs, the placement from the mbind/get_mempolicy syscalls.
+ * On a single node host every call is a no-op that succeeds.
+ */
+
+/* Topology */
+gint em_numa_node_count(void);
+gint em_numa_node_of_cpu(gint cpu);
+gint em_numa_first_cpu_of_node(gint node);
+
+/* Placement */
+gboolean em_numa_bind(gpointer addr, gsize size, gint node);
+gint em_numa_node_of_addr(gconstpointer addr);
+gpointer em_numa_alloc(gsize size, gint node);
+void em_numa_free(gpointer addr, gsize size);
+
+#endif // EM_NUMA_H
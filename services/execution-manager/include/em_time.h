@@ -0,0 +1,59 @@
+#ifndef EM_TIME_H
+#define EM_TIME_H
+
+#include <glib.h>
+#include <time.h>
+
+/* --- Time Units --- */
+
+/*
+ * Timelines are in nanoseconds (gint64, about 292 years of range).
+ * Conversions from coarser units are checked, sums are saturated,
+ * so a bogus timestamp can never wrap into the past.
+ */
+#define EM_NSEC_PER_USEC G_GINT64_CONSTANT(1000)
+#define EM_NSEC_PER_MSEC G_GINT64_CONSTANT(1000000)
+#define EM_NSEC_PER_SEC  G_GINT64_CONSTANT(1000000000)
+
+#ifndef CLOCK_TAI
+#define CLOCK_TAI 11
+#endif
+
+/* FALSE if value * factor does not fit in a gint64 */
+static inline gboolean em_time_mul_checked(gint64 value, gint64 factor, gint64 *out) {
+    return !__builtin_mul_overflow(value, factor, out);
+}
+
+static inline gint64 em_time_add_sat(gint64 a, gint64 b) {
+    gint64 sum;
+    if (__builtin_add_overflow(a, b, &sum)) return (b > 0) ? G_MAXINT64 : G_MININT64;
+    return sum;
+}
+
+static inline gboolean em_time_ms_to_ns(gint64 ms, gint64 *ns) {
+    return em_time_mul_checked(ms, EM_NSEC_PER_MSEC, ns);
+}
+
+/* Truncation toward minus infinity, for the microsecond GLib and trace clocks */
+static inline gint64 em_time_ns_to_us(gint64 ns) {
+    return (ns >= 0) ? ns / EM_NSEC_PER_USEC : -((-ns + EM_NSEC_PER_USEC - 1) / EM_NSEC_PER_USEC);
+}
+
+static inline gint64 em_time_us_to_ns(gint64 us) {
+    gint64 ns;
+    if (!em_time_mul_checked(us, EM_NSEC_PER_USEC, &ns)) return (us > 0) ? G_MAXINT64 : G_MININT64;
+    return ns;
+}
+
+static inline gint64 em_time_now_ns(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (gint64)ts.tv_sec * EM_NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static inline struct timespec em_time_to_timespec(gint64 ns) {
+    struct timespec ts = { .tv_sec = ns / EM_NSEC_PER_SEC, .tv_nsec = ns % EM_NSEC_PER_SEC };
+    return ts;
+}
+
+#endif // EM_TIME_H
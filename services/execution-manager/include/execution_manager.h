@@ -7,43 +7,162 @@
 #include <errno.h>
 #include <pthread.h>
 #include <sched.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <glib-unix.h>
 
 
 #include "schedule.h"
 #include "execution_manager.h"
+#include "trace.h"
+#include "metrics.h"
+#include "deadline_timer.h"
+#include "release_guard.h"
+#include "result_exporter.h"
+#include "journal.h"
+#include "stack_pool.h"
+#include "control.h"
+#include "clock_sync.h"
+#include "aperiodic_server.h"
+#include "load_monitor.h"
+#include "cpu_budget.h"
 
 
 
 #define DEFAULT_EXECUTION_MANAGER_NAME "execution_manager"
+#define EM_CONTROL_LEAD_US 1000         // Live changes only touch releases at least this far ahead (above the release guards)
+#define EM_SYNC_DEFAULT_PERIOD_US 1000000   // Coordinated runs start on multiples of this period from the group epoch
+#define EM_SYNC_LEAD_US 2000            // Time left to plan a coordinated run before its start boundary
+#define EM_SERVER_SOURCE_PRIORITY (G_PRIORITY_DEFAULT + 101)   // Aperiodic servers are driven below every schedule
 
 
+/* Mixed Criticality */
+typedef enum {
+    EM_MODE_LO = 0,                 // Every task is released
+    EM_MODE_HI = 1                  // A HI task overran its optimistic budget
+} em_criticality_mode_t;
+
+typedef enum {
+    EM_LO_ACTION_DROP    = 0,       // LO releases are skipped in HI mode
+    EM_LO_ACTION_DEGRADE = 1        // LO releases run as SCHED_OTHER in HI mode
+} em_lo_action_t;
+
+/* Schedule hosted by the Execution Manager */
+typedef struct {
+    schedule_t *sched;              // Hosted schedule (not owned)
+    gint importance;                // Higher importance is dispatched first and never throttled by lower ones
+    gint *cores;                    // Physical CPUs, task cpu_affinity indexes this set (NULL = identity)
+    guint n_cores;
+    gint64 budget_us;               // CPU time allowed per window, 0 = unlimited
+    gint64 window_us;               // Budget replenishment window
+    gint64 window_start_us;         // Start of the current window (dispatcher only)
+    gint64 consumed_us;             // CPU time consumed in the current window (atomic)
+    guint64 throttled;              // Releases dropped because the budget was exhausted
+    gint finished;                  // Completed or past its last deadline in the current run (atomic)
+    guint16 journal_id;             // Schedule index in the result journal
+} em_schedule_slot_t;
+
+/* Run in progress, reachable by the control and release handlers */
+typedef struct {
+    GMainLoop *loop;
+    GPtrArray *sources;             // Planned sources, the live additions are appended
+    GPtrArray *slots;               // Slots of the run (em_schedule_slot_t*)
+    deadline_timer_t *deadlines;    // Running timing thread, NULL when the expirations are on the main loop
+    gint64 time_zero_us;            // Monotonic time zero shared by the slots
+    guint live_changes;             // Admitted changes, folded in the schedules after the run
+} em_run_t;
+
 /* Execution Manager Stucture */
 typedef struct execution_manager_t{
     GString *em_name;               // Execution Manager Name
+    trace_buffer_t *trace;          // Tracepoint buffer, NULL if tracing is disabled
+    metrics_t *metrics;             // Lock-free counters exported on the metrics socket
+    GString *trace_dir;             // Directory for the per-run trace files
+    guint run_count;                // Number of schedule runs
+    GPtrArray *schedules;           // Hosted schedules (em_schedule_slot_t*)
+    gint active_schedules;          // Schedules whose last deadline has not fired yet
+    gint mode;                      // Criticality mode, em_criticality_mode_t (atomic)
+    em_lo_action_t lo_action;       // What happens to LO releases in HI mode
+    gint running_jobs;              // Released jobs not finished yet (atomic)
+    gint live_workers;              // Job threads still using the manager, em_free waits for them (atomic)
+    gint mode_switches;             // LO -> HI switches (atomic)
+    gint lo_dropped;                // LO releases dropped in HI mode (atomic)
+    gint deadline_priority;         // SCHED_FIFO priority of the deadline timer thread
+    gint deadline_cpu;              // CPU of the deadline timer thread, -1 = not pinned
+    gboolean end_on_completion;     // End a schedule as soon as all its runs completed
+    release_guard_t *release_guard; // Sleep-then-spin releases, NULL if disabled
+    result_exporter_t *exporter;    // Asynchronous result export, NULL if disabled
+    journal_t *journal;             // Memory mapped event journal, NULL if disabled
+    stack_pool_t *stacks;           // Job stacks on the NUMA node of their CPU
+    control_t *control;             // Runtime admission socket, NULL if disabled
+    em_run_t *run;                  // Run in progress (dispatcher only), NULL between runs
+    clock_sync_t *sync;             // Common epoch with the other instances, NULL if not coordinated
+    gint64 sync_period_us;          // Start boundary period of the coordinated runs
+    GPtrArray *servers;             // Aperiodic servers (aperiodic_server_t*), at most one per core
+    load_monitor_t *load;           // Per-core utilization and overload monitor, NULL if disabled
+    cpu_budget_stats_t *budgets;    // CPU time budget overruns per task, over all the runs
 } execution_manager_t;
 
+/* Budget monitor shared by a HI criticality job and its LO budget timer */
+typedef struct {
+    gint refcount;                  // Worker + timer (atomic)
+    gint finished;                  // Set by the worker (atomic)
+    guint16 task_id;
+    gint cpu;
+    execution_manager_t *em;
+} em_job_monitor_t;
+
 
 
 typedef struct {
-    gpointer data;      // GList of activation_data_t
-    gint64 timestamp;   
+    timeline_entry_t *entry;    // Activation records released together
+    gint64 timestamp_ns;    // Offset of the release from the time zero
+    gint64 target_us;   // Absolute monotonic release time
+    gint64 ready_us;    // Wake up of the dispatcher, target_us minus the release guard
     schedule_t *sched;
+    em_schedule_slot_t *slot;
+    execution_manager_t *em;
 } start_context_t;
 
 typedef struct {
-    gpointer data;       // GSList of expiration_data_t 
+    timeline_entry_t *entry;    // Expiration records checked together
     GMainLoop *loop;     // Reference to end the process 
     gboolean is_last;    // Flag that indicat if is the last event 
-    gint64 timestamp;    
+    gint64 timestamp_ns; // Offset of the deadline from the time zero
+    gint64 target_us;    // Absolute monotonic deadline time
     schedule_t *sched;
+    em_schedule_slot_t *slot;
+    execution_manager_t *em;
 } deadline_context_t;
 
+typedef struct {
+    GMainLoop *loop;            // Reference to end the process
+    gint64 last_deadline_us;    // Absolute monotonic time of the last deadline
+    schedule_t *sched;
+    em_schedule_slot_t *slot;
+    execution_manager_t *em;
+} completion_context_t;
+
 
 typedef struct {
     guint16 task_id;    // Task ID 
-    gpointer data;      // Task input
+    gpointer data;      // Task input, shared with the other jobs of the task
+    guint32 input_size;     // Size of a pooled input, 0 for opaque inputs
+    gboolean input_mutable; // The job works on a private copy of its input
+    gpointer job_input;     // Input passed to task_exec, freed by input_pool_job_done
     GThreadFunc thread_func; 
+    gint cpu;           // CPU the thread is pinned to
+    gint64 release_us;  // Absolute monotonic release time
+    gint64 release_ns;  // Timeline offset of the release, pairs the job with its expiration
+    gint64 ready_us;    // Dispatcher wake up of a precise release, 0 = start at once
     schedule_t *sched;  // Reference to the schedule for store the result
+    em_schedule_slot_t *slot;   // Slot charged with the CPU time of the job
+    em_job_monitor_t *monitor;  // LO budget monitor, NULL for unmonitored jobs
+    gint64 budget_hi_us;        // Pessimistic budget, only reported
+    gint64 cpu_budget_us;       // CPU time budget enforced on the worker, 0 = none
+    gint64 cpu_start_ns;        // Thread CPU time right before task_exec, the job is charged from there
+    task_budget_action_t budget_action;
+    execution_manager_t *em;
 } task_wrapper_input_t; 
 
 
@@ -53,15 +172,41 @@ typedef struct {
 execution_manager_t* em_new(const gchar *name);
 void em_free(execution_manager_t *em);
 
+/* Execution Manager Configuration */
+void em_enable_trace(execution_manager_t *em, const gchar *trace_dir, guint capacity, gboolean use_trace_marker);
+gboolean em_enable_metrics(execution_manager_t *em, const gchar *socket_path);
+void em_set_lo_criticality_action(execution_manager_t *em, em_lo_action_t action);
+void em_set_deadline_timer(execution_manager_t *em, gint priority, gint cpu);
+void em_set_end_on_completion(execution_manager_t *em, gboolean enabled);
+void em_enable_precise_release(execution_manager_t *em, gint64 initial_guard_us);
+void em_set_release_guard(execution_manager_t *em, gint cpu, gint64 guard_us);
+gboolean em_enable_result_export(execution_manager_t *em, const gchar *host, gint port, const gchar *stream);
+gboolean em_enable_journal(execution_manager_t *em, const gchar *path, guint64 capacity);
+void em_register_control_task(execution_manager_t *em, const gchar *name, GThreadFunc task_exec);
+gboolean em_enable_control(execution_manager_t *em, const gchar *socket_path);
+void em_enable_load_monitor(execution_manager_t *em, gdouble threshold, guint tick_ms);
+gboolean em_add_aperiodic_server(execution_manager_t *em, gint cpu, gint priority, gint64 budget_us, gint64 period_us);
+gboolean em_enable_clock_sync(execution_manager_t *em, const gchar *master_host, gint port, guint interval_ms, gint64 period_us);
+
 
 /* Exection Manager Activities*/
 void em_run_schedule(execution_manager_t *em, schedule_t *sched);
+em_schedule_slot_t* em_add_schedule(execution_manager_t *em, schedule_t *sched, gint importance, const gint *cores, guint n_cores, gint64 budget_us, gint64 window_us);
+void em_remove_schedule(execution_manager_t *em, schedule_t *sched);
+void em_run_schedules(execution_manager_t *em);
+guint32 em_submit_aperiodic(execution_manager_t *em, gint cpu, guint16 task_id, GThreadFunc func, gpointer input, GDestroyNotify input_free);
 
 /* Exectuion Manager Usefull Functions  */
 void* task_wrapper_func(void* data);
+void em_export_trace(execution_manager_t *em, schedule_t *sched, const gchar *tag);
+gint64 em_sync_time_zero_ns(execution_manager_t *em, gint64 lead_us);
 
 /* Execution Manager Event Handlers */
 gboolean handle_initialization(gpointer user_data);
 gboolean handle_expiration(gpointer user_data);
+gboolean handle_budget_lo(gpointer user_data);
+gboolean handle_completion(gint fd, GIOCondition condition, gpointer user_data);
+gboolean handle_control(gint fd, GIOCondition condition, gpointer user_data);
+gboolean handle_aperiodic(gint fd, GIOCondition condition, gpointer user_data);
 
 #endif // EXECUTION_MANAGER_H
\ No newline at end of file
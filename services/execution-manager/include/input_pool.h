@@ -0,0 +1,74 @@
+#ifndef INPUT_POOL_H
+#define INPUT_POOL_H
+
+#include <glib.h>
+#include <string.h>
+
+#define INPUT_POOL_ALIGN 64
+#define INPUT_POOL_ALIGN_UP(size) (((size) + INPUT_POOL_ALIGN - 1) & ~(gsize)(INPUT_POOL_ALIGN - 1))
+
+/* --- Input Pool Structures --- */
+
+/*
+ * Task inputs owned by the schedule. Inputs are immutable and shared by
+ * every job of a task. A task that mutates its input works on a copy: the
+ * executors that run the jobs of a core one at a time (cyclic executive,
+ * simulator) reuse a scratch area stored right after the shared input and
+ * refreshed before each job; the dispatcher, whose jobs of a task can
+ * overlap, gives every job a private copy (input_pool_job_copy).
+ * Before the first run the inputs are moved next to the worker cores:
+ * copied into an arena bound to the NUMA node of the core, by a thread
+ * pinned on it, so re-running a schedule allocates nothing.
+ */
+typedef struct {
+    GHashTable *adopted;        // Opaque inputs handed over by schedule_add_task, freed once
+    GPtrArray *staged;          // Copies made by input_pool_stage (aligned)
+    GArray *arenas;             // input_arena_t, per core mappings of the placed inputs
+    gboolean placed;            // Immutable from the first placement on
+} input_pool_t;
+
+typedef struct {
+    gpointer base;
+    gsize size;
+    gint cpu;
+} input_arena_t;
+
+/* One activation input to place on the core of its worker */
+typedef struct {
+    gpointer *input;            // Activation input pointer, redirected to the placed copy
+    gsize size;
+    gboolean mutable_input;     // Copy followed by its scratch area
+    gint cpu;                   // Physical CPU of the worker, -1 = not pinned
+} input_pool_request_t;
+
+
+/* Input Pool Constructor/Destructor */
+input_pool_t* input_pool_new(void);
+void input_pool_free(input_pool_t *pool);
+
+/* Input Pool Methods */
+gpointer input_pool_adopt(input_pool_t *pool, gpointer input);
+gpointer input_pool_stage(input_pool_t *pool, gconstpointer data, gsize size, gboolean mutable_input);
+gboolean input_pool_place(input_pool_t *pool, input_pool_request_t *requests, guint n_requests);
+
+/* Input of a job run alone on its core: the shared copy, or the scratch area reset from it for the tasks that mutate it */
+static inline gpointer input_pool_job_input(gpointer input, gsize size, gboolean mutable_input) {
+    if (!mutable_input || !input) return input;
+    guint8 *scratch = (guint8 *)input + INPUT_POOL_ALIGN_UP(size);
+    memcpy(scratch, input, size);
+    return scratch;
+}
+
+/* Input of a job that may overlap the other jobs of its task: the shared copy, or a private copy released by input_pool_job_done */
+static inline gpointer input_pool_job_copy(gconstpointer input, gsize size, gboolean mutable_input) {
+    if (!mutable_input || !input || size == 0) return (gpointer)input;
+    gpointer copy = g_aligned_alloc(1, INPUT_POOL_ALIGN_UP(size), INPUT_POOL_ALIGN);    // First touched on the core of the job
+    memcpy(copy, input, size);
+    return copy;
+}
+
+static inline void input_pool_job_done(gconstpointer input, gpointer job_input) {
+    if (job_input != input) g_aligned_free(job_input);
+}
+
+#endif // INPUT_POOL_H
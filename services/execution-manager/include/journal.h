@@ -0,0 +1,84 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <glib.h>
+
+#define JOURNAL_MAGIC "EMJRNL01"
+#define JOURNAL_VERSION 1
+#define JOURNAL_DEFAULT_RECORDS 65536
+#define JOURNAL_MAX_SCHEDULES 32
+#define JOURNAL_NAME_LEN 64
+#define JOURNAL_OUTPUT_LEN 91
+#define JOURNAL_UNKNOWN_SCHEDULE G_MAXUINT16
+
+/* --- Journal Event Types --- */
+
+typedef enum {
+    JOURNAL_EVENT_RUN_START = 0,    // Schedule run planned (arg = wall clock time zero in us)
+    JOURNAL_EVENT_COMPLETE  = 1,    // Task run completed (arg = execution time in us, output copied)
+    JOURNAL_EVENT_MISS      = 2,    // Task completed after its deadline (arg = lateness in us)
+    JOURNAL_EVENT_ABORT     = 3,    // Task not completed at its deadline
+    JOURNAL_EVENT_RUN_END   = 4     // Schedule run over (arg = 1 if every run completed)
+} journal_event_type_t;
+
+#define JOURNAL_FLAG_TRUNCATED 0x01     // Output longer than JOURNAL_OUTPUT_LEN
+
+/* --- Journal Structures --- */
+
+/* Fixed size record, two cache lines; seq is written last and marks the record valid */
+typedef struct {
+    guint64 seq;                // Sequence number + 1, 0 while the record is being written
+    gint64 timestamp_ns;        // CLOCK_MONOTONIC time of the event
+    gint64 arg;                 // Event specific argument
+    guint32 remaining_runs;     // Runs left to the task after the event
+    guint16 task_id;
+    gint16 cpu;
+    guint16 schedule_id;        // Index in the header schedule table
+    guint8 type;                // journal_event_type_t
+    guint8 flags;
+    guint8 output_len;
+    gchar output[JOURNAL_OUTPUT_LEN];
+} journal_record_t;
+
+G_STATIC_ASSERT(sizeof(journal_record_t) == 128);
+
+/* First page of the file, followed by capacity records */
+typedef struct {
+    gchar magic[8];
+    guint32 version;
+    guint32 record_size;
+    guint64 capacity;
+    guint64 head;               // Next sequence number (atomic)
+    gint64 created_us;          // Wall clock creation time
+    guint32 n_schedules;
+    guint32 reserved;
+    gchar schedules[JOURNAL_MAX_SCHEDULES][JOURNAL_NAME_LEN];  // "name@version", indexed by schedule_id
+} journal_header_t;
+
+G_STATIC_ASSERT(sizeof(journal_header_t) <= 4096);
+
+typedef struct {
+    gchar *path;
+    gint fd;
+    gsize map_size;
+    journal_header_t *header;   // Shared mapping of the file
+    journal_record_t *records;
+    gboolean read_only;
+} journal_t;
+
+typedef void (*journal_func_t)(const journal_record_t *rec, gpointer user_data);
+
+
+/* Journal Constructor/Destructor */
+journal_t* journal_open(const gchar *path, guint64 capacity);
+journal_t* journal_open_readonly(const gchar *path);
+void journal_close(journal_t *j);
+
+/* Journal Methods */
+guint16 journal_register_schedule(journal_t *j, const gchar *name, const gchar *version);
+const gchar *journal_schedule_name(journal_t *j, guint16 schedule_id);
+void journal_append(journal_t *j, journal_event_type_t type, guint16 schedule_id, guint16 task_id, gint cpu, guint32 remaining_runs, gint64 arg, const gchar *output);
+guint64 journal_foreach(journal_t *j, journal_func_t func, gpointer user_data);
+void journal_sync(journal_t *j);
+
+#endif // JOURNAL_H
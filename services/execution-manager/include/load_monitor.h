@@ -0,0 +1,108 @@
+#ifndef LOAD_MONITOR_H
+#define LOAD_MONITOR_H
+
+#include <glib.h>
+
+#include "metrics.h"
+#include "trace.h"
+
+#define LOAD_MONITOR_MAX_CPUS 64
+#define LOAD_MONITOR_MAX_TASKS 1024         // Task ids above are only counted in their core
+#define LOAD_MONITOR_WINDOW 100             // Ticks in the sliding window
+#define LOAD_MONITOR_DEFAULT_TICK_MS 10
+#define LOAD_MONITOR_DEFAULT_THRESHOLD 0.9
+#define LOAD_MONITOR_HYSTERESIS 0.05        // An overload ends below threshold - hysteresis
+
+/* --- Load Monitor Structures --- */
+
+/* Written by the workers with relaxed atomics, read by the monitor thread */
+typedef struct {
+    guint64 busy_ns;            // Thread CPU time of the finished jobs
+    guint64 jobs;
+} __attribute__((aligned(64))) load_counter_t;
+
+typedef struct {
+    guint64 busy_ns;
+    guint64 jobs;
+    guint64 max_ns;             // Worst job CPU time since the last tick (CAS max)
+} load_task_counter_t;
+
+/* Sliding window of one core (monitor thread only, results atomic) */
+typedef struct {
+    guint64 last_busy_ns;       // Counter value at the previous tick
+    gint64 ring[LOAD_MONITOR_WINDOW];
+    gint64 window_busy_ns;      // Sum of the ring
+    gint utilization;           // Measured over the window, per mille (atomic)
+    gint projected;             // Planned releases x worst observed CPU time, per mille (atomic)
+    gboolean overloaded;
+    guint64 overloads;          // Overload events raised (atomic)
+} load_core_t;
+
+/* Sliding window of one task (monitor thread only) */
+typedef struct {
+    guint16 task_id;
+    guint64 last_busy_ns;       // Counter values at the previous tick
+    guint64 last_jobs;
+    gint64 ring_busy[LOAD_MONITOR_WINDOW];
+    guint64 ring_jobs[LOAD_MONITOR_WINDOW];
+    gint64 ring_max[LOAD_MONITOR_WINDOW];
+    gint64 window_busy_ns;
+    guint64 window_jobs;
+    gint64 worst_ns;            // Worst job CPU time in the window
+    gint utilization;           // Per mille (atomic)
+} load_task_t;
+
+/* Planned demand of a task on a core for the current run */
+typedef struct {
+    guint16 task_id;
+    gint cpu;
+    gdouble releases_per_s;
+    gint64 declared_ns;         // Budget of the task, used until a job is observed
+} load_plan_t;
+
+/*
+ * Overload monitor: workers add their thread CPU time to lock-free
+ * counters when a job ends; a nice 19 thread folds the counters into a
+ * sliding window per core and per task every tick and projects the
+ * demand of each core from the plan of the run (releases per second times
+ * the worst CPU time observed in the window). A core above the threshold,
+ * measured or projected, raises one overload event until it falls back
+ * under threshold - hysteresis.
+ */
+typedef struct {
+    load_counter_t cores_in[LOAD_MONITOR_MAX_CPUS];
+    load_task_counter_t tasks_in[LOAD_MONITOR_MAX_TASKS];
+
+    load_core_t cores[LOAD_MONITOR_MAX_CPUS];
+    GHashTable *tasks;          // Map: task id -> load_task_t*, filled by the monitor thread
+    guint head;                 // Current ring slot
+
+    GMutex lock;                // Protects plan and the insertions in tasks, taken once per tick by the monitor
+    GArray *plan;               // load_plan_t
+
+    gdouble threshold;          // Overload threshold, fraction of a core
+    guint tick_ms;
+    metrics_t *metrics;         // Optional sinks, set by the dispatcher before a run (atomic)
+    trace_buffer_t *trace;
+    gint stop;                  // Atomic flag for the monitor thread
+    GThread *thread;
+} load_monitor_t;
+
+
+/* Load Monitor Constructor/Destructor */
+load_monitor_t* load_monitor_new(gdouble threshold, guint tick_ms);
+void load_monitor_free(load_monitor_t *lm);
+
+/* Load Monitor Plan (dispatcher, before time zero) */
+void load_monitor_plan_reset(load_monitor_t *lm, metrics_t *metrics, trace_buffer_t *trace);
+void load_monitor_plan_task(load_monitor_t *lm, guint16 task_id, gint cpu, gdouble releases_per_s, gint64 declared_ns);
+
+/* Load Monitor Updates (lock-free, safe from RT threads) */
+void load_monitor_add_job(load_monitor_t *lm, guint16 task_id, gint cpu, gint64 cpu_ns);
+
+/* Load Monitor Reports */
+gdouble load_monitor_core_utilization(load_monitor_t *lm, gint cpu);
+gdouble load_monitor_core_projected(load_monitor_t *lm, gint cpu);
+void load_monitor_print(load_monitor_t *lm);
+
+#endif // LOAD_MONITOR_H
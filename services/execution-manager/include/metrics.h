@@ -0,0 +1,75 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <glib.h>
+
+#define METRICS_MAX_CPUS 64
+#define METRICS_LATENCY_BUCKETS 32      // log2 buckets of microseconds
+#define METRICS_INFO_LEN 128
+#define METRICS_MAX_SCHEDULES 32        // Schedules of one run exported in em_schedule_info
+
+/* --- Metrics Structures --- */
+
+/* One cache line aligned block per core, updated with relaxed atomics only */
+typedef struct {
+    guint64 activations;
+    guint64 completions;
+    guint64 deadline_misses;
+    guint64 aborts;
+    guint64 busy_us;                                    // Wall time spent in task_exec
+    guint64 release_latency[METRICS_LATENCY_BUCKETS];   // Release -> task start histogram
+    guint64 server_jobs;                                // Aperiodic jobs served
+    guint64 server_budget_us;                           // Aperiodic server budget consumed
+    guint64 server_exhaustions;                         // Aperiodic server budget exhausted by a job
+    guint64 load_permille;                              // Load monitor: measured utilization (gauge)
+    guint64 projected_permille;                         // Load monitor: projected demand (gauge)
+    guint64 overloads;                                  // Load monitor: overload events
+    guint64 budget_overruns;                            // Jobs over their CPU time budget
+} __attribute__((aligned(64))) core_counters_t;
+
+typedef struct {
+    core_counters_t cores[METRICS_MAX_CPUS];
+    guint64 schedule_runs;
+    guint64 notify_latency[METRICS_LATENCY_BUCKETS];    // Completion -> dispatcher notification histogram
+    guint64 server_response[METRICS_LATENCY_BUCKETS];   // Aperiodic submission -> completion histogram
+
+    GMutex info_lock;                       // Protects only the schedule info strings
+    gchar schedule_name[METRICS_MAX_SCHEDULES][METRICS_INFO_LEN];       // Schedules of the current run
+    gchar schedule_version[METRICS_MAX_SCHEDULES][METRICS_INFO_LEN];
+    guint n_schedules;
+
+    gchar *socket_path;                     // Unix socket of the endpoint
+    gint listen_fd;
+    gint stop;                              // Atomic flag for the server thread
+    GThread *server_thread;
+} metrics_t;
+
+
+/* Metrics Constructor/Destructor */
+metrics_t* metrics_new(void);
+void metrics_free(metrics_t *m);
+
+/* Metrics Endpoint */
+gboolean metrics_start_server(metrics_t *m, const gchar *socket_path);
+void metrics_stop_server(metrics_t *m);
+
+/* Metrics Updates (lock-free, safe from RT threads) */
+void metrics_inc_activation(metrics_t *m, gint cpu);
+void metrics_inc_completion(metrics_t *m, gint cpu, gint64 busy_us);
+void metrics_inc_deadline_miss(metrics_t *m, gint cpu);
+void metrics_inc_abort(metrics_t *m, gint cpu);
+void metrics_observe_release_latency(metrics_t *m, gint cpu, gint64 latency_us);
+void metrics_observe_notify_latency(metrics_t *m, gint64 latency_us);
+void metrics_observe_server_response(metrics_t *m, gint cpu, gint64 response_us);
+void metrics_add_server_budget(metrics_t *m, gint cpu, gint64 consumed_us);
+void metrics_inc_server_exhaustion(metrics_t *m, gint cpu);
+void metrics_set_core_load(metrics_t *m, gint cpu, gint load_permille, gint projected_permille);
+void metrics_inc_overload(metrics_t *m, gint cpu);
+void metrics_inc_budget_overrun(metrics_t *m, gint cpu);
+void metrics_clear_schedule_info(metrics_t *m);
+void metrics_add_schedule_info(metrics_t *m, const gchar *name, const gchar *version);
+
+/* Metrics Rendering */
+GString* metrics_render(metrics_t *m);
+
+#endif // METRICS_H
@@ -0,0 +1,46 @@
+#ifndef RELEASE_GUARD_H
+#define RELEASE_GUARD_H
+
+#include <glib.h>
+
+#define RELEASE_GUARD_MAX_CPUS 64
+#define RELEASE_GUARD_MIN_US 5              // Spin kept even with a perfect wake up
+#define RELEASE_GUARD_MAX_US 5000           // Upper bound of the self-calibrated guard
+
+/* --- Release Guard Structures --- */
+
+/*
+ * Precise release: the dispatcher wakes up guard_us before the release,
+ * the pinned worker then spins on CLOCK_MONOTONIC up to the release time.
+ * The guard follows the observed wake up -> worker start latency of the
+ * core (smoothed mean + 4 deviations, as the TCP retransmission timer).
+ */
+typedef struct {
+    gint64 guard_us;            // Current guard (atomic)
+    gint64 fixed_us;            // Configured guard, 0 = self-calibrated
+    gint64 srtt8;               // Smoothed wake up latency, scaled by 8
+    gint64 rttvar4;             // Smoothed deviation, scaled by 4
+    guint64 samples;
+    guint64 late;               // Workers that started after the release time
+} __attribute__((aligned(64))) release_guard_core_t;
+
+typedef struct {
+    release_guard_core_t cores[RELEASE_GUARD_MAX_CPUS];
+    gint64 initial_us;          // Guard of the cores without samples
+} release_guard_t;
+
+
+/* Release Guard Constructor/Destructor */
+release_guard_t* release_guard_new(gint64 initial_us);
+void release_guard_free(release_guard_t *rg);
+
+/* Release Guard Setters/Getters */
+void release_guard_set(release_guard_t *rg, gint cpu, gint64 guard_us);
+gint64 release_guard_get(release_guard_t *rg, gint cpu);
+
+/* Release Guard Methods (safe from RT threads) */
+void release_guard_observe(release_guard_t *rg, gint cpu, gint64 wakeup_us, gboolean late);
+gint64 release_guard_spin_until(gint64 target_us);
+void release_guard_print(release_guard_t *rg);
+
+#endif // RELEASE_GUARD_H
@@ -0,0 +1,66 @@
+#ifndef RESOURCE_H
+#define RESOURCE_H
+
+#include <glib.h>
+#include <pthread.h>
+
+#define RESOURCE_NO_TASK G_MAXUINT16
+
+/* --- Resource Structures --- */
+
+/* A task declaring the resource, with its longest critical section on it */
+typedef struct {
+    guint16 task_id;
+    gint64 cs_us;               // Declared critical section, used by the blocking analysis
+    gint64 max_hold_ns;         // Longest measured hold of the task (atomic)
+} resource_use_t;
+
+/*
+ * State shared between tasks, locked with the immediate priority ceiling
+ * protocol (PTHREAD_PRIO_PROTECT): the holder runs at the highest priority
+ * of the declared users, so a job blocks at most once, before it starts
+ * using the resource. Resources without RT users fall back to priority
+ * inheritance. Hold times are measured per user.
+ */
+typedef struct {
+    gchar *name;
+    guint16 id;
+    gint ceiling;               // Highest SCHED_FIFO/RR priority of the users, 0 = none
+    pthread_mutex_t mutex;
+    gboolean initialized;
+    gint protocol;              // PTHREAD_PRIO_PROTECT or PTHREAD_PRIO_INHERIT
+    GArray *users;              // resource_use_t, fixed once the schedule runs
+
+    /* Holder state, written under the mutex */
+    gint64 lock_ns;
+    guint16 holder_task;
+
+    /* Instrumentation (atomic) */
+    guint64 acquisitions;
+    gint64 total_hold_ns;
+    gint64 max_hold_ns;
+    guint64 overruns;           // Holds longer than the declared critical section
+    guint64 undeclared;         // Locks by tasks that did not declare the resource
+    guint64 lock_errors;        // Refused locks (caller above the ceiling)
+} resource_t;
+
+
+/* Resource Constructor/Destructor */
+resource_t* resource_new(const gchar *name, guint16 id);
+void resource_free(resource_t *res);
+
+/* Resource Methods */
+void resource_add_user(resource_t *res, guint16 task_id, gint64 cs_us);
+resource_use_t* resource_get_user(resource_t *res, guint16 task_id);
+gboolean resource_set_ceiling(resource_t *res, gint ceiling);
+
+/* Called by task_exec */
+gboolean resource_lock(resource_t *res);
+void resource_unlock(resource_t *res);
+
+/* Task of the calling job, set by the dispatcher before task_exec */
+void resource_set_current_task(guint16 task_id);
+guint16 resource_current_task(void);
+guint resource_held_count(void);
+
+#endif // RESOURCE_H
@@ -0,0 +1,64 @@
+#ifndef RESULT_EXPORTER_H
+#define RESULT_EXPORTER_H
+
+#include <glib.h>
+
+#define RESULT_EXPORTER_CAPACITY 4096           // Records buffered while the store is slow or down (power of 2)
+#define RESULT_EXPORTER_BATCH 64                // Records pipelined per round trip
+#define RESULT_EXPORTER_FLUSH_MS 2              // Longest wait of a partial batch
+#define RESULT_EXPORTER_STREAM_MAXLEN 100000    // Approximate cap of the store side stream
+#define RESULT_EXPORTER_NAME_LEN 48
+#define RESULT_EXPORTER_OUTPUT_LEN 192
+
+/* --- Result Exporter Structures --- */
+
+/* Fixed size ring cell, the output is copied inline so a push never allocates */
+typedef struct {
+    guint64 sequence;                               // Cell state of the bounded queue (atomic)
+    gint64 timestamp_us;                            // Wall clock time of the completion
+    guint16 task_id;
+    guint16 output_len;
+    gchar schedule[RESULT_EXPORTER_NAME_LEN];
+    gchar output[RESULT_EXPORTER_OUTPUT_LEN];
+} __attribute__((aligned(64))) result_record_t;
+
+/*
+ * Completed results are pushed by the RT workers into a bounded lock-free
+ * queue (multi-producer, single consumer) and drained by one exporter
+ * thread, which pipelines them as XADD commands to a Redis protocol
+ * endpoint. A full queue drops the new record: the workers never wait.
+ */
+typedef struct {
+    result_record_t *ring;      // Preallocated cells
+    guint64 mask;               // Capacity - 1
+    guint64 head;               // Next cell claimed by a producer (atomic)
+    guint64 tail;               // Next cell read by the exporter thread
+    result_record_t *batch;     // Exporter thread copy of the records in flight
+
+    gchar *host;
+    gint port;
+    gchar *stream;              // Stream key the results are appended to
+    gpointer conn;              // redisContext*, NULL while disconnected
+    gint64 retry_at_us;         // Next connection attempt
+    gint64 retry_delay_us;      // Doubled on every failed attempt
+
+    gint wake_fd;               // eventfd written once per full batch
+    gint stop;                  // Atomic flag for the exporter thread
+    GThread *thread;
+
+    guint64 exported;           // Records acknowledged by the store
+    guint64 dropped;            // Records lost to a full queue (atomic)
+    guint64 oversized;          // Outputs longer than RESULT_EXPORTER_OUTPUT_LEN (atomic)
+    guint64 failed;             // Records rejected or lost with a broken connection
+} result_exporter_t;
+
+
+/* Result Exporter Constructor/Destructor */
+result_exporter_t* result_exporter_new(const gchar *host, gint port, const gchar *stream);
+void result_exporter_free(result_exporter_t *re);
+
+/* Result Exporter Methods */
+gboolean result_exporter_push(result_exporter_t *re, const gchar *schedule, guint16 task_id, const gchar *output);
+void result_exporter_print(result_exporter_t *re);
+
+#endif // RESULT_EXPORTER_H
@@ -0,0 +1,50 @@
+#ifndef RT_AUDIT_H
+#define RT_AUDIT_H
+
+#include <glib.h>
+#include "schedule.h"
+
+/* --- RT Audit Structures --- */
+
+typedef enum {
+    RT_AUDIT_OK      = 0,       // Already suitable
+    RT_AUDIT_TUNED   = 1,       // Fixed for this process by the audit
+    RT_AUDIT_WARN    = 2,       // Costs release latency, left as found (system wide or no permission)
+    RT_AUDIT_FAIL    = 3,       // Breaks the schedule (e.g. no RT policy allowed)
+    RT_AUDIT_UNKNOWN = 4        // Not readable here (container), left out of the score
+} rt_audit_status_t;
+
+typedef struct {
+    const gchar *name;
+    rt_audit_status_t status;
+    gint weight;                // Points of the check in the score
+    gchar *detail;
+} rt_audit_check_t;
+
+/*
+ * Startup audit of the host settings that bound release latency, for the
+ * CPUs used by the schedule. Process wide settings are applied when allowed
+ * (cpu_dma_latency held open, timer slack, THP opt-out); system wide ones
+ * are only reported. Everything works unprivileged, missing files and
+ * permissions degrade to WARN/UNKNOWN.
+ */
+typedef struct {
+    GArray *checks;             // rt_audit_check_t
+    GArray *cpus;               // CPUs of the audited schedules (gint, sorted, unique)
+    gint dma_latency_fd;        // Keeps the C-state request active, -1 if not held
+    gint score;                 // 0-100, weighted share of OK/TUNED checks
+    gboolean done;
+} rt_audit_t;
+
+
+/* RT Audit Constructor/Destructor */
+rt_audit_t* rt_audit_new(void);
+void rt_audit_free(rt_audit_t *audit);
+
+/* RT Audit Methods */
+void rt_audit_add_cpu(rt_audit_t *audit, gint cpu);
+void rt_audit_add_schedule(rt_audit_t *audit, schedule_t *sched, const gint *cores, guint n_cores);
+gint rt_audit_run(rt_audit_t *audit, gboolean apply);
+void rt_audit_print(rt_audit_t *audit);
+
+#endif // RT_AUDIT_H
@@ -5,35 +5,93 @@
 #include <sched.h>
 #include <pthread.h>        // Mutex manager
 
+#include "em_time.h"
+#include "input_pool.h"
+#include "em_numa.h"
+#include "resource.h"
+
 /* --- Utils Structures --- */
 
+typedef enum {
+    TASK_CRIT_LO = 0,           // Dropped or degraded while the system is in HI mode
+    TASK_CRIT_HI = 1            // Safety relevant, its overruns switch the system to HI mode
+} task_criticality_t;
+
+/* Action on a job that exhausts its CPU time budget */
+typedef enum {
+    TASK_BUDGET_NOTIFY = 0,     // Overrun recorded and reported, the job goes on
+    TASK_BUDGET_DEMOTE = 1,     // The job finishes as SCHED_OTHER
+    TASK_BUDGET_ABORT  = 2      // The job is demoted, then cancelled at its next budget checkpoint
+} task_budget_action_t;
+
+typedef enum {
+    TASK_INPUT_SHARED  = 0,     // task_exec only reads its input
+    TASK_INPUT_MUTABLE = 1      // task_exec writes its input, every job gets a fresh copy
+} task_input_flags_t;
+
+/* Compact activation record, stored by value in its timeline entry (61 bytes of fields, padded to one 64 byte cache line) */
 typedef struct {
-    guint16 task_id;            // Call Task ID
-    GString *task_name;         // Task Name
     GThreadFunc task_exec;      // Pointer to Function that contain the task
-    gint policy;                // Policy: SCHED_OTHER, SCHED_FIFO, SCHED_RR or SCHED_DEADLINE
+    gpointer input_data;        // Pointer to the input of the task (owned by the schedule input pool)
+    gint64 budget_lo_us;        // Optimistic execution budget, 0 = not monitored
+    gint64 budget_hi_us;        // Pessimistic execution budget
+    guint32 name_id;            // Task Name, index in schedule_task_names
+    guint32 deps_offset;        // First Call ID of the task in schedule_dependencies
+    guint32 input_size;         // Size of a pooled input, 0 for opaque inputs
+    guint32 cpu_budget_us;      // CPU time budget of a job, 0 = not enforced
+    guint16 task_id;            // Call Task ID
+    guint16 deps_count;         // Number of Call IDs the task depends on
+    gint16 cpu_affinity;        // CPU Affinity
     gint8 priority;             // Priority
-    gint cpu_affinity;          // CPU Affinity
+    guint8 policy;              // Policy: SCHED_OTHER, SCHED_FIFO, SCHED_RR or SCHED_DEADLINE
     guint8 repetition;          // Number that the task must repeate
-    GSList *depends_on;         // List of Call ID 
-    gpointer input_data;        // Pointer to the input of the task
+    guint8 criticality;         // Criticality level (task_criticality_t)
+    guint8 input_flags;         // task_input_flags_t
+    guint8 budget_action;       // task_budget_action_t
+    guint8 disabled;            // Removed while the schedule runs, dropped by schedule_compact
 } activation_data_t;
 
+G_STATIC_ASSERT(sizeof(activation_data_t) == 64);
+
 typedef struct {
+    gint64 release_ns;          // Release of the matching activation, pairs the job with its deadline
     guint16 task_id;            // Call Task ID 
-    GString *task_name;         
+    gint16 cpu_affinity;        // CPU Affinity of the matching activation
+    guint32 name_id;            // Task Name, index in schedule_task_names
+    guint8 disabled;            // Removed while the schedule runs (atomic, read by the deadline thread)
 } expiration_data_t;
 
 typedef struct {
-    gint64 timestamp;
-    GSList *data_list; /* List of activation_data_t* or expiration_data_t* */
+    gint64 timestamp_ns;        // Offset from the schedule time zero
+    GArray *items;      /* activation_data_t or expiration_data_t records, contiguous */
 } timeline_entry_t;
 
+#define timeline_entry_activation(entry, i) (&g_array_index((entry)->items, activation_data_t, (i)))
+#define timeline_entry_expiration(entry, i) (&g_array_index((entry)->items, expiration_data_t, (i)))
+
+/* One job of a task: the activation released at release_ns, matched by its expiration */
+typedef struct {
+    gint64 release_ns;          // Timeline offset of the release
+    guint16 task_id;            // Call Task ID
+} schedule_job_key_t;
+
 typedef struct {
     GSList *output_list;   /* List of GString* */
-    guint8 remaining_runs;
+    guint8 remaining_runs; /* Written under the mutex, read lock-free (atomic) */
+    guint8 repetition;     /* Runs restored by schedule_reset */
+    guint8 placed;         /* Lives in a result arena of the schedule or in a static table, never freed alone */
 } task_result_t;
 
+#define SCHEDULE_RESULT_SLOT 64    /* One cache line per placed result */
+G_STATIC_ASSERT(sizeof(task_result_t) <= SCHEDULE_RESULT_SLOT);
+
+/* NUMA local mapping holding placed task_result_t slots */
+typedef struct {
+    gpointer base;
+    gsize size;
+    gint node;
+} result_arena_t;
+
 /* --- Schedule Main Structure --- */
 
 typedef struct {
@@ -41,9 +99,26 @@ typedef struct {
     GString *schedule_version;
     GQueue *schedule_start_info;
     GQueue *schedule_end_info;
-    GHashTable *schedule_results;   // Map: Task ID (guint16) -> task_result_t* 
+    GTree *schedule_start_index;    // Map: timestamp_ns -> GList link in schedule_start_info
+    GTree *schedule_end_index;      // Map: timestamp_ns -> GList link in schedule_end_info
+    GHashTable *schedule_results;   // Map: Task ID (guint16) -> task_result_t*, replaced (not resized) by live merges
+    GPtrArray *schedule_retired_results; // Results tables replaced while running, freed by schedule_compact
+    GArray *schedule_result_arenas; // result_arena_t, per node mappings of the placed results
     pthread_mutex_t schedule_results_mutex;
-    gint64 schedule_duration;
+    gint64 schedule_duration_ns;    // Last deadline, offset from the time zero
+    gint64 schedule_max_window_ns;  // Longest release -> deadline window, bounds the live admission scans
+    clockid_t schedule_clock;       // Time base of the timeline: CLOCK_MONOTONIC or CLOCK_TAI
+    GHashTable *schedule_plugins;   // Map: plugin path -> task_plugin_t*
+    input_pool_t *schedule_inputs;  // Task inputs, shared by the jobs of every run
+    GPtrArray *schedule_resources;  // Shared resources (resource_t*), indexed by resource id
+    GHashTable *schedule_resource_index; // Map: resource name -> resource_t*
+    GPtrArray *schedule_task_names; // Interned task names (gchar*), indexed by name_id
+    GHashTable *schedule_name_index;// Map: task name -> name_id + 1
+    GArray *schedule_dependencies;  // Call IDs (guint16) referenced by the activations
+    gint schedule_pending_runs;     // Runs left over all the tasks (atomic)
+    GHashTable *schedule_done_jobs; // Set of the schedule_job_key_t* finished in the current run (under the results mutex)
+    gint schedule_completion_fd;    // eventfd incremented by every completed run, -1 if unavailable
+    gint64 schedule_last_completion_us; // Monotonic time of the last completed run (atomic)
 } schedule_t;
 
 
@@ -54,13 +129,45 @@ void schedule_free(schedule_t *sched);
 /* Schedule Getters/Setters */
 GSList *schedule_get_results(schedule_t *sched, guint16 id);
 void schedule_set_result(schedule_t *sched, guint16 id, const gchar *output);
+void schedule_abort_run(schedule_t *sched, guint16 id);
+void schedule_set_job_result(schedule_t *sched, guint16 id, gint64 release_ns, const gchar *output);
+void schedule_abort_job(schedule_t *sched, guint16 id, gint64 release_ns);
+gboolean schedule_set_clock(schedule_t *sched, clockid_t clock);
 
-/* Schedule Methods */
+/* Schedule Methods (schedule_add_task_ns takes ns, the other windows are in ms) */
+gboolean schedule_add_task_ns(schedule_t *sched, guint16 id, const gchar *name, GThreadFunc task_exec, gint policy, gint8 priority, gint cpu_affinity, guint8 repetition, GSList *depends_on, gint64 start_ns, gint64 end_ns, gpointer input);
 void schedule_add_task(schedule_t *sched, guint16 id, const gchar *name, GThreadFunc task_exec, gint policy, gint8 priority, gint cpu_affinity, guint8 repetition, GSList *depends_on,  gint64 start_time, gint64 end_time, gpointer input);
 void schedule_reset(schedule_t *sched);
+gboolean schedule_add_plugin_task(schedule_t *sched, guint16 id, const gchar *name, const gchar *plugin_path, const gchar *symbol, gint policy, gint8 priority, gint cpu_affinity, guint8 repetition, GSList *depends_on, gint64 start_time, gint64 end_time, gpointer input);
+void schedule_set_task_criticality(schedule_t *sched, guint16 id, task_criticality_t criticality, gint64 budget_lo_us, gint64 budget_hi_us);
+gboolean schedule_set_task_cpu_budget(schedule_t *sched, guint16 id, gint64 cpu_budget_us, task_budget_action_t action);
+gboolean schedule_set_task_input(schedule_t *sched, guint16 id, gconstpointer data, gsize size, task_input_flags_t flags);
+gboolean schedule_place_inputs(schedule_t *sched, const gint *cores, guint n_cores);
+gboolean schedule_place_results(schedule_t *sched, const gint *cores, guint n_cores);
+
+/* Live changes, applied by the dispatcher while the schedule runs */
+gboolean schedule_get_activation(schedule_t *sched, guint16 id, gint64 after_ns, activation_data_t *act, gint64 *start_ns, gint64 *end_ns);
+gboolean schedule_merge_task_ns(schedule_t *sched, const activation_data_t *act, const gchar *name, gint64 start_ns, gint64 end_ns, timeline_entry_t **start_entry, timeline_entry_t **end_entry);
+guint schedule_disable_task(schedule_t *sched, guint16 id, gint64 after_ns);
+activation_data_t* schedule_find_activation(schedule_t *sched, guint16 id, gint64 release_ns);
+void schedule_compact(schedule_t *sched);
+
+/* Shared resources (immediate priority ceiling) */
+resource_t* schedule_add_resource(schedule_t *sched, const gchar *name);
+resource_t* schedule_get_resource(schedule_t *sched, const gchar *name);
+gboolean schedule_task_uses_resource(schedule_t *sched, guint16 id, const gchar *name, gint64 cs_us);
+gboolean schedule_prepare_resources(schedule_t *sched);
+gint64 schedule_resource_blocking_us(schedule_t *sched, guint16 id);
+void schedule_print_resources(schedule_t *sched);
 
 /* Other Methods */
+const gchar *schedule_task_name(schedule_t *sched, guint32 name_id);
+const guint16 *schedule_task_dependencies(schedule_t *sched, const activation_data_t *act);
+gboolean schedule_has_task(schedule_t *sched, guint16 id);
 gboolean schedule_is_task_completed(schedule_t *sched, guint16 id);
+gboolean schedule_is_job_completed(schedule_t *sched, guint16 id, gint64 release_ns);
+guint8 schedule_get_remaining_runs(schedule_t *sched, guint16 id);
+gboolean schedule_is_completed(schedule_t *sched);
 void schedule_print(schedule_t *sched);
 
 
@@ -0,0 +1,50 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <glib.h>
+
+#include "schedule.h"
+#include "execution_manager.h"
+
+/* --- Simulation Structures --- */
+
+typedef enum {
+    SIM_EXEC_FIXED    = 0,      // Every job runs for fixed_exec_us
+    SIM_EXEC_PROFILE  = 1,      // Sampled uniformly from the task WCET profile
+    SIM_EXEC_MEASURED = 2       // Call the real task_exec and charge its CPU time
+} sim_exec_model_t;
+
+typedef struct {
+    gint64 min_us;
+    gint64 max_us;
+} sim_wcet_t;
+
+typedef struct {
+    sim_exec_model_t model;
+    gint64 fixed_exec_us;       // Used by SIM_EXEC_FIXED and for tasks missing from the profile
+    GHashTable *wcet_profile;   // Map: Task ID (guint16) -> sim_wcet_t*
+    guint32 seed;               // Same seed, same schedule -> same simulation
+} sim_config_t;
+
+typedef struct {
+    guint64 jobs_released;
+    guint64 jobs_completed;
+    guint64 deadline_misses;
+    guint64 jobs_unfinished;    // Still running or queued at the last deadline
+    gint64 virtual_end_ns;      // Virtual time of the last processed event
+    gint64 wall_time_us;        // Real time spent simulating
+} sim_report_t;
+
+
+/* Simulation Config Constructor/Destructor */
+sim_config_t* sim_config_new(sim_exec_model_t model, gint64 fixed_exec_us, guint32 seed);
+void sim_config_free(sim_config_t *cfg);
+
+/* Simulation Config Setters */
+void sim_config_set_wcet(sim_config_t *cfg, guint16 task_id, gint64 min_us, gint64 max_us);
+gboolean sim_config_load_wcet_profile(sim_config_t *cfg, const gchar *path);
+
+/* Simulation Backend */
+gboolean em_simulate_schedule(execution_manager_t *em, schedule_t *sched, sim_config_t *cfg, sim_report_t *report);
+
+#endif // SIMULATOR_H
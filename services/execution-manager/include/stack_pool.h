@@ -0,0 +1,51 @@
+#ifndef STACK_POOL_H
+#define STACK_POOL_H
+
+#include <glib.h>
+#include <pthread.h>
+
+#define STACK_POOL_DEFAULT_PER_CPU 8
+
+/* --- Stack Pool Structures --- */
+
+/* Worker stack, preceded by a guard page */
+typedef struct {
+    gpointer base;              // Lowest usable address
+    gsize size;
+    pthread_t thread;           // Last job thread run on the stack
+    gboolean busy;              // Thread not joined yet (dispatcher only)
+} em_stack_t;
+
+/* Stacks of one CPU, in one mapping on the NUMA node of the CPU */
+typedef struct {
+    gint cpu;
+    gint node;
+    gpointer map;
+    gsize map_size;
+    em_stack_t *stacks;
+    guint n_stacks;
+} stack_pool_cpu_t;
+
+/*
+ * Job stacks allocated before time zero on the node of the core that runs
+ * them. A stack is handed to a joinable job thread and taken back once the
+ * thread is joined; when all the stacks of a CPU are in use the job falls
+ * back to a default (detached) glibc stack.
+ */
+typedef struct {
+    GHashTable *cpus;           // Map: cpu -> stack_pool_cpu_t*
+    gsize stack_size;
+    guint per_cpu;
+} stack_pool_t;
+
+
+/* Stack Pool Constructor/Destructor */
+stack_pool_t* stack_pool_new(gsize stack_size, guint per_cpu);
+void stack_pool_free(stack_pool_t *pool);
+
+/* Stack Pool Methods */
+gboolean stack_pool_reserve(stack_pool_t *pool, gint cpu);
+em_stack_t* stack_pool_acquire(stack_pool_t *pool, gint cpu);
+void stack_pool_commit(em_stack_t *stack, pthread_t thread);
+
+#endif // STACK_POOL_H
@@ -0,0 +1,68 @@
+#ifndef STATIC_SCHEDULE_H
+#define STATIC_SCHEDULE_H
+
+#include <glib.h>
+#include <time.h>
+
+#include "schedule.h"
+
+/* --- Static Schedule Structures --- */
+
+/* Timeline entry of a generated table: count records from first, all released (or expired) at timestamp_ns */
+typedef struct {
+    gint64 timestamp_ns;        // Offset from the schedule time zero
+    guint32 first;              // Index of the first record in activations / expirations
+    guint32 count;
+} static_entry_t;
+
+/* Result slot of a generated table, one cache line per task like the placed results */
+typedef union {
+    task_result_t result;
+    guint8 line[SCHEDULE_RESULT_SLOT];
+} __attribute__((aligned(SCHEDULE_RESULT_SLOT))) static_result_slot_t;
+
+/*
+ * Schedule emitted by em-schedgen as const arrays: the records are already
+ * sorted by timestamp, the names interned and the dependency lists laid out,
+ * so loading it is one bulk copy per timeline entry with no validation,
+ * sorting or lookups. Shared inputs stay in .rodata; the result slots live
+ * in .data and are reused by every schedule loaded from the table (one at
+ * a time).
+ */
+typedef struct {
+    const gchar *name;
+    const gchar *version;
+    clockid_t clock;                        // CLOCK_MONOTONIC or CLOCK_TAI
+    gint64 duration_ns;                     // Last deadline
+    gint64 max_window_ns;                   // Longest release -> deadline window
+
+    const static_entry_t *starts;           // Activation timeline, by timestamp
+    guint32 n_starts;
+    const activation_data_t *activations;
+    guint32 n_activations;
+
+    const static_entry_t *ends;             // Expiration timeline, by timestamp
+    guint32 n_ends;
+    const expiration_data_t *expirations;
+    guint32 n_expirations;
+
+    const gchar *const *task_names;         // Indexed by name_id
+    guint32 n_task_names;
+    const guint16 *dependencies;            // Indexed by deps_offset
+    guint32 n_dependencies;
+
+    static_result_slot_t *results;          // One slot per task, by task id
+    const guint16 *result_ids;
+    guint32 n_results;
+} static_schedule_t;
+
+#ifdef EM_STATIC_SCHEDULE
+/* Table generated from the EM_STATIC_SCHEDULE description and linked in by the build */
+extern const static_schedule_t em_static_schedule;
+#endif
+
+
+/* Static Schedule Loader */
+schedule_t* schedule_new_static(const static_schedule_t *table);
+
+#endif // STATIC_SCHEDULE_H
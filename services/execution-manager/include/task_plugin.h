@@ -0,0 +1,40 @@
+#ifndef TASK_PLUGIN_H
+#define TASK_PLUGIN_H
+
+#include <glib.h>
+
+/* --- Plugin Contract --- */
+
+/*
+ * A task plugin is a shared object exporting the task entry point with the
+ * usual GThreadFunc signature (default symbol "task_main") and, optionally:
+ *   gboolean task_init(void);     called once at load, FALSE rejects the plugin
+ *   void     task_warmup(void);   called after init to touch code and data pages
+ *   void     task_teardown(void); called when the schedule is freed
+ */
+#define TASK_PLUGIN_ENTRY_SYMBOL    "task_main"
+#define TASK_PLUGIN_INIT_SYMBOL     "task_init"
+#define TASK_PLUGIN_WARMUP_SYMBOL   "task_warmup"
+#define TASK_PLUGIN_TEARDOWN_SYMBOL "task_teardown"
+
+typedef gboolean (*task_plugin_init_func)(void);
+typedef void (*task_plugin_hook_func)(void);
+
+/* --- Plugin Structure --- */
+
+typedef struct {
+    GString *path;                      // Path given to dlopen
+    void *handle;                       // dlopen handle
+    GThreadFunc task_exec;              // Resolved entry point
+    task_plugin_hook_func teardown;     // Optional teardown hook
+} task_plugin_t;
+
+
+/* Plugin Constructor/Destructor */
+task_plugin_t* task_plugin_load(const gchar *path);
+void task_plugin_free(task_plugin_t *plugin);
+
+/* Plugin Methods */
+GThreadFunc task_plugin_resolve(task_plugin_t *plugin, const gchar *symbol);
+
+#endif // TASK_PLUGIN_H
@@ -0,0 +1,55 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <glib.h>
+
+#define DEFAULT_TRACE_CAPACITY 65536
+
+/* --- Trace Event Types --- */
+
+typedef enum {
+    TRACE_EVENT_RELEASE  = 0,   // Dispatcher released an activation
+    TRACE_EVENT_START    = 1,   // Worker thread entered task_exec (arg = release latency in us)
+    TRACE_EVENT_FINISH   = 2,   // Worker thread returned from task_exec
+    TRACE_EVENT_DEADLINE = 3,   // Deadline reached for a task
+    TRACE_EVENT_ABORT    = 4,   // Task still running at its deadline
+    TRACE_EVENT_WAKEUP   = 5,   // Dispatcher woke up (arg = lateness in us)
+    TRACE_EVENT_MODE     = 6,   // Criticality mode switch (arg = new mode)
+    TRACE_EVENT_DROP     = 7,   // Release skipped by the dispatcher
+    TRACE_EVENT_COMPLETE = 8,   // Dispatcher notified of completed runs (arg = notification latency in us)
+    TRACE_EVENT_OVERLOAD = 9,   // Core load above the overload threshold (arg = measured or projected load, per mille)
+    TRACE_EVENT_BUDGET   = 10   // Job exhausted its CPU time budget (arg = CPU time of the job in us)
+} trace_event_type_t;
+
+/* --- Trace Structures --- */
+
+typedef struct {
+    gint64 timestamp_us;        // Relative to the schedule time zero
+    gint64 arg;                 // Event specific argument
+    guint16 task_id;            // Call Task ID (0 for dispatcher events)
+    gint16 cpu;                 // CPU of the task (-1 for dispatcher events)
+    guint8 type;                // trace_event_type_t
+    gint committed;             // Set last, the exporter skips half written events
+} trace_event_t;
+
+typedef struct {
+    trace_event_t *events;      // Preallocated event ring
+    guint capacity;             // Number of slots in events
+    gint next;                  // Next free slot (atomic)
+    gint dropped;               // Events lost because the buffer was full (atomic)
+    gint64 time_zero_us;        // Monotonic time of the schedule time zero
+    gint marker_fd;             // ftrace trace_marker descriptor, -1 if disabled
+} trace_buffer_t;
+
+
+/* Trace Constructor/Destructor */
+trace_buffer_t* trace_new(guint capacity, gboolean use_trace_marker);
+void trace_free(trace_buffer_t *tb);
+
+/* Trace Methods */
+void trace_reset(trace_buffer_t *tb, gint64 time_zero_us);
+void trace_record(trace_buffer_t *tb, trace_event_type_t type, guint16 task_id, gint cpu, gint64 arg);
+void trace_record_at(trace_buffer_t *tb, gint64 timestamp_us, trace_event_type_t type, guint16 task_id, gint cpu, gint64 arg);
+gboolean trace_export_chrome(trace_buffer_t *tb, const gchar *path);
+
+#endif // TRACE_H
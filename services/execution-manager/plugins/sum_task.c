@@ -0,0 +1,31 @@
+#include <glib.h>
+
+#include "app_task.h"
+
+/* Example task plugin: same contract as the compiled-in task_main */
+
+static output_t *warmup_output = NULL;
+
+gboolean task_init(void){
+    warmup_output = g_new0(output_t, 1);
+    return TRUE;
+}
+
+void task_warmup(void){
+    /* Run the computation once so code and data pages are resident */
+    input_t input = { .a = 0, .b = 0 };
+    warmup_output->result = input.a + input.b;
+}
+
+void task_teardown(void){
+    g_free(warmup_output);
+    warmup_output = NULL;
+}
+
+void* task_main(void* data){
+    input_t* input = (input_t*)data;
+
+    output_t* output = g_new0(output_t, 1);
+    output->result = input->a + input->b;
+    return output;
+}
@@ -0,0 +1,290 @@
+#define _GNU_SOURCE
+#include "aperiodic_server.h"
+#include "em_time.h"
+#include <errno.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+/* -----------------Helper Functions ----------------- */
+
+static void aperiodic_server_notify(aperiodic_server_t *srv) {
+    guint64 one = 1;
+    if (write(srv->event_fd, &one, sizeof(one)) < 0) {
+        /* Counter saturated: the dispatcher is already woken up */
+    }
+}
+
+static void aperiodic_job_free(aperiodic_job_t *job) {
+    if (!job) return;
+    if (job->input_free) job->input_free(job->input);
+    g_free(job);
+}
+
+/* Worker: one job at a time, handed over by the dispatcher only while the server has budget */
+static void *aperiodic_server_worker(void *data) {
+    aperiodic_server_t *srv = (aperiodic_server_t *)data;
+
+    g_mutex_lock(&srv->lock);
+    while (!srv->stop) {
+        if (!srv->current) {
+            g_cond_wait(&srv->assigned, &srv->lock);
+            continue;
+        }
+        aperiodic_job_t *job = srv->current;
+        g_mutex_unlock(&srv->lock);
+
+        gint64 start_ns = em_time_now_ns(CLOCK_MONOTONIC);
+        trace_record(srv->trace, TRACE_EVENT_START, job->task_id, srv->cpu, em_time_ns_to_us(start_ns - job->submit_ns));
+        g_free(job->func(job->input));
+        if (job->input_free) job->input_free(job->input);
+        job->input_free = NULL;
+        job->finish_ns = em_time_now_ns(CLOCK_MONOTONIC);
+        trace_record(srv->trace, TRACE_EVENT_FINISH, job->task_id, srv->cpu, 0);
+        metrics_observe_server_response(srv->metrics, srv->cpu, em_time_ns_to_us(job->finish_ns - job->submit_ns));
+
+        g_mutex_lock(&srv->lock);
+        srv->current = NULL;
+        srv->done = job;
+        aperiodic_server_notify(srv);
+    }
+    g_mutex_unlock(&srv->lock);
+    return NULL;
+}
+
+static gint aperiodic_server_set_priority(aperiodic_server_t *srv, gint priority) {
+    struct sched_param param = { .sched_priority = priority };
+    return pthread_setschedparam(srv->worker, priority > 0 ? SCHED_FIFO : SCHED_OTHER, &param);
+}
+
+/* CPU time of the worker since the last charge: budget while promoted, background while demoted */
+static void aperiodic_server_charge(aperiodic_server_t *srv) {
+    gint64 cpu_ns = em_time_now_ns(srv->worker_clock);
+    gint64 delta_ns = cpu_ns - srv->charged_cpu_ns;
+    srv->charged_cpu_ns = cpu_ns;
+    if (delta_ns <= 0) return;
+
+    if (srv->demoted) {
+        srv->background_ns += delta_ns;
+        return;
+    }
+    srv->budget_ns -= delta_ns;
+    srv->active_consumed_ns += delta_ns;
+    srv->consumed_ns += delta_ns;
+    metrics_add_server_budget(srv->metrics, srv->cpu, em_time_ns_to_us(delta_ns));
+}
+
+/* End of an active interval: what it consumed comes back one period after its start */
+static void aperiodic_server_close_active(aperiodic_server_t *srv, gint64 now_ns) {
+    if (srv->active_consumed_ns > 0) {
+        aperiodic_replenishment_t *rep = g_new(aperiodic_replenishment_t, 1);
+        rep->time_ns = em_time_add_sat(srv->active_since_ns >= 0 ? srv->active_since_ns : now_ns, srv->period_ns);
+        rep->amount_ns = srv->active_consumed_ns;
+        g_queue_push_tail(srv->replenishments, rep);    // Start times only grow: the queue stays sorted
+    }
+    srv->active_since_ns = -1;
+    srv->active_consumed_ns = 0;
+}
+
+
+
+/* ----------------- Aperiodic Server Constructor/Destructor ----------------- */
+
+aperiodic_server_t* aperiodic_server_new(gint cpu, gint priority, gint64 capacity_us, gint64 period_us) {
+    g_return_val_if_fail(cpu >= 0, NULL);
+    g_return_val_if_fail(capacity_us > 0 && period_us >= capacity_us, NULL);
+
+    gint fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) {
+        g_printerr("[ERROR] Execution Manager: eventfd failed (%s)\n", g_strerror(errno));
+        return NULL;
+    }
+
+    aperiodic_server_t *srv = g_new0(aperiodic_server_t, 1);
+    srv->cpu = cpu;
+    srv->priority = CLAMP(priority, 0, sched_get_priority_max(SCHED_FIFO));
+    srv->capacity_ns = em_time_us_to_ns(capacity_us);
+    srv->period_ns = em_time_us_to_ns(period_us);
+    srv->budget_ns = srv->capacity_ns;
+    srv->active_since_ns = -1;
+    srv->event_fd = fd;
+    g_mutex_init(&srv->lock);
+    g_cond_init(&srv->assigned);
+    srv->pending = g_queue_new();
+    srv->replenishments = g_queue_new();
+
+    /* 1. Worker pinned to the core, at the server priority */
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &set);
+    struct sched_param param = { .sched_priority = srv->priority };
+    pthread_attr_setschedpolicy(&attr, srv->priority > 0 ? SCHED_FIFO : SCHED_OTHER);
+    pthread_attr_setschedparam(&attr, &param);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+
+    gint rc = pthread_create(&srv->worker, &attr, aperiodic_server_worker, srv);
+    if (rc == EPERM && srv->priority > 0) {
+        g_printerr("[WARNING] Execution Manager: no permission for SCHED_FIFO, aperiodic server of CPU %d runs as SCHED_OTHER.\n", cpu);
+        srv->priority = 0;
+        param.sched_priority = 0;
+        pthread_attr_setschedpolicy(&attr, SCHED_OTHER);
+        pthread_attr_setschedparam(&attr, &param);
+        rc = pthread_create(&srv->worker, &attr, aperiodic_server_worker, srv);
+    }
+    pthread_attr_destroy(&attr);
+    if (rc) {
+        g_printerr("[ERROR] Execution Manager: aperiodic server of CPU %d not started (%s)\n", cpu, g_strerror(rc));
+        aperiodic_server_free(srv);
+        return NULL;
+    }
+    srv->worker_started = TRUE;
+
+    /* 2. The CPU clock of the worker meters the budget */
+    if (pthread_getcpuclockid(srv->worker, &srv->worker_clock) != 0) srv->worker_clock = CLOCK_MONOTONIC;
+    srv->charged_cpu_ns = em_time_now_ns(srv->worker_clock);
+
+    g_print("[INFO] Execution Manager: aperiodic server on CPU %d, %ld us every %ld us at priority %d\n",
+            cpu, (long)capacity_us, (long)period_us, srv->priority);
+    return srv;
+}
+
+/* The job in progress is completed, the pending ones are dropped */
+void aperiodic_server_free(aperiodic_server_t *srv) {
+    if (!srv) return;
+
+    if (srv->worker_started) {
+        g_mutex_lock(&srv->lock);
+        srv->stop = TRUE;
+        g_cond_signal(&srv->assigned);
+        g_mutex_unlock(&srv->lock);
+        pthread_join(srv->worker, NULL);
+    }
+    aperiodic_job_free(srv->current);
+    aperiodic_job_free(srv->done);
+    g_queue_free_full(srv->pending, (GDestroyNotify)aperiodic_job_free);
+    g_queue_free_full(srv->replenishments, g_free);
+    g_cond_clear(&srv->assigned);
+    g_mutex_clear(&srv->lock);
+    close(srv->event_fd);
+    g_free(srv);
+}
+
+
+/* ----------------- Aperiodic Server Methods ----------------- */
+
+/* Safe from any thread. Returns the job id, 0 if the queue is full (input is not taken) */
+guint32 aperiodic_server_submit(aperiodic_server_t *srv, guint16 task_id, GThreadFunc func, gpointer input, GDestroyNotify input_free) {
+    g_return_val_if_fail(srv != NULL && func != NULL, 0);
+
+    g_mutex_lock(&srv->lock);
+    if (srv->stop || g_queue_get_length(srv->pending) >= APERIODIC_QUEUE_MAX) {
+        g_mutex_unlock(&srv->lock);
+        __atomic_fetch_add(&srv->rejected, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+    aperiodic_job_t *job = g_new0(aperiodic_job_t, 1);
+    job->job_id = ++srv->next_job_id;
+    job->task_id = task_id;
+    job->func = func;
+    job->input = input;
+    job->input_free = input_free;
+    job->submit_ns = em_time_now_ns(CLOCK_MONOTONIC);
+    g_queue_push_tail(srv->pending, job);
+    guint32 job_id = job->job_id;
+    g_mutex_unlock(&srv->lock);
+
+    __atomic_fetch_add(&srv->submitted, 1, __ATOMIC_RELAXED);
+    aperiodic_server_notify(srv);
+    return job_id;
+}
+
+/*
+ * Dispatcher step: account the worker, apply the replenishments due,
+ * demote or promote the worker, hand over the next job. Returns the
+ * monotonic time of the next required step, -1 if only an event can
+ * change the state. Overruns are bounded by the dispatcher wake up latency.
+ */
+gint64 aperiodic_server_update(aperiodic_server_t *srv, gint64 now_ns) {
+    g_return_val_if_fail(srv != NULL, -1);
+
+    /* 1. Finished job and pending work */
+    g_mutex_lock(&srv->lock);
+    aperiodic_job_t *done = srv->done;
+    srv->done = NULL;
+    gboolean has_pending = !g_queue_is_empty(srv->pending);
+    g_mutex_unlock(&srv->lock);
+
+    aperiodic_server_charge(srv);
+    if (done) {
+        gint64 response_ns = done->finish_ns - done->submit_ns;
+        srv->busy = FALSE;
+        srv->served++;
+        srv->total_response_ns += response_ns;
+        srv->max_response_ns = MAX(srv->max_response_ns, response_ns);
+        aperiodic_job_free(done);
+    }
+
+    /* 2. Budget given back */
+    aperiodic_replenishment_t *rep;
+    while ((rep = g_queue_peek_head(srv->replenishments)) && rep->time_ns <= now_ns) {
+        srv->budget_ns = MIN(srv->capacity_ns, srv->budget_ns + rep->amount_ns);
+        g_free(g_queue_pop_head(srv->replenishments));
+    }
+
+    /* 3. Exhausted: the job goes on in background until the next replenishment */
+    if (srv->budget_ns <= 0) {
+        if (srv->busy && !srv->demoted) {
+            aperiodic_server_set_priority(srv, 0);
+            srv->demoted = TRUE;
+            srv->exhaustions++;
+            metrics_inc_server_exhaustion(srv->metrics, srv->cpu);
+        }
+        aperiodic_server_close_active(srv, now_ns);
+    } else if (srv->demoted) {
+        aperiodic_server_set_priority(srv, srv->priority);
+        srv->demoted = FALSE;
+        srv->active_since_ns = now_ns;
+    }
+
+    /* 4. Next job, or end of the active interval */
+    if (!srv->busy) {
+        if (has_pending && srv->budget_ns > 0) {
+            if (srv->active_since_ns < 0) srv->active_since_ns = now_ns;
+            g_mutex_lock(&srv->lock);
+            srv->current = g_queue_pop_head(srv->pending);
+            g_cond_signal(&srv->assigned);
+            g_mutex_unlock(&srv->lock);
+            srv->busy = TRUE;
+        } else {
+            aperiodic_server_close_active(srv, now_ns);
+        }
+    }
+
+    /* 5. Next step: the earliest replenishment, or the exhaustion of the running job */
+    rep = g_queue_peek_head(srv->replenishments);
+    gint64 next_ns = rep ? rep->time_ns : -1;
+    if (srv->busy && !srv->demoted) {
+        gint64 exhaust_ns = em_time_add_sat(now_ns, srv->budget_ns);
+        next_ns = (next_ns < 0) ? exhaust_ns : MIN(next_ns, exhaust_ns);
+    }
+    return next_ns;
+}
+
+/* Worst interference on the core over an interval: a sporadic server behaves as a periodic task (capacity, period) */
+gint64 aperiodic_server_demand_ns(const aperiodic_server_t *srv, gint64 interval_ns) {
+    if (!srv || interval_ns <= 0) return 0;
+    return MIN(interval_ns, (interval_ns / srv->period_ns + 1) * srv->capacity_ns);
+}
+
+void aperiodic_server_print(aperiodic_server_t *srv) {
+    if (!srv) return;
+
+    g_print("[INFO] Execution Manager: aperiodic server CPU %d, %" G_GUINT64_FORMAT " served / %" G_GUINT64_FORMAT " submitted (%" G_GUINT64_FORMAT " rejected), "
+            "budget %.3f ms consumed, %.3f ms in background, %" G_GUINT64_FORMAT " exhaustion(s), response avg %.3f ms, max %.3f ms\n",
+            srv->cpu, srv->served, __atomic_load_n(&srv->submitted, __ATOMIC_RELAXED), __atomic_load_n(&srv->rejected, __ATOMIC_RELAXED),
+            (gdouble)srv->consumed_ns / EM_NSEC_PER_MSEC, (gdouble)srv->background_ns / EM_NSEC_PER_MSEC, srv->exhaustions,
+            srv->served ? (gdouble)srv->total_response_ns / srv->served / EM_NSEC_PER_MSEC : 0.0, (gdouble)srv->max_response_ns / EM_NSEC_PER_MSEC);
+}
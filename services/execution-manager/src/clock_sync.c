@@ -0,0 +1,365 @@
+#include "clock_sync.h"
+#include "em_time.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#define CLOCK_SYNC_MAGIC 0x454d4353u    // "EMCS"
+#define CLOCK_SYNC_VERSION 1
+
+typedef enum {
+    CLOCK_SYNC_MSG_REQUEST  = 1,
+    CLOCK_SYNC_MSG_RESPONSE = 2
+} clock_sync_msg_type_t;
+
+/* Wire format, big endian */
+typedef struct {
+    guint32 magic;
+    guint16 type;
+    guint16 version;
+    guint32 seq;
+    guint32 reserved;
+    gint64 t1;                  // Follower send time (follower clock)
+    gint64 t2;                  // Master receive time (master clock)
+    gint64 t3;                  // Master send time (master clock)
+    gint64 epoch_ns;            // Group epoch (master clock)
+} clock_sync_msg_t;
+
+/* -----------------Helper Functions ----------------- */
+
+static inline gint64 clock_sync_now_ns(void) {
+    return em_time_now_ns(CLOCK_MONOTONIC);
+}
+
+static void clock_sync_msg_encode(clock_sync_msg_t *msg) {
+    msg->magic = GUINT32_TO_BE(msg->magic);
+    msg->type = GUINT16_TO_BE(msg->type);
+    msg->version = GUINT16_TO_BE(msg->version);
+    msg->seq = GUINT32_TO_BE(msg->seq);
+    msg->t1 = (gint64)GUINT64_TO_BE((guint64)msg->t1);
+    msg->t2 = (gint64)GUINT64_TO_BE((guint64)msg->t2);
+    msg->t3 = (gint64)GUINT64_TO_BE((guint64)msg->t3);
+    msg->epoch_ns = (gint64)GUINT64_TO_BE((guint64)msg->epoch_ns);
+}
+
+static gboolean clock_sync_msg_decode(clock_sync_msg_t *msg, gssize len, clock_sync_msg_type_t type) {
+    if (len != sizeof(clock_sync_msg_t)) return FALSE;
+    msg->magic = GUINT32_FROM_BE(msg->magic);
+    msg->type = GUINT16_FROM_BE(msg->type);
+    msg->version = GUINT16_FROM_BE(msg->version);
+    msg->seq = GUINT32_FROM_BE(msg->seq);
+    msg->t1 = (gint64)GUINT64_FROM_BE((guint64)msg->t1);
+    msg->t2 = (gint64)GUINT64_FROM_BE((guint64)msg->t2);
+    msg->t3 = (gint64)GUINT64_FROM_BE((guint64)msg->t3);
+    msg->epoch_ns = (gint64)GUINT64_FROM_BE((guint64)msg->epoch_ns);
+    return msg->magic == CLOCK_SYNC_MAGIC && msg->version == CLOCK_SYNC_VERSION && msg->type == type;
+}
+
+static inline void counter_add(guint64 *counter, guint64 value) {
+    __atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+}
+
+/* Seqlock writer: readers retry while seq is odd or has changed */
+static void clock_sync_publish(clock_sync_t *cs, gint64 ref_ns, gint64 offset_ns, gint64 drift_ppb) {
+    __atomic_fetch_add(&cs->seq, 1, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&cs->ref_ns, ref_ns, __ATOMIC_RELAXED);
+    __atomic_store_n(&cs->offset_ns, offset_ns, __ATOMIC_RELAXED);
+    __atomic_store_n(&cs->drift_ppb, drift_ppb, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&cs->seq, 1, __ATOMIC_RELEASE);
+}
+
+static void clock_sync_read(clock_sync_t *cs, gint64 *ref_ns, gint64 *offset_ns, gint64 *drift_ppb) {
+    gint seq;
+    do {
+        seq = __atomic_load_n(&cs->seq, __ATOMIC_ACQUIRE);
+        *ref_ns = __atomic_load_n(&cs->ref_ns, __ATOMIC_RELAXED);
+        *offset_ns = __atomic_load_n(&cs->offset_ns, __ATOMIC_RELAXED);
+        *drift_ppb = __atomic_load_n(&cs->drift_ppb, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((seq & 1) || seq != __atomic_load_n(&cs->seq, __ATOMIC_RELAXED));
+}
+
+/*
+ * Lucky packet filter and fit: only the exchanges whose round trip is close
+ * to the smallest one seen carry a symmetric path delay; the offset and the
+ * drift are the least squares line through them.
+ */
+static void clock_sync_fit(clock_sync_t *cs) {
+    guint n = MIN(cs->n_samples, CLOCK_SYNC_SAMPLES);
+    gint64 min_delay_ns = G_MAXINT64;
+    const clock_sync_sample_t *best = NULL;
+    for (guint i = 0; i < n; i++) {
+        if (cs->samples[i].delay_ns < min_delay_ns) {
+            min_delay_ns = cs->samples[i].delay_ns;
+            best = &cs->samples[i];
+        }
+    }
+    if (!best) return;
+
+    gint64 max_delay_ns = 2 * min_delay_ns + 1000;
+    gdouble mean_t = 0, mean_o = 0;
+    guint used = 0;
+    for (guint i = 0; i < n; i++) {
+        if (cs->samples[i].delay_ns > max_delay_ns) continue;
+        mean_t += (gdouble)(cs->samples[i].local_ns - best->local_ns);
+        mean_o += (gdouble)(cs->samples[i].offset_ns - best->offset_ns);
+        used++;
+    }
+    mean_t /= used;
+    mean_o /= used;
+
+    gdouble stt = 0, sto = 0;
+    for (guint i = 0; i < n; i++) {
+        if (cs->samples[i].delay_ns > max_delay_ns) continue;
+        gdouble dt = (gdouble)(cs->samples[i].local_ns - best->local_ns) - mean_t;
+        gdouble d_o = (gdouble)(cs->samples[i].offset_ns - best->offset_ns) - mean_o;
+        stt += dt * dt;
+        sto += dt * d_o;
+    }
+
+    /* Too few or too close samples for a slope: the previous drift is kept */
+    gint64 drift_ppb = __atomic_load_n(&cs->drift_ppb, __ATOMIC_RELAXED);
+    if (used >= 3 && stt > 0) {
+        drift_ppb = (gint64)(sto / stt * 1e9);
+        drift_ppb = CLAMP(drift_ppb, -CLOCK_SYNC_MAX_DRIFT_PPB, CLOCK_SYNC_MAX_DRIFT_PPB);
+    }
+    clock_sync_publish(cs, best->local_ns + (gint64)mean_t, best->offset_ns + (gint64)mean_o, drift_ppb);
+}
+
+static void clock_sync_add_sample(clock_sync_t *cs, gint64 t1, gint64 t2, gint64 t3, gint64 t4) {
+    clock_sync_sample_t sample;
+    sample.local_ns = t1 + (t4 - t1) / 2;
+    sample.offset_ns = ((t2 - t1) + (t3 - t4)) / 2;
+    sample.delay_ns = (t4 - t1) - (t3 - t2);
+    if (sample.delay_ns < 0) return;       // Master turnaround longer than the round trip: bogus
+
+    /* Prediction error of the current estimate, the continuous correction quality */
+    if (clock_sync_is_locked(cs)) {
+        gint64 error_ns = sample.offset_ns - (clock_sync_to_master_ns(cs, sample.local_ns) - sample.local_ns);
+        __atomic_store_n(&cs->last_error_ns, error_ns, __ATOMIC_RELAXED);
+        if (ABS(error_ns) > __atomic_load_n(&cs->max_error_ns, __ATOMIC_RELAXED)) __atomic_store_n(&cs->max_error_ns, ABS(error_ns), __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&cs->last_delay_ns, sample.delay_ns, __ATOMIC_RELAXED);
+
+    cs->samples[cs->n_samples % CLOCK_SYNC_SAMPLES] = sample;
+    cs->n_samples++;
+    clock_sync_fit(cs);
+    if (cs->n_samples >= CLOCK_SYNC_LOCK_SAMPLES) g_atomic_int_set(&cs->locked, 1);
+}
+
+/* Master: every request is answered at once, t2/t3 as close as possible to the socket calls */
+static gpointer clock_sync_master_func(gpointer data) {
+    clock_sync_t *cs = (clock_sync_t *)data;
+
+    while (!g_atomic_int_get(&cs->stop)) {
+        struct pollfd pfd = { .fd = cs->fd, .events = POLLIN };
+        if (poll(&pfd, 1, 200) <= 0) continue;
+
+        clock_sync_msg_t msg;
+        struct sockaddr_storage peer;
+        socklen_t peer_len = sizeof(peer);
+        gssize len = recvfrom(cs->fd, &msg, sizeof(msg), 0, (struct sockaddr *)&peer, &peer_len);
+        gint64 t2 = clock_sync_now_ns();
+        if (!clock_sync_msg_decode(&msg, len, CLOCK_SYNC_MSG_REQUEST)) continue;
+
+        msg.type = CLOCK_SYNC_MSG_RESPONSE;
+        msg.t2 = t2;
+        msg.epoch_ns = __atomic_load_n(&cs->epoch_ns, __ATOMIC_RELAXED);
+        msg.t3 = clock_sync_now_ns();
+        clock_sync_msg_encode(&msg);
+        if (sendto(cs->fd, &msg, sizeof(msg), 0, (struct sockaddr *)&peer, peer_len) == sizeof(msg)) counter_add(&cs->exchanges, 1);
+    }
+    return NULL;
+}
+
+/* Follower: one exchange per interval, late replies of a previous exchange are dropped by seq */
+static gpointer clock_sync_follower_func(gpointer data) {
+    clock_sync_t *cs = (clock_sync_t *)data;
+    gint64 interval_ns = (gint64)cs->interval_ms * EM_NSEC_PER_MSEC;
+
+    while (!g_atomic_int_get(&cs->stop)) {
+        guint32 seq = ++cs->next_seq;
+        clock_sync_msg_t msg = { CLOCK_SYNC_MAGIC, CLOCK_SYNC_MSG_REQUEST, CLOCK_SYNC_VERSION, seq, 0, 0, 0, 0, 0 };
+        gint64 t1 = clock_sync_now_ns();
+        msg.t1 = t1;
+        clock_sync_msg_encode(&msg);
+        gboolean answered = FALSE;
+        if (send(cs->fd, &msg, sizeof(msg), 0) != sizeof(msg)) answered = TRUE;     // Not sent, not lost
+
+        gint64 next_ns = t1 + interval_ns;
+        gint64 now_ns = clock_sync_now_ns();
+        while (now_ns < next_ns && !g_atomic_int_get(&cs->stop)) {
+            struct pollfd pfd = { .fd = cs->fd, .events = POLLIN };
+            gint timeout_ms = (gint)MAX((next_ns - now_ns) / EM_NSEC_PER_MSEC, 1);
+            if (poll(&pfd, 1, MIN(timeout_ms, 200)) > 0) {
+                clock_sync_msg_t reply;
+                gssize len = recv(cs->fd, &reply, sizeof(reply), 0);
+                gint64 t4 = clock_sync_now_ns();
+                if (!answered && clock_sync_msg_decode(&reply, len, CLOCK_SYNC_MSG_RESPONSE) && reply.seq == seq && reply.t1 == t1) {
+                    answered = TRUE;
+                    __atomic_store_n(&cs->epoch_ns, reply.epoch_ns, __ATOMIC_RELAXED);
+                    clock_sync_add_sample(cs, reply.t1, reply.t2, reply.t3, t4);
+                    counter_add(&cs->exchanges, 1);
+                }
+            }
+            now_ns = clock_sync_now_ns();
+        }
+        if (!answered) counter_add(&cs->lost, 1);
+    }
+    return NULL;
+}
+
+static clock_sync_t *clock_sync_alloc(clock_sync_role_t role, gint fd) {
+    clock_sync_t *cs = g_new0(clock_sync_t, 1);
+    cs->role = role;
+    cs->fd = fd;
+    cs->interval_ms = CLOCK_SYNC_DEFAULT_INTERVAL_MS;
+    return cs;
+}
+
+
+
+/* ----------------- Clock Sync Constructor/Destructor ----------------- */
+
+/* The epoch of the group is the start of the master; its own estimate is exact */
+clock_sync_t* clock_sync_new_master(gint port) {
+    g_return_val_if_fail(port > 0 && port < 65536, NULL);
+
+    gint fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        g_printerr("[ERROR] Execution Manager: clock sync socket failed (%s)\n", g_strerror(errno));
+        return NULL;
+    }
+    gint one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((guint16)port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        g_printerr("[ERROR] Execution Manager: clock sync cannot bind port %d (%s)\n", port, g_strerror(errno));
+        close(fd);
+        return NULL;
+    }
+
+    clock_sync_t *cs = clock_sync_alloc(CLOCK_SYNC_MASTER, fd);
+    cs->epoch_ns = clock_sync_now_ns();
+    clock_sync_publish(cs, cs->epoch_ns, 0, 0);
+    cs->locked = 1;
+    cs->thread = g_thread_new("em-clock-sync", clock_sync_master_func, cs);
+
+    g_print("[INFO] Execution Manager: clock sync master on UDP port %d\n", port);
+    return cs;
+}
+
+clock_sync_t* clock_sync_new_follower(const gchar *host, gint port, guint interval_ms) {
+    g_return_val_if_fail(host != NULL, NULL);
+    g_return_val_if_fail(port > 0 && port < 65536, NULL);
+
+    struct addrinfo hints, *res = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    gchar service[16];
+    g_snprintf(service, sizeof(service), "%d", port);
+    gint rc = getaddrinfo(host, service, &hints, &res);
+    if (rc != 0) {
+        g_printerr("[ERROR] Execution Manager: clock sync master %s not resolved (%s)\n", host, gai_strerror(rc));
+        return NULL;
+    }
+
+    /* Connected UDP socket: only the master's datagrams are received */
+    gint fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+        g_printerr("[ERROR] Execution Manager: clock sync socket to %s:%d failed (%s)\n", host, port, g_strerror(errno));
+        if (fd >= 0) close(fd);
+        freeaddrinfo(res);
+        return NULL;
+    }
+    freeaddrinfo(res);
+
+    clock_sync_t *cs = clock_sync_alloc(CLOCK_SYNC_FOLLOWER, fd);
+    if (interval_ms > 0) cs->interval_ms = interval_ms;
+    cs->thread = g_thread_new("em-clock-sync", clock_sync_follower_func, cs);
+
+    g_print("[INFO] Execution Manager: clock sync follower of %s:%d, exchange every %u ms\n", host, port, cs->interval_ms);
+    return cs;
+}
+
+void clock_sync_free(clock_sync_t *cs) {
+    if (!cs) return;
+
+    g_atomic_int_set(&cs->stop, 1);
+    if (cs->thread) g_thread_join(cs->thread);
+    close(cs->fd);
+    g_free(cs);
+}
+
+
+/* ----------------- Clock Sync Methods ----------------- */
+
+gboolean clock_sync_is_locked(clock_sync_t *cs) {
+    return cs && g_atomic_int_get(&cs->locked);
+}
+
+gboolean clock_sync_wait_locked(clock_sync_t *cs, gint64 timeout_us) {
+    g_return_val_if_fail(cs != NULL, FALSE);
+
+    gint64 until_us = g_get_monotonic_time() + timeout_us;
+    while (!clock_sync_is_locked(cs) && g_get_monotonic_time() < until_us) g_usleep(10000);
+    return clock_sync_is_locked(cs);
+}
+
+gint64 clock_sync_to_master_ns(clock_sync_t *cs, gint64 local_ns) {
+    g_return_val_if_fail(cs != NULL, local_ns);
+
+    gint64 ref_ns, offset_ns, drift_ppb;
+    clock_sync_read(cs, &ref_ns, &offset_ns, &drift_ppb);
+    return local_ns + offset_ns + (gint64)((gdouble)(local_ns - ref_ns) * drift_ppb / 1e9);
+}
+
+/* Inverse of clock_sync_to_master_ns, the drift term is taken at the first guess */
+gint64 clock_sync_to_local_ns(clock_sync_t *cs, gint64 master_ns) {
+    g_return_val_if_fail(cs != NULL, master_ns);
+
+    gint64 ref_ns, offset_ns, drift_ppb;
+    clock_sync_read(cs, &ref_ns, &offset_ns, &drift_ppb);
+    gint64 guess_ns = master_ns - offset_ns;
+    return guess_ns - (gint64)((gdouble)(guess_ns - ref_ns) * drift_ppb / 1e9);
+}
+
+/* Local time of the first instant epoch + k * period after after_local_ns: every instance lands on the same one */
+gint64 clock_sync_next_boundary_ns(clock_sync_t *cs, gint64 after_local_ns, gint64 period_ns) {
+    g_return_val_if_fail(cs != NULL && period_ns > 0, after_local_ns);
+
+    gint64 epoch_ns = __atomic_load_n(&cs->epoch_ns, __ATOMIC_RELAXED);
+    gint64 master_ns = clock_sync_to_master_ns(cs, after_local_ns);
+    gint64 boundary_ns = epoch_ns;
+    if (master_ns > epoch_ns) boundary_ns = epoch_ns + ((master_ns - epoch_ns + period_ns - 1) / period_ns) * period_ns;
+    return clock_sync_to_local_ns(cs, boundary_ns);
+}
+
+void clock_sync_print(clock_sync_t *cs) {
+    if (!cs) return;
+
+    gint64 ref_ns, offset_ns, drift_ppb;
+    clock_sync_read(cs, &ref_ns, &offset_ns, &drift_ppb);
+    if (cs->role == CLOCK_SYNC_MASTER) {
+        g_print("[INFO] Execution Manager: clock sync master, %" G_GUINT64_FORMAT " exchange(s) answered.\n",
+                __atomic_load_n(&cs->exchanges, __ATOMIC_RELAXED));
+        return;
+    }
+    g_print("[INFO] Execution Manager: clock sync %s, offset %ld ns, drift %.3f ppm, delay %ld ns, error %ld ns (worst %ld ns), "
+            "%" G_GUINT64_FORMAT " exchange(s), %" G_GUINT64_FORMAT " lost.\n",
+            clock_sync_is_locked(cs) ? "locked" : "not locked", (long)offset_ns, (gdouble)drift_ppb / 1000.0,
+            (long)__atomic_load_n(&cs->last_delay_ns, __ATOMIC_RELAXED), (long)__atomic_load_n(&cs->last_error_ns, __ATOMIC_RELAXED),
+            (long)__atomic_load_n(&cs->max_error_ns, __ATOMIC_RELAXED),
+            __atomic_load_n(&cs->exchanges, __ATOMIC_RELAXED), __atomic_load_n(&cs->lost, __ATOMIC_RELAXED));
+}
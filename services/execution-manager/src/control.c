@@ -0,0 +1,345 @@
+#include "control.h"
+#include "em_time.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/eventfd.h>
+
+#define CONTROL_CLIENT_IDLE_MS 5000     // Idle clients are dropped, the server handles one at a time
+
+/* -----------------Helper Functions ----------------- */
+
+static void control_request_clear(control_request_t *req) {
+    g_free(req->schedule);
+    g_free(req->name);
+    g_free(req->reply);
+}
+
+static gboolean control_parse_int(const gchar *str, gint64 min, gint64 max, gint64 *value) {
+    gchar *end = NULL;
+    errno = 0;
+    gint64 v = g_ascii_strtoll(str, &end, 10);
+    if (errno != 0 || end == str || *end != '\0' || v < min || v > max) return FALSE;
+    *value = v;
+    return TRUE;
+}
+
+/* Offsets are given in ms (fractions allowed), the timeline stores ns */
+static gboolean control_parse_ms(const gchar *str, gint64 *ns) {
+    gchar *end = NULL;
+    gdouble ms = g_ascii_strtod(str, &end);
+    if (end == str || *end != '\0' || ms < 0 || ms > (gdouble)G_MAXINT64 / EM_NSEC_PER_MSEC) return FALSE;
+    *ns = (gint64)(ms * EM_NSEC_PER_MSEC + 0.5);
+    return TRUE;
+}
+
+static gboolean control_parse_policy(const gchar *str, gint *policy) {
+    if (g_strcmp0(str, "fifo") == 0) *policy = SCHED_FIFO;
+    else if (g_strcmp0(str, "rr") == 0) *policy = SCHED_RR;
+    else if (g_strcmp0(str, "other") == 0) *policy = SCHED_OTHER;
+    else return FALSE;
+    return TRUE;
+}
+
+/* Window, priority, cpu and budget share the same checks in add and modify */
+static const gchar *control_parse_window(control_request_t *req, gchar **argv) {
+    gint64 priority, cpu;
+    if (!control_parse_ms(argv[0], &req->start_ns) || !control_parse_ms(argv[1], &req->end_ns)) return "bad window";
+    if (req->end_ns <= req->start_ns) return "deadline before release";
+    if (!control_parse_int(argv[2], 0, 99, &priority)) return "bad priority";
+    if (!control_parse_int(argv[3], 0, G_MAXINT16, &cpu)) return "bad cpu";
+    if (!control_parse_int(argv[4], 1, G_MAXINT64 / 1000, &req->wcet_us)) return "bad wcet";
+    req->priority = (gint8)priority;
+    req->cpu_affinity = (gint)cpu;
+    return NULL;
+}
+
+/*
+ * add    <schedule> <id> <name> <function> <fifo|rr|other> <start_ms> <end_ms> <priority> <cpu> <wcet_us> <input task id>
+ * remove <schedule> <id>
+ * modify <schedule> <id> <start_ms> <end_ms> <priority> <cpu> <wcet_us>
+ * submit <schedule> <input task id> <function> <cpu>
+ * Returns the reason of a syntax error, NULL if the request is ready for the dispatcher.
+ */
+static const gchar *control_parse(control_t *ctl, const gchar *line, control_request_t *req) {
+    gchar **tokens = g_strsplit_set(line, " \t", -1);
+    gchar *argv[16] = { NULL };
+    guint argc = 0;
+    for (gchar **t = tokens; *t && argc < G_N_ELEMENTS(argv); t++) {
+        if (**t) argv[argc++] = *t;
+    }
+
+    const gchar *error = NULL;
+    gint64 id, input_task;
+    req->input_task = -1;
+    if (argc < 3) {
+        error = "usage: add|remove|modify|submit <schedule> <id> ...";
+    } else if (!control_parse_int(argv[2], 0, G_MAXUINT16 - 1, &id)) {
+        error = "bad task id";
+    } else if (g_strcmp0(argv[0], "add") == 0) {
+        req->cmd = CONTROL_CMD_ADD;
+        if (argc != 12) error = "usage: add <schedule> <id> <name> <function> <policy> <start_ms> <end_ms> <priority> <cpu> <wcet_us> <input id>";
+        else if (!(req->task_exec = g_hash_table_lookup(ctl->tasks, argv[4]))) error = "unknown task function";
+        else if (!control_parse_policy(argv[5], &req->policy)) error = "bad policy";
+        else if (!control_parse_int(argv[11], 0, G_MAXUINT16 - 1, &input_task)) error = "bad input id";
+        else error = control_parse_window(req, &argv[6]);
+        if (!error) {
+            req->name = g_strdup(argv[3]);
+            req->input_task = (gint)input_task;
+        }
+    } else if (g_strcmp0(argv[0], "remove") == 0) {
+        req->cmd = CONTROL_CMD_REMOVE;
+        if (argc != 3) error = "usage: remove <schedule> <id>";
+    } else if (g_strcmp0(argv[0], "modify") == 0) {
+        req->cmd = CONTROL_CMD_MODIFY;
+        if (argc != 8) error = "usage: modify <schedule> <id> <start_ms> <end_ms> <priority> <cpu> <wcet_us>";
+        else error = control_parse_window(req, &argv[3]);
+    } else if (g_strcmp0(argv[0], "submit") == 0) {
+        gint64 cpu;
+        req->cmd = CONTROL_CMD_SUBMIT;
+        if (argc != 5) error = "usage: submit <schedule> <input id> <function> <cpu>";
+        else if (!(req->task_exec = g_hash_table_lookup(ctl->tasks, argv[3]))) error = "unknown task function";
+        else if (!control_parse_int(argv[4], 0, G_MAXINT16, &cpu)) error = "bad cpu";
+        else req->cpu_affinity = (gint)cpu;
+    } else {
+        error = "unknown command";
+    }
+
+    if (!error) {
+        req->schedule = g_strdup(argv[1]);
+        req->task_id = (guint16)id;
+    }
+    g_strfreev(tokens);
+    return error;
+}
+
+/* Hands the request to the dispatcher and waits for its reply */
+static void control_submit(control_t *ctl, control_request_t *req) {
+    g_mutex_lock(&ctl->lock);
+    if (!ctl->live) {
+        g_mutex_unlock(&ctl->lock);
+        control_reply(ctl, req, FALSE, "no schedule running");
+        return;
+    }
+
+    g_queue_push_tail(ctl->pending, req);
+    guint64 one = 1;
+    if (write(ctl->wakeup_fd, &one, sizeof(one)) < 0) {
+        /* Counter saturated: the dispatcher is already woken up */
+    }
+    while (!req->done) g_cond_wait(&ctl->replied, &ctl->lock);
+    g_mutex_unlock(&ctl->lock);
+}
+
+static void control_write_line(gint fd, const gchar *text) {
+    GString *out = g_string_new(text);
+    g_string_append_c(out, '\n');
+    gsize written = 0;
+    while (written < out->len) {
+        gssize n = write(fd, out->str + written, out->len - written);
+        if (n <= 0) break;
+        written += n;
+    }
+    g_string_free(out, TRUE);
+}
+
+static void control_handle_line(control_t *ctl, gint fd, const gchar *line) {
+    control_request_t req = { 0 };
+    const gchar *error = control_parse(ctl, line, &req);
+    if (error) control_reply(ctl, &req, FALSE, "%s", error);
+    else control_submit(ctl, &req);
+
+    control_write_line(fd, req.reply);
+    control_request_clear(&req);
+}
+
+/* Reads the commands of one client, line by line, until it hangs up or stays idle */
+static void control_handle_client(control_t *ctl, gint fd) {
+    GString *buffer = g_string_new(NULL);
+    gchar chunk[256];
+
+    while (!g_atomic_int_get(&ctl->stop)) {
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        if (poll(&pfd, 1, CONTROL_CLIENT_IDLE_MS) <= 0) break;
+
+        gssize n = read(fd, chunk, sizeof(chunk));
+        if (n <= 0) break;
+        g_string_append_len(buffer, chunk, n);
+
+        gchar *nl;
+        while ((nl = memchr(buffer->str, '\n', buffer->len)) != NULL) {
+            *nl = '\0';
+            gchar *line = g_strstrip(buffer->str);
+            if (*line) control_handle_line(ctl, fd, line);
+            g_string_erase(buffer, 0, nl - buffer->str + 1);
+        }
+        if (buffer->len > CONTROL_MAX_LINE) {
+            control_write_line(fd, "REJECTED line too long");
+            break;
+        }
+    }
+    g_string_free(buffer, TRUE);
+}
+
+static gpointer control_server_func(gpointer data) {
+    control_t *ctl = (control_t *)data;
+
+    while (!g_atomic_int_get(&ctl->stop)) {
+        struct pollfd pfd = { .fd = ctl->listen_fd, .events = POLLIN };
+        gint rc = poll(&pfd, 1, 200);
+        if (rc <= 0) continue;
+
+        gint client = accept(ctl->listen_fd, NULL, NULL);
+        if (client < 0) continue;
+        control_handle_client(ctl, client);
+        close(client);
+    }
+    return NULL;
+}
+
+
+
+/* ----------------- Control Constructor/Destructor ----------------- */
+
+control_t* control_new(void) {
+    control_t *ctl = g_new0(control_t, 1);
+    ctl->listen_fd = -1;
+    ctl->wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (ctl->wakeup_fd < 0) {
+        g_printerr("[ERROR] Execution Manager: control eventfd failed (%s)\n", g_strerror(errno));
+        g_free(ctl);
+        return NULL;
+    }
+    ctl->tasks = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    ctl->pending = g_queue_new();
+    g_mutex_init(&ctl->lock);
+    g_cond_init(&ctl->replied);
+    return ctl;
+}
+
+void control_free(control_t *ctl) {
+    if (!ctl) return;
+
+    control_set_live(ctl, FALSE);
+    control_stop_server(ctl);
+    g_cond_clear(&ctl->replied);
+    g_mutex_clear(&ctl->lock);
+    g_queue_free(ctl->pending);
+    g_hash_table_destroy(ctl->tasks);
+    close(ctl->wakeup_fd);
+    g_free(ctl);
+}
+
+
+/* ----------------- Control Endpoint ----------------- */
+
+/* Task functions the clients can name, registered before the server starts */
+void control_register_task(control_t *ctl, const gchar *name, GThreadFunc task_exec) {
+    g_return_if_fail(ctl != NULL && name != NULL && task_exec != NULL);
+    g_return_if_fail(ctl->server_thread == NULL);
+
+    g_hash_table_replace(ctl->tasks, g_strdup(name), task_exec);
+}
+
+gboolean control_start_server(control_t *ctl, const gchar *socket_path) {
+    g_return_val_if_fail(ctl != NULL, FALSE);
+    g_return_val_if_fail(socket_path != NULL, FALSE);
+    g_return_val_if_fail(ctl->server_thread == NULL, FALSE);
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        g_printerr("[ERROR] Execution Manager: control socket path too long: %s\n", socket_path);
+        return FALSE;
+    }
+    g_strlcpy(addr.sun_path, socket_path, sizeof(addr.sun_path));
+
+    gint fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        g_printerr("[ERROR] Execution Manager: control socket failed (%s)\n", g_strerror(errno));
+        return FALSE;
+    }
+
+    unlink(socket_path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+        g_printerr("[ERROR] Execution Manager: cannot listen on %s (%s)\n", socket_path, g_strerror(errno));
+        close(fd);
+        return FALSE;
+    }
+
+    ctl->listen_fd = fd;
+    ctl->socket_path = g_strdup(socket_path);
+    g_atomic_int_set(&ctl->stop, 0);
+    ctl->server_thread = g_thread_new("em-control", control_server_func, ctl);
+
+    g_print("[INFO] Execution Manager: control socket listening on %s\n", socket_path);
+    return TRUE;
+}
+
+void control_stop_server(control_t *ctl) {
+    if (!ctl || !ctl->server_thread) return;
+
+    g_atomic_int_set(&ctl->stop, 1);
+    g_thread_join(ctl->server_thread);
+    ctl->server_thread = NULL;
+
+    close(ctl->listen_fd);
+    ctl->listen_fd = -1;
+    unlink(ctl->socket_path);
+    g_free(ctl->socket_path);
+    ctl->socket_path = NULL;
+}
+
+
+/* ----------------- Dispatcher side ----------------- */
+
+/* Requests are only taken while a run is live, the ones left at its end are rejected */
+void control_set_live(control_t *ctl, gboolean live) {
+    g_return_if_fail(ctl != NULL);
+
+    g_mutex_lock(&ctl->lock);
+    ctl->live = live;
+    GQueue dropped = G_QUEUE_INIT;
+    if (!live) {
+        while (!g_queue_is_empty(ctl->pending)) g_queue_push_tail(&dropped, g_queue_pop_head(ctl->pending));
+    }
+    g_mutex_unlock(&ctl->lock);
+
+    control_request_t *req;
+    while ((req = g_queue_pop_head(&dropped)) != NULL) control_reply(ctl, req, FALSE, "no schedule running");
+}
+
+control_request_t* control_next_request(control_t *ctl) {
+    g_return_val_if_fail(ctl != NULL, NULL);
+
+    g_mutex_lock(&ctl->lock);
+    control_request_t *req = g_queue_pop_head(ctl->pending);
+    g_mutex_unlock(&ctl->lock);
+    return req;
+}
+
+void control_reply(control_t *ctl, control_request_t *req, gboolean accepted, const gchar *format, ...) {
+    g_return_if_fail(ctl != NULL && req != NULL);
+
+    va_list args;
+    va_start(args, format);
+    gchar *detail = g_strdup_vprintf(format, args);
+    va_end(args);
+
+    __atomic_fetch_add(accepted ? &ctl->accepted : &ctl->rejected, 1, __ATOMIC_RELAXED);
+    g_print("[INFO] Execution Manager: control %s: %s %s\n", accepted ? "accepted" : "rejected", req->schedule ? req->schedule : "-", detail);
+
+    g_mutex_lock(&ctl->lock);
+    req->reply = g_strdup_printf("%s %s", accepted ? "ACCEPTED" : "REJECTED", detail);
+    req->done = TRUE;
+    g_cond_broadcast(&ctl->replied);
+    g_mutex_unlock(&ctl->lock);
+    g_free(detail);
+}
@@ -0,0 +1,214 @@
+#include "cpu_budget.h"
+#include "resource.h"
+#include "em_time.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+static __thread cpu_budget_job_t current_job;
+
+/* -----------------Helper Functions ----------------- */
+
+static void budget_atomic_max(gint64 *target, gint64 value) {
+    gint64 old = __atomic_load_n(target, __ATOMIC_RELAXED);
+    while (value > old && !__atomic_compare_exchange_n(target, &old, value, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        /* old reloaded by the failed exchange */
+    }
+}
+
+/* Demotion to SCHED_OTHER, called from the signal handler or at the release of the last resource */
+static void budget_demote(cpu_budget_job_t *job) {
+    if (job->demoted) return;
+
+    /* sched_setscheduler(0) is the raw syscall on the calling thread, async-signal-safe in practice */
+    struct sched_param param = { .sched_priority = 0 };
+    if (sched_setscheduler(0, SCHED_OTHER, &param) == 0) job->demoted = 1;
+}
+
+/* Only flags and the demotion: the abort is taken outside the handler, at a checkpoint */
+static void budget_signal_handler(int sig, siginfo_t *info, void *ucontext) {
+    (void)sig; (void)ucontext;
+    cpu_budget_job_t *job = &current_job;
+    if (!job->armed || job->expired || info->si_code != SI_TIMER || info->si_value.sival_int != job->generation) return;
+
+    gint saved_errno = errno;
+    job->expired = 1;
+    if (job->action != TASK_BUDGET_NOTIFY) {
+        if (resource_held_count() > 0) job->deferred = 1;
+        else budget_demote(job);
+    }
+    if (job->action == TASK_BUDGET_ABORT) job->abort_pending = 1;
+    errno = saved_errno;
+}
+
+
+/* ----------------- CPU Budget Setup ----------------- */
+
+gboolean cpu_budget_init(void) {
+    static gsize installed = 0;     // 1 = handler installed, 2 = failed
+    if (g_once_init_enter(&installed)) {
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_sigaction = budget_signal_handler;
+        sa.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        gboolean ok = (sigaction(CPU_BUDGET_SIGNAL, &sa, NULL) == 0);
+        if (!ok) g_printerr("[ERROR] Execution Manager: CPU budget signal handler not installed (%s)\n", g_strerror(errno));
+        g_once_init_leave(&installed, ok ? 1 : 2);
+    }
+    return installed == 1;
+}
+
+
+/* ----------------- CPU Budget Enforcement ----------------- */
+
+/* Arms the budget of the next job of the calling thread (timers are process wide: one per job, deleted by disarm) */
+gboolean cpu_budget_arm(gint64 budget_ns, task_budget_action_t action) {
+    g_return_val_if_fail(budget_ns > 0, FALSE);
+    cpu_budget_job_t *job = &current_job;
+    if (job->armed) return FALSE;
+
+    /* 1. Timer on the CPU clock of the worker, its signal goes to the worker itself */
+    job->generation++;
+    struct sigevent sev;
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_value.sival_int = job->generation;
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = CPU_BUDGET_SIGNAL;
+    sev.sigev_notify_thread_id = (pid_t)syscall(SYS_gettid);
+    if (timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &job->timer) != 0) {
+        g_printerr("[WARNING] Execution Manager: no CPU time timer, budget not enforced (%s)\n", g_strerror(errno));
+        return FALSE;
+    }
+
+    /* 2. Scheduling restored by disarm after a demotion (persistent workers) */
+    job->action = (guint8)action;
+    job->demoted = 0;
+    job->expired = 0;
+    job->deferred = 0;
+    job->abort_pending = 0;
+    if (action >= TASK_BUDGET_DEMOTE) {
+        job->policy = sched_getscheduler(0);
+        sched_getparam(0, &job->param);
+    }
+
+    /* 3. One shot timer, relative to the CPU time already used by the thread */
+    struct itimerspec its = { .it_interval = { 0, 0 }, .it_value = em_time_to_timespec(budget_ns) };
+    job->start_cpu_ns = em_time_now_ns(CLOCK_THREAD_CPUTIME_ID);
+    job->armed = 1;
+    if (timer_settime(job->timer, 0, &its, NULL) != 0) {
+        job->armed = 0;
+        timer_delete(job->timer);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* TRUE if the job exhausted its budget, the outcome (optional) tells what the enforcement did */
+gboolean cpu_budget_disarm(cpu_budget_outcome_t *outcome) {
+    cpu_budget_job_t *job = &current_job;
+    if (outcome) memset(outcome, 0, sizeof(cpu_budget_outcome_t));
+    if (!job->armed) return FALSE;
+
+    job->armed = 0;     // A signal still pending is ignored by the handler
+    timer_delete(job->timer);
+    if (outcome) {
+        outcome->cpu_ns = em_time_now_ns(CLOCK_THREAD_CPUTIME_ID) - job->start_cpu_ns;
+        outcome->exhausted = job->expired != 0;
+        outcome->demoted = job->demoted != 0;
+        outcome->abort_missed = job->abort_pending != 0;
+    }
+
+    if (job->demoted) {
+        sched_setscheduler(0, job->policy, &job->param);
+        job->demoted = 0;
+    }
+    return job->expired != 0;
+}
+
+/* Cancels the calling job if its budget asked for an abort and it holds no resource; does not return then */
+void cpu_budget_checkpoint(void) {
+    cpu_budget_job_t *job = &current_job;
+    if (!job->armed || !job->abort_pending || resource_held_count() > 0) return;
+
+    /* Outside the signal handler: the cancellation request is acted on at once */
+    pthread_cancel(pthread_self());
+    pthread_testcancel();
+}
+
+/* Called by resource_unlock when the worker releases its last resource: demotion held back, then a checkpoint */
+void cpu_budget_resources_released(void) {
+    cpu_budget_job_t *job = &current_job;
+    if (!job->armed) return;
+
+    if (job->deferred) {
+        job->deferred = 0;
+        budget_demote(job);
+    }
+    cpu_budget_checkpoint();
+}
+
+
+/* ----------------- CPU Budget Records ----------------- */
+
+cpu_budget_stats_t* cpu_budget_stats_new(void) {
+    return g_new0(cpu_budget_stats_t, 1);
+}
+
+void cpu_budget_stats_free(cpu_budget_stats_t *stats) {
+    g_free(stats);
+}
+
+void cpu_budget_record(cpu_budget_stats_t *stats, guint16 task_id, gint64 budget_ns, const cpu_budget_outcome_t *outcome) {
+    if (!stats || !outcome || task_id >= CPU_BUDGET_MAX_TASKS) return;
+
+    cpu_budget_task_t *t = &stats->tasks[task_id];
+    __atomic_fetch_add(&t->jobs, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&t->budget_ns, budget_ns, __ATOMIC_RELAXED);
+    budget_atomic_max(&t->max_cpu_ns, outcome->cpu_ns);
+    if (!outcome->exhausted) return;
+
+    __atomic_fetch_add(&t->overruns, 1, __ATOMIC_RELAXED);
+    if (outcome->demoted) __atomic_fetch_add(&t->demotions, 1, __ATOMIC_RELAXED);
+    if (outcome->abort_missed) __atomic_fetch_add(&t->aborts_missed, 1, __ATOMIC_RELAXED);
+}
+
+/* A cancelled job never reaches cpu_budget_record: its cleanup handler records it here */
+void cpu_budget_record_abort(cpu_budget_stats_t *stats, guint16 task_id, gint64 budget_ns, const cpu_budget_outcome_t *outcome) {
+    if (!outcome) return;
+
+    cpu_budget_outcome_t taken = *outcome;
+    taken.exhausted = TRUE;
+    taken.abort_missed = FALSE;
+    cpu_budget_record(stats, task_id, budget_ns, &taken);
+    if (stats && task_id < CPU_BUDGET_MAX_TASKS) __atomic_fetch_add(&stats->tasks[task_id].aborts, 1, __ATOMIC_RELAXED);
+}
+
+void cpu_budget_stats_print(cpu_budget_stats_t *stats) {
+    if (!stats) return;
+
+    gboolean header = FALSE;
+    for (guint id = 0; id < CPU_BUDGET_MAX_TASKS; id++) {
+        cpu_budget_task_t *t = &stats->tasks[id];
+        guint64 jobs = __atomic_load_n(&t->jobs, __ATOMIC_RELAXED);
+        if (jobs == 0) continue;
+        if (!header) {
+            g_print("\n=============== CPU Budgets ===============\n");
+            header = TRUE;
+        }
+        g_print("Task %u: budget %ld us, %" G_GUINT64_FORMAT " job(s), %" G_GUINT64_FORMAT " overrun(s), %" G_GUINT64_FORMAT
+                " demotion(s), %" G_GUINT64_FORMAT " abort(s), %" G_GUINT64_FORMAT " missed abort(s), worst %ld us\n",
+                id, (long)em_time_ns_to_us(__atomic_load_n(&t->budget_ns, __ATOMIC_RELAXED)), jobs,
+                __atomic_load_n(&t->overruns, __ATOMIC_RELAXED), __atomic_load_n(&t->demotions, __ATOMIC_RELAXED),
+                __atomic_load_n(&t->aborts, __ATOMIC_RELAXED), __atomic_load_n(&t->aborts_missed, __ATOMIC_RELAXED), (long)em_time_ns_to_us(__atomic_load_n(&t->max_cpu_ns, __ATOMIC_RELAXED)));
+    }
+    if (header) g_print("===========================================\n");
+}
@@ -0,0 +1,373 @@
+#define _GNU_SOURCE
+#include "cyclic_executive.h"
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+
+#define CE_START_LEAD_US 10000      // Time left to create the core threads before the first frame
+
+/* -----------------Helper Functions ----------------- */
+
+static void ce_core_free(gpointer data) {
+    ce_core_t *core = (ce_core_t *)data;
+    if (core) {
+        g_array_free(core->frames, TRUE);
+        g_array_free(core->jobs, TRUE);
+        g_free(core);
+    }
+}
+
+static ce_core_t *ce_get_core(GHashTable *cores, ce_table_t *table, gint cpu) {
+    ce_core_t *core = g_hash_table_lookup(cores, GINT_TO_POINTER(cpu));
+    if (!core) {
+        core = g_new0(ce_core_t, 1);
+        core->cpu = cpu;
+        core->frames = g_array_new(FALSE, FALSE, sizeof(ce_frame_t));
+        core->jobs = g_array_new(FALSE, FALSE, sizeof(ce_job_t));
+        core->table = table;
+        g_hash_table_insert(cores, GINT_TO_POINTER(cpu), core);
+        g_ptr_array_add(table->cores, core);
+    }
+    return core;
+}
+
+/* The k-th activation of a task is paired with its k-th expiration (queues of timeline entries) */
+static GHashTable *ce_collect_deadlines(schedule_t *sched) {
+    GHashTable *deadlines = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)g_queue_free);
+    for (GList *l = sched->schedule_end_info->head; l != NULL; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        for (guint i = 0; i < entry->items->len; i++) {
+            expiration_data_t *exp = timeline_entry_expiration(entry, i);
+            GQueue *queue = g_hash_table_lookup(deadlines, GUINT_TO_POINTER(exp->task_id));
+            if (!queue) {
+                queue = g_queue_new();
+                g_hash_table_insert(deadlines, GUINT_TO_POINTER(exp->task_id), queue);
+            }
+            g_queue_push_tail(queue, entry);
+        }
+    }
+    return deadlines;
+}
+
+/* Append a job to the open frame of the core, higher priorities first */
+static void ce_frame_add_job(ce_core_t *core, ce_frame_t *frame, const ce_job_t *job) {
+    guint pos = frame->first_job + frame->n_jobs;
+    while (pos > frame->first_job && g_array_index(core->jobs, ce_job_t, pos - 1).priority < job->priority) pos--;
+    g_array_insert_vals(core->jobs, pos, job, 1);
+    frame->n_jobs++;
+}
+
+static void ce_sleep_until(clockid_t clock, gint64 target_ns) {
+    struct timespec ts = em_time_to_timespec(target_ns);
+    while (clock_nanosleep(clock, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        /* Restart after signals */
+    }
+}
+
+/* Core thread: sleep to each frame boundary and call the jobs in place */
+static void *ce_core_thread(void *data) {
+    ce_core_t *core = (ce_core_t *)data;
+    ce_table_t *table = core->table;
+    execution_manager_t *em = table->em;
+    clockid_t clock = table->sched->schedule_clock;
+
+    for (guint c = 0; c < table->cycles; c++) {
+        /* Coordinated runs map every cycle through the latest offset estimate, so drift is corrected each hyperperiod */
+        gint64 cycle_ns = table->sync_zero_ns < 0
+            ? em_time_add_sat(table->time_zero_ns, (gint64)c * table->hyperperiod_ns)
+            : clock_sync_to_local_ns(em->sync, em_time_add_sat(table->sync_zero_ns, (gint64)c * table->hyperperiod_ns));
+
+        for (guint f = 0; f < core->frames->len; f++) {
+            ce_frame_t *frame = &g_array_index(core->frames, ce_frame_t, f);
+            gint64 boundary_ns = em_time_add_sat(cycle_ns, frame->start_ns);
+
+            /* 1. Wait for the frame boundary on the schedule clock (an overrun frame starts the next one late) */
+            ce_sleep_until(clock, boundary_ns);
+            gint64 begin_ns = em_time_now_ns(clock);
+
+            /* 2. Run the jobs of the frame in order */
+            for (guint j = frame->first_job; j < frame->first_job + frame->n_jobs; j++) {
+                ce_job_t *job = &g_array_index(core->jobs, ce_job_t, j);
+                gint64 start_ns = em_time_now_ns(clock);
+                gint64 release_latency_us = em_time_ns_to_us(start_ns - boundary_ns);
+
+                metrics_inc_activation(em->metrics, core->cpu);
+                metrics_observe_release_latency(em->metrics, core->cpu, release_latency_us);
+                trace_record(em->trace, TRACE_EVENT_START, job->task_id, core->cpu, release_latency_us);
+
+                gint64 cpu_start_ns = em->load ? em_time_now_ns(CLOCK_THREAD_CPUTIME_ID) : 0;
+                resource_set_current_task(job->task_id);
+                g_free(job->task_exec(input_pool_job_input(job->input_data, job->input_size, job->input_mutable)));
+
+                gint64 end_ns = em_time_now_ns(clock);
+                if (em->load) load_monitor_add_job(em->load, job->task_id, core->cpu, em_time_now_ns(CLOCK_THREAD_CPUTIME_ID) - cpu_start_ns);
+                trace_record(em->trace, TRACE_EVENT_FINISH, job->task_id, core->cpu, 0);
+                metrics_inc_completion(em->metrics, core->cpu, em_time_ns_to_us(end_ns - start_ns));
+                journal_append(em->journal, JOURNAL_EVENT_COMPLETE, table->journal_id, job->task_id, core->cpu,
+                               table->cycles - c - 1, em_time_ns_to_us(end_ns - start_ns), "{}");
+                job->completions++;
+
+                if (end_ns > cycle_ns + job->deadline_ns) {
+                    gint64 lateness_us = em_time_ns_to_us(end_ns - cycle_ns - job->deadline_ns);
+                    job->misses++;
+                    metrics_inc_deadline_miss(em->metrics, core->cpu);
+                    trace_record(em->trace, TRACE_EVENT_DEADLINE, job->task_id, core->cpu, lateness_us);
+                    journal_append(em->journal, JOURNAL_EVENT_MISS, table->journal_id, job->task_id, core->cpu, table->cycles - c - 1, lateness_us, NULL);
+                }
+            }
+
+            /* 3. Frame overrun: the jobs crossed the next boundary of the core */
+            gint64 done_ns = em_time_now_ns(clock);
+            frame->max_elapsed_ns = MAX(frame->max_elapsed_ns, done_ns - begin_ns);
+            if (done_ns > cycle_ns + frame->end_ns) frame->overruns++;
+        }
+    }
+    return NULL;
+}
+
+static gint ce_start_core(ce_core_t *core, gint priority) {
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core->cpu, &set);
+    pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &set);
+
+    struct sched_param param = { .sched_priority = priority };
+    pthread_attr_setschedpolicy(&attr, priority > 0 ? SCHED_FIFO : SCHED_OTHER);
+    pthread_attr_setschedparam(&attr, &param);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+
+    gint rc = pthread_create(&core->thread, &attr, ce_core_thread, core);
+    pthread_attr_destroy(&attr);
+    return rc;
+}
+
+
+/* ----------------- Cyclic Executive Constructor/Destructor ----------------- */
+
+ce_table_t* ce_table_compile(schedule_t *sched, gint priority) {
+    g_return_val_if_fail(sched != NULL, NULL);
+
+    if (sched->schedule_duration_ns <= 0 || g_queue_is_empty(sched->schedule_start_info)) {
+        g_printerr("[ERROR] Execution Manager: schedule %s is empty, no frame table.\n", sched->schedule_name->str);
+        return NULL;
+    }
+
+    ce_table_t *table = g_new0(ce_table_t, 1);
+    table->sched = sched;
+    table->hyperperiod_ns = sched->schedule_duration_ns;
+    table->cores = g_ptr_array_new_with_free_func(ce_core_free);
+    table->priority = CLAMP(priority, 0, sched_get_priority_max(SCHED_FIFO));
+
+    GHashTable *cores = g_hash_table_new(g_direct_hash, g_direct_equal);
+    GHashTable *deadlines = ce_collect_deadlines(sched);
+
+    /* Task cpu_affinity is the physical core here: inputs are placed before the jobs copy their pointers */
+    schedule_place_inputs(sched, NULL, 0);
+    schedule_place_results(sched, NULL, 0);
+    schedule_prepare_resources(sched);
+
+    /* 1. One frame per (core, release time), jobs stored contiguously per core */
+    for (GList *l = sched->schedule_start_info->head; l != NULL; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        gint64 start_ns = entry->timestamp_ns;
+
+        for (guint i = 0; i < entry->items->len; i++) {
+            activation_data_t *act = timeline_entry_activation(entry, i);
+            if (!act->task_exec) {
+                g_printerr("[WARNING] Execution Manager: Task %u has no task_exec, left out of the frame table.\n", act->task_id);
+                continue;
+            }
+
+            ce_core_t *core = ce_get_core(cores, table, MAX(act->cpu_affinity, 0));
+            ce_frame_t *frame = core->frames->len
+                ? &g_array_index(core->frames, ce_frame_t, core->frames->len - 1) : NULL;
+            if (!frame || frame->start_ns != start_ns) {
+                if (frame) frame->end_ns = start_ns;
+                ce_frame_t new_frame = { 0 };
+                new_frame.start_ns = start_ns;
+                new_frame.first_job = core->jobs->len;
+                g_array_append_val(core->frames, new_frame);
+                frame = &g_array_index(core->frames, ce_frame_t, core->frames->len - 1);
+            }
+
+            GQueue *queue = g_hash_table_lookup(deadlines, GUINT_TO_POINTER(act->task_id));
+            ce_job_t job = { 0 };
+            job.task_exec = act->task_exec;
+            job.input_data = act->input_data;
+            job.input_size = act->input_size;
+            job.input_mutable = (act->input_flags == TASK_INPUT_MUTABLE);
+            job.task_id = act->task_id;
+            job.priority = act->priority;
+            job.deadline_ns = (queue && !g_queue_is_empty(queue))
+                ? ((timeline_entry_t *)g_queue_pop_head(queue))->timestamp_ns : table->hyperperiod_ns;
+            ce_frame_add_job(core, frame, &job);
+        }
+    }
+
+    /* 2. The last frame of each core runs up to the end of the hyperperiod */
+    for (guint c = 0; c < table->cores->len; c++) {
+        ce_core_t *core = g_ptr_array_index(table->cores, c);
+        g_array_index(core->frames, ce_frame_t, core->frames->len - 1).end_ns = table->hyperperiod_ns;
+    }
+
+    g_hash_table_destroy(deadlines);
+    g_hash_table_destroy(cores);
+
+    if (table->cores->len == 0) {
+        ce_table_free(table);
+        return NULL;
+    }
+    return table;
+}
+
+void ce_table_free(ce_table_t *table) {
+    if (!table) return;
+
+    g_ptr_array_free(table->cores, TRUE);
+    g_free(table);
+}
+
+
+/* ----------------- Cyclic Executive Methods ----------------- */
+
+void ce_table_print(ce_table_t *table) {
+    if (!table) return;
+
+    g_print("\n=== FRAME TABLE: %s [hyperperiod %ld ns] ===\n", table->sched->schedule_name->str, (long)table->hyperperiod_ns);
+    for (guint c = 0; c < table->cores->len; c++) {
+        ce_core_t *core = g_ptr_array_index(table->cores, c);
+        g_print("--- CPU %d ---\n", core->cpu);
+        for (guint f = 0; f < core->frames->len; f++) {
+            ce_frame_t *frame = &g_array_index(core->frames, ce_frame_t, f);
+            g_print("[%11ld, %11ld) ns:", (long)frame->start_ns, (long)frame->end_ns);
+            for (guint j = frame->first_job; j < frame->first_job + frame->n_jobs; j++) {
+                ce_job_t *job = &g_array_index(core->jobs, ce_job_t, j);
+                g_print(" [Task %u, deadline %ld ns]", job->task_id, (long)job->deadline_ns);
+            }
+            g_print("\n");
+        }
+    }
+    g_print("==========================================\n");
+}
+
+gboolean em_run_cyclic(execution_manager_t *em, ce_table_t *table, guint cycles, ce_report_t *report) {
+    g_return_val_if_fail(em != NULL && table != NULL, FALSE);
+    g_return_val_if_fail(cycles > 0, FALSE);
+
+    ce_report_t local_report;
+    if (!report) report = &local_report;
+    memset(report, 0, sizeof(*report));
+
+    /* 1. Reset the per-run counters of the table */
+    for (guint c = 0; c < table->cores->len; c++) {
+        ce_core_t *core = g_ptr_array_index(table->cores, c);
+        for (guint f = 0; f < core->frames->len; f++) {
+            ce_frame_t *frame = &g_array_index(core->frames, ce_frame_t, f);
+            frame->overruns = 0;
+            frame->max_elapsed_ns = 0;
+        }
+        for (guint j = 0; j < core->jobs->len; j++) {
+            ce_job_t *job = &g_array_index(core->jobs, ce_job_t, j);
+            job->completions = 0;
+            job->misses = 0;
+        }
+    }
+
+    table->em = em;
+    table->cycles = cycles;
+    table->time_zero_ns = em_time_now_ns(table->sched->schedule_clock) + CE_START_LEAD_US * EM_NSEC_PER_USEC;
+    table->time_zero_us = g_get_monotonic_time() + CE_START_LEAD_US;
+    table->sync_zero_ns = -1;
+    if (em->sync && table->sched->schedule_clock == CLOCK_MONOTONIC) {
+        /* The group epoch is on the monotonic clocks, TAI schedules are already aligned by PTP */
+        table->sync_zero_ns = em_sync_time_zero_ns(em, CE_START_LEAD_US);
+        if (table->sync_zero_ns >= 0) {
+            table->time_zero_ns = clock_sync_to_local_ns(em->sync, table->sync_zero_ns);
+            table->time_zero_us = em_time_ns_to_us(table->time_zero_ns);
+        }
+    }
+    em->run_count++;
+    if (em->trace) trace_reset(em->trace, table->time_zero_us);
+    metrics_clear_schedule_info(em->metrics);
+    metrics_add_schedule_info(em->metrics, table->sched->schedule_name->str, table->sched->schedule_version->str);
+    if (em->journal) {
+        table->journal_id = journal_register_schedule(em->journal, table->sched->schedule_name->str, table->sched->schedule_version->str);
+        journal_append(em->journal, JOURNAL_EVENT_RUN_START, table->journal_id, 0, -1, cycles,
+                       g_get_real_time() + (table->time_zero_us - g_get_monotonic_time()), NULL);
+    }
+
+    /* Every job of the table is released once per hyperperiod, its budget is learnt from the first runs */
+    if (em->load) {
+        load_monitor_plan_reset(em->load, em->metrics, em->trace);
+        for (guint c = 0; c < table->cores->len; c++) {
+            ce_core_t *core = g_ptr_array_index(table->cores, c);
+            for (guint j = 0; j < core->jobs->len; j++) {
+                ce_job_t *job = &g_array_index(core->jobs, ce_job_t, j);
+                load_monitor_plan_task(em->load, job->task_id, core->cpu, (gdouble)EM_NSEC_PER_SEC / table->hyperperiod_ns, 0);
+            }
+        }
+    }
+
+    /* 2. One pinned thread per core */
+    guint started = 0;
+    for (; started < table->cores->len; started++) {
+        ce_core_t *core = g_ptr_array_index(table->cores, started);
+        gint rc = ce_start_core(core, table->priority);
+        if (rc == EPERM && table->priority > 0) {
+            g_printerr("[WARNING] Execution Manager: no permission for SCHED_FIFO, CPU %d runs its frames as SCHED_OTHER.\n", core->cpu);
+            rc = ce_start_core(core, 0);
+        }
+        if (rc) {
+            g_printerr("[ERROR] Execution Manager: frame thread of CPU %d not started (%s)\n", core->cpu, g_strerror(rc));
+            break;
+        }
+    }
+    g_print("[INFO] Execution Manager: cyclic executive started on %u core(s) for %u hyperperiod(s).\n", started, cycles);
+
+    for (guint c = 0; c < started; c++) {
+        ce_core_t *core = g_ptr_array_index(table->cores, c);
+        pthread_join(core->thread, NULL);
+    }
+
+    /* 3. Collect the counters, results are published once the threads are gone */
+    for (guint c = 0; c < started; c++) {
+        ce_core_t *core = g_ptr_array_index(table->cores, c);
+        for (guint f = 0; f < core->frames->len; f++) {
+            ce_frame_t *frame = &g_array_index(core->frames, ce_frame_t, f);
+            report->frames_run += cycles;
+            report->frame_overruns += frame->overruns;
+            report->worst_frame_us = MAX(report->worst_frame_us, em_time_ns_to_us(frame->max_elapsed_ns));
+            if (frame->overruns > 0) {
+                g_printerr("[WARNING] Execution Manager: CPU %d frame at %ld ns overran %" G_GUINT64_FORMAT " time(s) (worst %ld ns for %ld ns).\n",
+                           core->cpu, (long)frame->start_ns, frame->overruns,
+                           (long)frame->max_elapsed_ns, (long)(frame->end_ns - frame->start_ns));
+            }
+        }
+        for (guint j = 0; j < core->jobs->len; j++) {
+            ce_job_t *job = &g_array_index(core->jobs, ce_job_t, j);
+            report->jobs_completed += job->completions;
+            report->deadline_misses += job->misses;
+            if (job->completions == 0) continue;
+            schedule_set_result(table->sched, job->task_id, "{}");
+            result_exporter_push(em->exporter, table->sched->schedule_name->str, job->task_id, "{}");
+        }
+    }
+
+    g_print("[INFO] Execution Manager: cyclic executive done, %" G_GUINT64_FORMAT " frames, %" G_GUINT64_FORMAT " overrun(s), %"
+            G_GUINT64_FORMAT " job(s), %" G_GUINT64_FORMAT " deadline miss(es), worst frame %ld us.\n",
+            report->frames_run, report->frame_overruns, report->jobs_completed, report->deadline_misses, (long)report->worst_frame_us);
+
+    if (em->load) {
+        load_monitor_print(em->load);
+        load_monitor_plan_reset(em->load, em->metrics, NULL);
+    }
+
+    journal_append(em->journal, JOURNAL_EVENT_RUN_END, table->journal_id, 0, -1, 0, report->deadline_misses == 0, NULL);
+    journal_sync(em->journal);
+    em_export_trace(em, table->sched, "cyclic");
+    return started == table->cores->len;
+}
@@ -0,0 +1,249 @@
+#define _GNU_SOURCE
+#include "deadline_timer.h"
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+/* -----------------Helper Functions ----------------- */
+
+static gint compare_entries(gconstpointer a, gconstpointer b) {
+    const deadline_timer_entry_t *ea = a, *eb = b;
+    return (ea->target_us < eb->target_us) ? -1 : (ea->target_us > eb->target_us) ? 1 : 0;
+}
+
+/* Arm the timerfd on an absolute monotonic time (g_get_monotonic_time clock) */
+static gboolean deadline_timer_arm(deadline_timer_t *dt, gint64 target_us) {
+    struct itimerspec its = { 0 };
+    target_us = MAX(target_us, 1);      // A zero it_value would disarm the timer
+    its.it_value.tv_sec = target_us / G_USEC_PER_SEC;
+    its.it_value.tv_nsec = (target_us % G_USEC_PER_SEC) * 1000;
+    return timerfd_settime(dt->timer_fd, TFD_TIMER_ABSTIME, &its, NULL) == 0;
+}
+
+/*
+ * Moves the entries inserted while running into the not yet fired part of the timeline: O(pending * log n).
+ * FALSE when nothing is left to fire: the timer is then closed to insertions under the same lock.
+ */
+static gboolean deadline_timer_merge_pending(deadline_timer_t *dt, guint next) {
+    g_mutex_lock(&dt->pending_lock);
+    for (guint i = 0; i < dt->pending->len; i++) {
+        deadline_timer_entry_t *entry = &g_array_index(dt->pending, deadline_timer_entry_t, i);
+
+        /* After the equal deadlines, like deadline_timer_add */
+        guint lo = next, hi = dt->entries->len;
+        while (lo < hi) {
+            guint mid = lo + (hi - lo) / 2;
+            if (g_array_index(dt->entries, deadline_timer_entry_t, mid).target_us <= entry->target_us) lo = mid + 1;
+            else hi = mid;
+        }
+        g_array_insert_val(dt->entries, lo, *entry);
+    }
+    g_array_set_size(dt->pending, 0);
+    gboolean left = next < dt->entries->len;
+    if (!left) dt->closed = TRUE;
+    g_mutex_unlock(&dt->pending_lock);
+    return left;
+}
+
+static void *deadline_timer_thread(void *data) {
+    deadline_timer_t *dt = (deadline_timer_t *)data;
+    guint next = 0;
+
+    while (TRUE) {
+        if (!deadline_timer_merge_pending(dt, next)) break;
+        deadline_timer_entry_t *entry = &g_array_index(dt->entries, deadline_timer_entry_t, next);
+
+        /* 1. Sleep until the earliest pending deadline, an insertion, or until the run is stopped */
+        guint64 count;
+        if (deadline_timer_arm(dt, entry->target_us)) {
+            struct pollfd pfd[3] = { { .fd = dt->timer_fd, .events = POLLIN }, { .fd = dt->stop_fd, .events = POLLIN },
+                                     { .fd = dt->wake_fd, .events = POLLIN } };
+            if (poll(pfd, 3, -1) > 0) {
+                if (pfd[1].revents & POLLIN) break;
+                if ((pfd[2].revents & POLLIN) && read(dt->wake_fd, &count, sizeof(count)) == sizeof(count)) {
+                    if (!(pfd[0].revents & POLLIN)) continue;   // Merged and re-armed at the top
+                }
+                if (read(dt->timer_fd, &count, sizeof(count)) < 0) {
+                    /* Spurious wake up, the deadline is checked below */
+                }
+            }
+        } else {
+            /* timerfd unusable: the deadlines are still honoured with an absolute sleep (insertions merged on wake up) */
+            struct timespec ts = { .tv_sec = entry->target_us / G_USEC_PER_SEC,
+                                   .tv_nsec = (entry->target_us % G_USEC_PER_SEC) * 1000 };
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+            if (read(dt->stop_fd, &count, sizeof(count)) == sizeof(count)) break;
+        }
+
+        /* 2. Fire every deadline reached, the equal timestamps of several schedules included */
+        gint64 now_us = g_get_monotonic_time();
+        while (next < dt->entries->len) {
+            entry = &g_array_index(dt->entries, deadline_timer_entry_t, next);
+            if (entry->target_us > now_us) break;
+
+            dt->max_lateness_us = MAX(dt->max_lateness_us, now_us - entry->target_us);
+            dt->fired++;
+            next++;
+            entry->func(entry->data);
+        }
+    }
+    return NULL;
+}
+
+
+/* ----------------- Deadline Timer Constructor/Destructor ----------------- */
+
+deadline_timer_t* deadline_timer_new(gint priority, gint cpu) {
+    gint fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (fd < 0) {
+        g_printerr("[ERROR] Execution Manager: timerfd_create failed (%s)\n", g_strerror(errno));
+        return NULL;
+    }
+    gint stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    gint wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (stop_fd < 0 || wake_fd < 0) {
+        g_printerr("[ERROR] Execution Manager: eventfd failed (%s)\n", g_strerror(errno));
+        if (stop_fd >= 0) close(stop_fd);
+        if (wake_fd >= 0) close(wake_fd);
+        close(fd);
+        return NULL;
+    }
+
+    deadline_timer_t *dt = g_new0(deadline_timer_t, 1);
+    dt->entries = g_array_new(FALSE, FALSE, sizeof(deadline_timer_entry_t));
+    dt->pending = g_array_new(FALSE, FALSE, sizeof(deadline_timer_entry_t));
+    g_mutex_init(&dt->pending_lock);
+    dt->timer_fd = fd;
+    dt->stop_fd = stop_fd;
+    dt->wake_fd = wake_fd;
+    dt->priority = CLAMP(priority, 0, sched_get_priority_max(SCHED_FIFO));
+    dt->cpu = cpu;
+    return dt;
+}
+
+void deadline_timer_free(deadline_timer_t *dt) {
+    if (!dt) return;
+
+    deadline_timer_stop(dt);
+    deadline_timer_join(dt);
+    for (guint i = 0; i < dt->entries->len; i++) {
+        deadline_timer_entry_t *entry = &g_array_index(dt->entries, deadline_timer_entry_t, i);
+        if (entry->destroy) entry->destroy(entry->data);
+    }
+    /* Inserted after the timing thread returned, never fired */
+    for (guint i = 0; i < dt->pending->len; i++) {
+        deadline_timer_entry_t *entry = &g_array_index(dt->pending, deadline_timer_entry_t, i);
+        if (entry->destroy) entry->destroy(entry->data);
+    }
+    close(dt->timer_fd);
+    close(dt->stop_fd);
+    close(dt->wake_fd);
+    g_mutex_clear(&dt->pending_lock);
+    g_array_free(dt->pending, TRUE);
+    g_array_free(dt->entries, TRUE);
+    g_free(dt);
+}
+
+
+/* ----------------- Deadline Timer Methods ----------------- */
+
+void deadline_timer_add(deadline_timer_t *dt, gint64 target_us, GSourceFunc func, gpointer data, GDestroyNotify destroy) {
+    g_return_if_fail(dt != NULL && func != NULL);
+    g_return_if_fail(!dt->running);
+
+    deadline_timer_entry_t entry = { target_us, func, data, destroy };
+    g_array_append_val(dt->entries, entry);
+}
+
+/* Thread safe insertion in a running timer, FALSE (nothing taken) when the timing thread is not running or done */
+gboolean deadline_timer_insert(deadline_timer_t *dt, gint64 target_us, GSourceFunc func, gpointer data, GDestroyNotify destroy) {
+    g_return_val_if_fail(dt != NULL && func != NULL, FALSE);
+    if (!dt->running) return FALSE;
+
+    deadline_timer_entry_t entry = { target_us, func, data, destroy };
+    g_mutex_lock(&dt->pending_lock);
+    gboolean closed = dt->closed;
+    if (!closed) g_array_append_val(dt->pending, entry);
+    g_mutex_unlock(&dt->pending_lock);
+    if (closed) return FALSE;
+
+    guint64 one = 1;
+    if (write(dt->wake_fd, &one, sizeof(one)) < 0) {
+        /* Counter saturated: a merge is already pending */
+    }
+    return TRUE;
+}
+
+gboolean deadline_timer_start(deadline_timer_t *dt) {
+    g_return_val_if_fail(dt != NULL, FALSE);
+    g_return_val_if_fail(!dt->running, FALSE);
+
+    /* Stable order: equal deadlines fire in the order they were added */
+    g_array_sort(dt->entries, compare_entries);
+    dt->max_lateness_us = 0;
+    dt->fired = 0;
+    dt->closed = FALSE;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+
+    if (dt->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(dt->cpu, &set);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &set);
+    }
+
+    /* The timing thread runs above every task (task priorities stay below the maximum) */
+    struct sched_param param = { .sched_priority = dt->priority };
+    pthread_attr_setschedpolicy(&attr, dt->priority > 0 ? SCHED_FIFO : SCHED_OTHER);
+    pthread_attr_setschedparam(&attr, &param);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+
+    gint rc = pthread_create(&dt->thread, &attr, deadline_timer_thread, dt);
+    if (rc == EPERM) {
+        /* No real-time privileges: still a dedicated thread, but best effort */
+        g_printerr("[WARNING] Execution Manager: no permission for a SCHED_FIFO deadline timer, using SCHED_OTHER.\n");
+        param.sched_priority = 0;
+        pthread_attr_setschedpolicy(&attr, SCHED_OTHER);
+        pthread_attr_setschedparam(&attr, &param);
+        rc = pthread_create(&dt->thread, &attr, deadline_timer_thread, dt);
+    }
+    pthread_attr_destroy(&attr);
+
+    if (rc) {
+        g_printerr("[ERROR] Execution Manager: deadline timer thread not started (%s)\n", g_strerror(rc));
+        return FALSE;
+    }
+    dt->running = TRUE;
+    return TRUE;
+}
+
+/* The remaining deadlines are not fired, the thread returns as soon as it wakes up */
+void deadline_timer_stop(deadline_timer_t *dt) {
+    g_return_if_fail(dt != NULL);
+    if (!dt->running) return;
+
+    guint64 one = 1;
+    if (write(dt->stop_fd, &one, sizeof(one)) < 0) {
+        /* Counter saturated: a stop is already pending */
+    }
+}
+
+void deadline_timer_join(deadline_timer_t *dt) {
+    g_return_if_fail(dt != NULL);
+    if (!dt->running) return;
+
+    pthread_join(dt->thread, NULL);
+    dt->running = FALSE;
+
+    /* A stop sent after the last deadline is not carried over to the next run */
+    guint64 count;
+    if (read(dt->stop_fd, &count, sizeof(count)) < 0) {
+        /* Nothing pending (EAGAIN) */
+    }
+}
@@ -0,0 +1,138 @@
+#define _GNU_SOURCE
+#include "em_numa.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+#define EM_NUMA_SYSFS_NODES "/sys/devices/system/node"
+
+/* --- Topology Cache --- */
+
+static gint numa_nodes = 1;
+static gint16 numa_cpu_node[EM_NUMA_MAX_CPUS];     // Node of every CPU, 0 when unknown
+
+
+/* -----------------Helper Functions ----------------- */
+
+/* Parses a sysfs cpulist ("0-3,8-11") of one node */
+static void numa_parse_cpulist(const gchar *list, gint node) {
+    gchar **ranges = g_strsplit(list, ",", -1);
+    for (gchar **r = ranges; *r; r++) {
+        gchar *end = NULL;
+        glong first = strtol(*r, &end, 10);
+        if (end == *r) continue;
+        glong last = (*end == '-') ? strtol(end + 1, NULL, 10) : first;
+        for (glong cpu = MAX(first, 0); cpu <= last && cpu < EM_NUMA_MAX_CPUS; cpu++) numa_cpu_node[cpu] = (gint16)node;
+    }
+    g_strfreev(ranges);
+}
+
+static void numa_load_topology(void) {
+    static gsize loaded = 0;
+    if (!g_once_init_enter(&loaded)) return;
+
+    GDir *dir = g_dir_open(EM_NUMA_SYSFS_NODES, 0, NULL);
+    if (dir) {
+        const gchar *name;
+        gint max_node = 0;
+        while ((name = g_dir_read_name(dir)) != NULL) {
+            if (!g_str_has_prefix(name, "node") || !g_ascii_isdigit(name[4])) continue;
+            gint node = (gint)strtol(name + 4, NULL, 10);
+            if (node >= EM_NUMA_MAX_NODES) continue;
+
+            gchar *path = g_strdup_printf(EM_NUMA_SYSFS_NODES "/%s/cpulist", name);
+            gchar *list = NULL;
+            if (g_file_get_contents(path, &list, NULL, NULL)) {
+                numa_parse_cpulist(g_strstrip(list), node);
+                max_node = MAX(max_node, node);
+            }
+            g_free(list);
+            g_free(path);
+        }
+        g_dir_close(dir);
+        numa_nodes = max_node + 1;
+    }
+
+    g_once_init_leave(&loaded, 1);
+}
+
+static gsize numa_page_size(void) {
+    return (gsize)sysconf(_SC_PAGESIZE);
+}
+
+
+/* ----------------- Topology ----------------- */
+
+gint em_numa_node_count(void) {
+    numa_load_topology();
+    return numa_nodes;
+}
+
+/* -1 for unpinned (negative) CPUs */
+gint em_numa_node_of_cpu(gint cpu) {
+    if (cpu < 0) return -1;
+    numa_load_topology();
+    return (cpu < EM_NUMA_MAX_CPUS) ? numa_cpu_node[cpu] : 0;
+}
+
+gint em_numa_first_cpu_of_node(gint node) {
+    gint n_cpus = MIN((gint)g_get_num_processors(), EM_NUMA_MAX_CPUS);
+    for (gint cpu = 0; cpu < n_cpus; cpu++) {
+        if (em_numa_node_of_cpu(cpu) == node) return cpu;
+    }
+    return -1;
+}
+
+
+/* ----------------- Placement ----------------- */
+
+/* Preferred (not strict) policy: a full node falls back to the others instead of failing the fault */
+gboolean em_numa_bind(gpointer addr, gsize size, gint node) {
+    g_return_val_if_fail(addr != NULL, FALSE);
+    if (node < 0 || em_numa_node_count() <= 1) return TRUE;
+    if (node >= EM_NUMA_MAX_NODES) return FALSE;
+
+    gsize page = numa_page_size();
+    guintptr start = (guintptr)addr & ~(guintptr)(page - 1);
+    gsize len = ((guintptr)addr + size - start + page - 1) & ~(page - 1);
+
+    gulong mask[EM_NUMA_MAX_NODES / (8 * sizeof(gulong))] = { 0 };
+    mask[node / (8 * sizeof(gulong))] |= 1UL << (node % (8 * sizeof(gulong)));
+
+    /* Pages already faulted elsewhere are migrated */
+    if (syscall(SYS_mbind, start, len, MPOL_PREFERRED, mask, (gulong)EM_NUMA_MAX_NODES + 1, MPOL_MF_MOVE) < 0) {
+        g_printerr("[WARNING] Execution Manager: mbind on node %d failed (%s)\n", node, g_strerror(errno));
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* Node holding the page of addr, -1 if the page is not faulted in or the kernel has no NUMA support */
+gint em_numa_node_of_addr(gconstpointer addr) {
+    gint node = -1;
+    if (syscall(SYS_get_mempolicy, &node, NULL, 0UL, addr, (gulong)(MPOL_F_NODE | MPOL_F_ADDR)) < 0) return -1;
+    return node;
+}
+
+/* Anonymous mapping bound to node and prefaulted, released with em_numa_free */
+gpointer em_numa_alloc(gsize size, gint node) {
+    g_return_val_if_fail(size > 0, NULL);
+
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        g_printerr("[ERROR] Execution Manager: cannot map %" G_GSIZE_FORMAT " bytes on node %d (%s)\n", size, node, g_strerror(errno));
+        return NULL;
+    }
+    em_numa_bind(base, size, node);
+
+    gsize page = numa_page_size();
+    for (gsize off = 0; off < size; off += page) ((volatile guint8 *)base)[off] = 0;
+    return base;
+}
+
+void em_numa_free(gpointer addr, gsize size) {
+    if (addr) munmap(addr, size);
+}
@@ -1,5 +1,64 @@
 #include "execution_manager.h"
 
+/* -----------------Helper Functions ----------------- */
+
+static void em_schedule_slot_free(gpointer data){
+    em_schedule_slot_t *slot = (em_schedule_slot_t *)data;
+    if (slot) {
+        g_free(slot->cores);
+        g_free(slot);
+    }
+}
+
+static em_schedule_slot_t* em_schedule_slot_new(schedule_t *sched, gint importance, const gint *cores, guint n_cores, gint64 budget_us, gint64 window_us){
+    em_schedule_slot_t *slot = g_new0(em_schedule_slot_t, 1);
+    slot->sched = sched;
+    slot->importance = importance;
+    if (cores && n_cores > 0) {
+        slot->cores = g_memdup2(cores, n_cores * sizeof(gint));
+        slot->n_cores = n_cores;
+    }
+    slot->budget_us = MAX(budget_us, 0);
+    slot->window_us = (window_us > 0) ? window_us : G_USEC_PER_SEC;
+    return slot;
+}
+
+/* Higher importance first, the GLib source priority follows the same order */
+static gint compare_slots_by_importance(gconstpointer a, gconstpointer b){
+    const em_schedule_slot_t *sa = *(em_schedule_slot_t * const *)a;
+    const em_schedule_slot_t *sb = *(em_schedule_slot_t * const *)b;
+    return (sa->importance > sb->importance) ? -1 : (sa->importance < sb->importance) ? 1 : 0;
+}
+
+static aperiodic_server_t *em_find_server(execution_manager_t *em, gint cpu){
+    for (guint i = 0; i < em->servers->len; i++) {
+        aperiodic_server_t *srv = g_ptr_array_index(em->servers, i);
+        if (srv->cpu == cpu) return srv;
+    }
+    return NULL;
+}
+
+static gint em_slot_source_priority(const em_schedule_slot_t *slot){
+    return G_PRIORITY_DEFAULT - CLAMP(slot->importance, -100, 100);
+}
+
+/* Map the logical cpu_affinity of a task on the physical core set of its schedule */
+static gint em_slot_map_cpu(const em_schedule_slot_t *slot, gint cpu_affinity){
+    if (!slot || !slot->cores || cpu_affinity < 0) return cpu_affinity;
+    return slot->cores[cpu_affinity % slot->n_cores];
+}
+
+/* TRUE if the schedule exhausted its CPU budget in the current window */
+static gboolean em_slot_is_throttled(em_schedule_slot_t *slot, gint64 now_us){
+    if (!slot || slot->budget_us == 0) return FALSE;
+
+    if (now_us - slot->window_start_us >= slot->window_us) {
+        slot->window_start_us += ((now_us - slot->window_start_us) / slot->window_us) * slot->window_us;
+        __atomic_store_n(&slot->consumed_us, 0, __ATOMIC_RELAXED);
+    }
+    return __atomic_load_n(&slot->consumed_us, __ATOMIC_RELAXED) >= slot->budget_us;
+}
+
 
 
 
@@ -8,6 +67,14 @@ execution_manager_t* em_new(const gchar *name){
 
     execution_manager_t *em = g_new0(execution_manager_t, 1);
     em->em_name = g_string_new(name);
+    em->schedules = g_ptr_array_new_with_free_func(em_schedule_slot_free);
+    em->deadline_priority = sched_get_priority_max(SCHED_FIFO);
+    em->deadline_cpu = -1;
+    em->end_on_completion = TRUE;
+    em->stacks = stack_pool_new(PTHREAD_STACK_MIN, STACK_POOL_DEFAULT_PER_CPU);
+    em->servers = g_ptr_array_new_with_free_func((GDestroyNotify)aperiodic_server_free);
+    em->budgets = cpu_budget_stats_new();
+    cpu_budget_init();
 
     return em;
 }
@@ -16,21 +83,266 @@ execution_manager_t* em_new(const gchar *name){
 void em_free(execution_manager_t *em){
     if (!em) return;
 
+    /* Detached jobs of an interrupted run still write to the trace, metrics, exporter and journal */
+    while (g_atomic_int_get(&em->live_workers) > 0) g_usleep(1000);
+
+    control_free(em->control);      // No run is live anymore, pending requests are rejected
+    clock_sync_free(em->sync);
+    g_ptr_array_free(em->servers, TRUE);    // Before the trace and metrics their workers write to
+    load_monitor_free(em->load);
+    stack_pool_free(em->stacks);    // Joins the jobs still running on the pooled stacks
+    cpu_budget_stats_free(em->budgets);
     g_string_free(em->em_name, TRUE);
+    g_ptr_array_free(em->schedules, TRUE);
+    if (em->trace_dir) g_string_free(em->trace_dir, TRUE);
+    trace_free(em->trace);
+    metrics_free(em->metrics);
+    release_guard_free(em->release_guard);
+    result_exporter_free(em->exporter);
+    journal_close(em->journal);
     g_free(em);
 }
 
 
+void em_enable_trace(execution_manager_t *em, const gchar *trace_dir, guint capacity, gboolean use_trace_marker){
+    g_return_if_fail(em != NULL);
+    g_return_if_fail(trace_dir != NULL);
 
-void em_run_schedule(execution_manager_t *em, schedule_t *sched) {
+    trace_free(em->trace);
+    em->trace = trace_new(capacity > 0 ? capacity : DEFAULT_TRACE_CAPACITY, use_trace_marker);
+
+    if (em->trace_dir) g_string_assign(em->trace_dir, trace_dir);
+    else em->trace_dir = g_string_new(trace_dir);
+}
+
+
+void em_set_lo_criticality_action(execution_manager_t *em, em_lo_action_t action){
     g_return_if_fail(em != NULL);
-    g_return_if_fail(sched != NULL);
+    g_return_if_fail(action == EM_LO_ACTION_DROP || action == EM_LO_ACTION_DEGRADE);
 
+    em->lo_action = action;
+}
 
-    GMainLoop *loop = g_main_loop_new(NULL, FALSE);
-    gint64 time_zero_us = g_get_monotonic_time();
 
-    
+void em_set_end_on_completion(execution_manager_t *em, gboolean enabled){
+    g_return_if_fail(em != NULL);
+
+    em->end_on_completion = enabled;
+}
+
+
+void em_enable_precise_release(execution_manager_t *em, gint64 initial_guard_us){
+    g_return_if_fail(em != NULL);
+
+    if (!em->release_guard) em->release_guard = release_guard_new(initial_guard_us);
+}
+
+
+void em_set_release_guard(execution_manager_t *em, gint cpu, gint64 guard_us){
+    g_return_if_fail(em != NULL && em->release_guard != NULL);
+
+    release_guard_set(em->release_guard, cpu, guard_us);
+}
+
+
+void em_set_deadline_timer(execution_manager_t *em, gint priority, gint cpu){
+    g_return_if_fail(em != NULL);
+    g_return_if_fail(priority >= 0);
+
+    em->deadline_priority = priority;
+    em->deadline_cpu = cpu;
+}
+
+
+gboolean em_enable_result_export(execution_manager_t *em, const gchar *host, gint port, const gchar *stream){
+    g_return_val_if_fail(em != NULL, FALSE);
+    g_return_val_if_fail(em->exporter == NULL, FALSE);
+
+    em->exporter = result_exporter_new(host, port, stream);
+    return em->exporter != NULL;
+}
+
+
+gboolean em_enable_journal(execution_manager_t *em, const gchar *path, guint64 capacity){
+    g_return_val_if_fail(em != NULL && path != NULL, FALSE);
+    g_return_val_if_fail(em->journal == NULL, FALSE);
+
+    em->journal = journal_open(path, capacity > 0 ? capacity : JOURNAL_DEFAULT_RECORDS);
+    return em->journal != NULL;
+}
+
+
+/* Task functions named by the add commands of the control socket */
+void em_register_control_task(execution_manager_t *em, const gchar *name, GThreadFunc task_exec){
+    g_return_if_fail(em != NULL);
+
+    if (!em->control) em->control = control_new();
+    control_register_task(em->control, name, task_exec);
+}
+
+
+gboolean em_enable_control(execution_manager_t *em, const gchar *socket_path){
+    g_return_val_if_fail(em != NULL, FALSE);
+    g_return_val_if_fail(socket_path != NULL, FALSE);
+
+    if (!em->control) em->control = control_new();
+    return em->control && control_start_server(em->control, socket_path);
+}
+
+
+void em_enable_load_monitor(execution_manager_t *em, gdouble threshold, guint tick_ms){
+    g_return_if_fail(em != NULL);
+
+    if (!em->load) em->load = load_monitor_new(threshold > 0 ? threshold : LOAD_MONITOR_DEFAULT_THRESHOLD, tick_ms);
+}
+
+
+/* Sporadic server serving the aperiodic jobs of one core */
+gboolean em_add_aperiodic_server(execution_manager_t *em, gint cpu, gint priority, gint64 budget_us, gint64 period_us){
+    g_return_val_if_fail(em != NULL, FALSE);
+    g_return_val_if_fail(em->run == NULL, FALSE);
+
+    if (em_find_server(em, cpu)) {
+        g_printerr("[ERROR] Execution Manager: CPU %d already has an aperiodic server.\n", cpu);
+        return FALSE;
+    }
+    aperiodic_server_t *srv = aperiodic_server_new(cpu, priority, budget_us, period_us);
+    if (srv) g_ptr_array_add(em->servers, srv);
+    return srv != NULL;
+}
+
+
+/* master_host NULL makes this instance the master of the group, the others follow it */
+gboolean em_enable_clock_sync(execution_manager_t *em, const gchar *master_host, gint port, guint interval_ms, gint64 period_us){
+    g_return_val_if_fail(em != NULL, FALSE);
+    g_return_val_if_fail(em->sync == NULL, FALSE);
+
+    if (port <= 0) port = CLOCK_SYNC_DEFAULT_PORT;
+    em->sync = master_host ? clock_sync_new_follower(master_host, port, interval_ms) : clock_sync_new_master(port);
+    em->sync_period_us = period_us > 0 ? period_us : EM_SYNC_DEFAULT_PERIOD_US;
+    return em->sync != NULL;
+}
+
+
+gboolean em_enable_metrics(execution_manager_t *em, const gchar *socket_path){
+    g_return_val_if_fail(em != NULL, FALSE);
+    g_return_val_if_fail(socket_path != NULL, FALSE);
+
+    if (!em->metrics) em->metrics = metrics_new();
+    return metrics_start_server(em->metrics, socket_path);
+}
+
+
+
+static void em_job_monitor_unref(em_job_monitor_t *monitor){
+    if (monitor && g_atomic_int_dec_and_test(&monitor->refcount)) g_free(monitor);
+}
+
+/* Mode switches are logged and traced, concurrent requests are resolved with a CAS */
+static void em_switch_mode(execution_manager_t *em, em_criticality_mode_t from, em_criticality_mode_t to, guint16 task_id, gint cpu){
+    if (!g_atomic_int_compare_and_exchange(&em->mode, from, to)) return;
+
+    trace_record(em->trace, TRACE_EVENT_MODE, task_id, cpu, to);
+    if (to == EM_MODE_HI) {
+        g_atomic_int_inc(&em->mode_switches);
+        g_print("[MODE] Execution Manager: switched to HI mode, Task %u overran its LO budget.\n", task_id);
+    } else {
+        g_print("[MODE] Execution Manager: system idle, back to LO mode.\n");
+    }
+}
+
+/* Planned sources are kept by the run and destroyed with it, their contexts go with them */
+static void em_source_release(gpointer data){
+    GSource *source = (GSource *)data;
+    g_source_destroy(source);
+    g_source_unref(source);
+}
+
+static void em_attach_source(GPtrArray *sources, GMainLoop *loop, GSource *source, gint priority, GSourceFunc func, gpointer ctx, GDestroyNotify destroy){
+    g_source_set_priority(source, priority);
+    g_source_set_callback(source, func, ctx, destroy);
+    g_source_attach(source, g_main_loop_get_context(loop));
+    g_ptr_array_add(sources, source);
+}
+
+static GSource *em_timer_source_new(gint64 target_us){
+    GSource *source = g_timeout_source_new(0);
+    g_source_set_ready_time(source, target_us);
+    return source;
+}
+
+/* Precise releases wake up early by the largest guard of the cores released together */
+static gint64 em_release_guard_us(execution_manager_t *em, em_schedule_slot_t *slot, timeline_entry_t *entry){
+    if (!em->release_guard) return 0;
+
+    gint64 guard_us = 0;
+    for (guint i = 0; i < entry->items->len; i++) {
+        activation_data_t *act = timeline_entry_activation(entry, i);
+        guard_us = MAX(guard_us, release_guard_get(em->release_guard, em_slot_map_cpu(slot, act->cpu_affinity)));
+    }
+    return guard_us;
+}
+
+/* A schedule ends once, on its completion or on its last deadline, the run ends with the last schedule */
+static void em_slot_finish(execution_manager_t *em, em_schedule_slot_t *slot, GMainLoop *loop){
+    if (!g_atomic_int_compare_and_exchange(&slot->finished, 0, 1)) return;
+    journal_append(em->journal, JOURNAL_EVENT_RUN_END, slot->journal_id, 0, -1,
+                   (guint32)g_atomic_int_get(&slot->sched->schedule_pending_runs), schedule_is_completed(slot->sched), NULL);
+
+    if (g_atomic_int_dec_and_test(&em->active_schedules)) {
+        g_print("[INFO] Execution Manager: All schedules completed. Quitting...\n");
+        g_main_loop_quit(loop);
+    }
+}
+
+/* Release rate of every task on its core over the run, the load monitor projects the demand from it */
+static void em_plan_load(execution_manager_t *em, em_schedule_slot_t *slot){
+    schedule_t *sched = slot->sched;
+    if (sched->schedule_duration_ns <= 0) return;
+
+    GHashTable *releases = g_hash_table_new(g_direct_hash, g_direct_equal);    // (cpu << 16 | task id) -> activation_data_t*
+    GHashTable *counts = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (GList *l = sched->schedule_start_info->head; l; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        for (guint i = 0; i < entry->items->len; i++) {
+            activation_data_t *act = timeline_entry_activation(entry, i);
+            if (act->disabled) continue;
+            gpointer key = GUINT_TO_POINTER(((guint)em_slot_map_cpu(slot, act->cpu_affinity) << 16) | act->task_id);
+            g_hash_table_insert(releases, key, act);
+            g_hash_table_insert(counts, key, GUINT_TO_POINTER(GPOINTER_TO_UINT(g_hash_table_lookup(counts, key)) + 1));
+        }
+    }
+
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, releases);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        activation_data_t *act = value;
+        gint64 budget_us = (act->budget_hi_us > 0) ? act->budget_hi_us : act->budget_lo_us;
+        gdouble per_s = GPOINTER_TO_UINT(g_hash_table_lookup(counts, key)) * (gdouble)EM_NSEC_PER_SEC / sched->schedule_duration_ns;
+        load_monitor_plan_task(em->load, act->task_id, (gint)(GPOINTER_TO_UINT(key) >> 16), per_s, em_time_us_to_ns(budget_us));
+    }
+    g_hash_table_destroy(counts);
+    g_hash_table_destroy(releases);
+}
+
+static void em_plan_schedule(execution_manager_t *em, em_schedule_slot_t *slot, GMainLoop *loop, deadline_timer_t *deadlines, GPtrArray *sources, gint64 time_zero_us){
+    schedule_t *sched = slot->sched;
+    gint priority = em_slot_source_priority(slot);
+
+    slot->window_start_us = time_zero_us;
+    slot->consumed_us = 0;
+    slot->throttled = 0;
+    slot->finished = 0;
+
+    /* The journal maps the monotonic event times of the run on the wall clock */
+    if (em->journal) {
+        slot->journal_id = journal_register_schedule(em->journal, sched->schedule_name->str, sched->schedule_version->str);
+        journal_append(em->journal, JOURNAL_EVENT_RUN_START, slot->journal_id, 0, -1, (guint32)g_atomic_int_get(&sched->schedule_pending_runs),
+                       g_get_real_time() + (time_zero_us - g_get_monotonic_time()), NULL);
+    }
+
+    /* Timeline offsets are ns, the main loop and the timerfd thread are anchored on monotonic us */
 
     /* 1. Plan the scheudle DEADLINES */
     for (GList *l = sched->schedule_end_info->head; l != NULL; l = l->next) {
@@ -38,19 +350,20 @@ void em_run_schedule(execution_manager_t *em, schedule_t *sched) {
 
         /* CORREZIONE: Uso deadline_context_t invece di context_t */
         deadline_context_t *ctx = g_new0(deadline_context_t, 1);
-        ctx->data = entry->data_list;
+        ctx->entry = entry;
         ctx->loop = loop;
-        ctx->timestamp = entry->timestamp;
+        ctx->timestamp_ns = entry->timestamp_ns;
         ctx->is_last = (l->next == NULL); // Se è l'ultimo nodo della GQueue
         ctx->sched = sched;
+        ctx->slot = slot;
+        ctx->em = em;
 
-        gint64 target_mono_us = time_zero_us + (entry->timestamp * 1000);
+        gint64 target_mono_us = em_time_add_sat(time_zero_us, em_time_ns_to_us(entry->timestamp_ns));
+        ctx->target_us = target_mono_us;
 
-        GSource *source = g_timeout_source_new(0);
-        g_source_set_ready_time(source, target_mono_us);
-        g_source_set_callback(source, handle_expiration, ctx, NULL);
-        g_source_attach(source, g_main_loop_get_context(loop));
-        g_source_unref(source);
+        /* Expirations go to the deadline timer thread, off the release path */
+        if (deadlines) deadline_timer_add(deadlines, target_mono_us, handle_expiration, ctx, g_free);
+        else em_attach_source(sources, loop, em_timer_source_new(target_mono_us), priority, handle_expiration, ctx, g_free);
     }
 
     /* 2. Plan the schedule STARTS */
@@ -58,26 +371,593 @@ void em_run_schedule(execution_manager_t *em, schedule_t *sched) {
         timeline_entry_t *entry = (timeline_entry_t *)l->data;
 
         start_context_t *ctx = g_new0(start_context_t, 1);
-        ctx->data = entry->data_list;
-        ctx->timestamp = entry->timestamp;
+        ctx->entry = entry;
+        ctx->timestamp_ns = entry->timestamp_ns;
         ctx->sched = sched;
+        ctx->slot = slot;
+        ctx->em = em;
 
-        
+        gint64 target_mono_us = em_time_add_sat(time_zero_us, em_time_ns_to_us(entry->timestamp_ns));
+        ctx->target_us = target_mono_us;
+        ctx->ready_us = target_mono_us - em_release_guard_us(em, slot, entry);
+
+        em_attach_source(sources, loop, em_timer_source_new(ctx->ready_us), priority, handle_initialization, ctx, g_free);
+    }
+
+    /* 3. Completion: the schedule may end before its last deadline (a completed schedule is not rearmed) */
+    if (em->end_on_completion && sched->schedule_completion_fd >= 0 && !schedule_is_completed(sched)) {
+        completion_context_t *ctx = g_new0(completion_context_t, 1);
+        ctx->loop = loop;
+        ctx->sched = sched;
+        ctx->slot = slot;
+        ctx->em = em;
+        ctx->last_deadline_us = em_time_add_sat(time_zero_us, em_time_ns_to_us(sched->schedule_duration_ns));
+
+        GSource *source = g_unix_fd_source_new(sched->schedule_completion_fd, G_IO_IN);
+        em_attach_source(sources, loop, source, G_PRIORITY_HIGH, G_SOURCE_FUNC(handle_completion), ctx, g_free);
+    }
+}
+
+/* Inputs, result slots and job stacks of a slot go on the NUMA node of the cores running its tasks */
+static void em_slot_place(execution_manager_t *em, em_schedule_slot_t *slot){
+    schedule_t *sched = slot->sched;
+    schedule_place_inputs(sched, slot->cores, slot->n_cores);
+    schedule_place_results(sched, slot->cores, slot->n_cores);
+    schedule_prepare_resources(sched);
+
+    for (GList *l = sched->schedule_start_info->head; l != NULL; l = l->next) {
+        timeline_entry_t *entry = (timeline_entry_t *)l->data;
+        for (guint i = 0; i < entry->items->len; i++) {
+            stack_pool_reserve(em->stacks, em_slot_map_cpu(slot, timeline_entry_activation(entry, i)->cpu_affinity));
+        }
+    }
+}
+
+/* --- Live admission (dispatcher thread) --- */
+
+typedef struct {
+    gint64 release_ns;
+    gint64 deadline_ns;
+    gint64 demand_ns;       // Declared budget, the whole window when the task has none
+} em_job_window_t;
+
+static em_schedule_slot_t *em_run_find_slot(em_run_t *run, const gchar *name){
+    for (guint i = 0; i < run->slots->len; i++) {
+        em_schedule_slot_t *slot = g_ptr_array_index(run->slots, i);
+        if (g_strcmp0(slot->sched->schedule_name->str, name) == 0) return slot;
+    }
+    return NULL;
+}
+
+static gint compare_jobs_by_deadline(gconstpointer a, gconstpointer b){
+    const em_job_window_t *ja = a, *jb = b;
+    return (ja->deadline_ns > jb->deadline_ns) - (ja->deadline_ns < jb->deadline_ns);
+}
+
+static gint compare_gint64(gconstpointer a, gconstpointer b){
+    gint64 x = *(const gint64 *)a, y = *(const gint64 *)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Jobs of a slot still to run on cpu whose window overlaps [start_ns, end_ns]:
+ * their deadlines lie in (start_ns, end_ns + longest window), found through
+ * the end index, and each expiration leads to its release in O(log n).
+ * The releases of skip_id after skip_after_ns are the ones a modify drops.
+ */
+static void em_collect_jobs(em_schedule_slot_t *slot, gint cpu, gint64 start_ns, gint64 end_ns,
+                            schedule_t *skip_sched, guint16 skip_id, gint64 skip_after_ns, GArray *jobs){
+    schedule_t *sched = slot->sched;
+    gint64 last_ns = em_time_add_sat(end_ns, sched->schedule_max_window_ns);
+
+    GTreeNode *node = g_tree_upper_bound(sched->schedule_end_index, &start_ns);
+    for (GList *l = node ? g_tree_node_value(node) : NULL; l; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        if (entry->timestamp_ns >= last_ns) break;
+        for (guint i = 0; i < entry->items->len; i++) {
+            expiration_data_t *exp = timeline_entry_expiration(entry, i);
+            if (exp->disabled || exp->release_ns >= end_ns || em_slot_map_cpu(slot, exp->cpu_affinity) != cpu) continue;
+            if (sched == skip_sched && exp->task_id == skip_id && exp->release_ns > skip_after_ns) continue;
+            if (schedule_is_job_completed(sched, exp->task_id, exp->release_ns)) continue;
+
+            activation_data_t *act = schedule_find_activation(sched, exp->task_id, exp->release_ns);
+            if (!act) continue;
 
-        gint64 target_mono_us = time_zero_us + (entry->timestamp * 1000);
+            em_job_window_t job = { exp->release_ns, entry->timestamp_ns, entry->timestamp_ns - exp->release_ns };
+            gint64 budget_us = (act->budget_hi_us > 0) ? act->budget_hi_us : act->budget_lo_us;
+            if (budget_us > 0) job.demand_ns = MIN(em_time_us_to_ns(budget_us), job.demand_ns);
+            g_array_append_val(jobs, job);
+        }
+    }
+}
 
-        GSource *source = g_timeout_source_new(0);
-        g_source_set_ready_time(source, target_mono_us);
-        g_source_set_callback(source, handle_initialization, ctx, NULL);
-        g_source_attach(source, g_main_loop_get_context(loop));
-        g_source_unref(source);
+/*
+ * Processor demand test on the CPU of the new job, over every schedule of
+ * the run: each interval [release, deadline] enclosing the new window must
+ * hold the demand of the jobs that fit in it. Exact for EDF, necessary for
+ * fixed priorities. Tasks without a declared budget take their whole window,
+ * the aperiodic server of the CPU counts as a periodic task. One sweep of
+ * the jobs by deadline per candidate interval start.
+ */
+static gboolean em_control_admit(execution_manager_t *em, gint cpu, gint64 start_ns, gint64 end_ns, gint64 wcet_us,
+                                 schedule_t *skip_sched, guint16 skip_id, gint64 skip_after_ns, gchar **reason){
+    GArray *jobs = g_array_new(FALSE, FALSE, sizeof(em_job_window_t));
+    for (guint i = 0; i < em->run->slots->len; i++) {
+        em_collect_jobs(g_ptr_array_index(em->run->slots, i), cpu, start_ns, end_ns, skip_sched, skip_id, skip_after_ns, jobs);
     }
+    em_job_window_t new_job = { start_ns, end_ns, em_time_us_to_ns(wcet_us) };
+    aperiodic_server_t *server = em_find_server(em, cpu);
+    g_array_append_val(jobs, new_job);
+    g_array_sort(jobs, compare_jobs_by_deadline);
+
+    /* 1. Interval starts: the distinct releases not after the new one */
+    GArray *froms = g_array_new(FALSE, FALSE, sizeof(gint64));
+    for (guint j = 0; j < jobs->len; j++) {
+        em_job_window_t *job = &g_array_index(jobs, em_job_window_t, j);
+        if (job->release_ns <= start_ns) g_array_append_val(froms, job->release_ns);
+    }
+    g_array_sort(froms, compare_gint64);
+
+    /* 2. Interval ends: the deadlines not before the new one, checked once all the jobs due by then are summed */
+    gboolean admitted = TRUE;
+    for (guint f = 0; f < froms->len && admitted; f++) {
+        gint64 from_ns = g_array_index(froms, gint64, f);
+        if (f > 0 && from_ns == g_array_index(froms, gint64, f - 1)) continue;
+
+        gint64 demand_ns = 0;
+        for (guint j = 0; j < jobs->len && admitted; j++) {
+            em_job_window_t *job = &g_array_index(jobs, em_job_window_t, j);
+            if (job->release_ns >= from_ns) demand_ns += job->demand_ns;
+
+            gint64 to_ns = job->deadline_ns;
+            if (to_ns < end_ns) continue;
+            if (j + 1 < jobs->len && g_array_index(jobs, em_job_window_t, j + 1).deadline_ns == to_ns) continue;
+
+            gint64 total_ns = demand_ns + aperiodic_server_demand_ns(server, to_ns - from_ns);
+            if (total_ns > to_ns - from_ns) {
+                admitted = FALSE;
+                *reason = g_strdup_printf("cpu %d overloaded in [%.3f, %.3f] ms (demand %.3f ms)", cpu,
+                                          (gdouble)from_ns / EM_NSEC_PER_MSEC, (gdouble)to_ns / EM_NSEC_PER_MSEC, (gdouble)total_ns / EM_NSEC_PER_MSEC);
+            }
+        }
+    }
+    g_array_free(froms, TRUE);
+    g_array_free(jobs, TRUE);
+    return admitted;
+}
+
+/* Sources of the fresh entries of a live change: the deadline joins the timing thread like the planned ones */
+static void em_control_plan(execution_manager_t *em, em_schedule_slot_t *slot, timeline_entry_t *start_entry, timeline_entry_t *end_entry){
+    em_run_t *run = em->run;
+    gint priority = em_slot_source_priority(slot);
+
+    deadline_context_t *dctx = g_new0(deadline_context_t, 1);
+    dctx->entry = end_entry;
+    dctx->loop = run->loop;
+    dctx->timestamp_ns = end_entry->timestamp_ns;
+    dctx->is_last = FALSE;          // Admitted deadlines never pass the last one
+    dctx->sched = slot->sched;
+    dctx->slot = slot;
+    dctx->em = em;
+    dctx->target_us = em_time_add_sat(run->time_zero_us, em_time_ns_to_us(end_entry->timestamp_ns));
+    if (!run->deadlines || !deadline_timer_insert(run->deadlines, dctx->target_us, handle_expiration, dctx, g_free)) {
+        em_attach_source(run->sources, run->loop, em_timer_source_new(dctx->target_us), priority, handle_expiration, dctx, g_free);
+    }
+
+    start_context_t *sctx = g_new0(start_context_t, 1);
+    sctx->entry = start_entry;
+    sctx->timestamp_ns = start_entry->timestamp_ns;
+    sctx->sched = slot->sched;
+    sctx->slot = slot;
+    sctx->em = em;
+    sctx->target_us = em_time_add_sat(run->time_zero_us, em_time_ns_to_us(start_entry->timestamp_ns));
+    sctx->ready_us = sctx->target_us - em_release_guard_us(em, slot, start_entry);
+    em_attach_source(run->sources, run->loop, em_timer_source_new(sctx->ready_us), priority, handle_initialization, sctx, g_free);
+}
+
+/* Applies one request; a rejected request leaves the run untouched */
+static void em_control_apply(execution_manager_t *em, control_request_t *req){
+    em_run_t *run = em->run;
+    em_schedule_slot_t *slot = em_run_find_slot(run, req->schedule);
+    if (!slot || g_atomic_int_get(&slot->finished)) {
+        control_reply(em->control, req, FALSE, slot ? "schedule already finished" : "unknown schedule");
+        return;
+    }
+
+    schedule_t *sched = slot->sched;
+    gint64 now_ns = em_time_us_to_ns(g_get_monotonic_time() - run->time_zero_us);
+    gint64 lead_ns = now_ns + em_time_us_to_ns(EM_CONTROL_LEAD_US);
 
-    g_print("[INFO] Execution Manager: Scheduler started! Waiting for events...\n");
+    /* 0. Aperiodic job: queued on the server of the core, it reads the input of a task of the schedule */
+    if (req->cmd == CONTROL_CMD_SUBMIT) {
+        activation_data_t src = { 0 };
+        gint cpu = em_slot_map_cpu(slot, req->cpu_affinity);
+        aperiodic_server_t *srv = em_find_server(em, cpu);
+        guint32 job_id = 0;
+        if (!schedule_get_activation(sched, req->task_id, -1, &src, NULL, NULL)) {
+            control_reply(em->control, req, FALSE, "input task %u not found", req->task_id);
+        } else if (!srv) {
+            control_reply(em->control, req, FALSE, "no aperiodic server on cpu %d", cpu);
+        } else {
+            /* A mutable input is copied for the job, the pooled one stays pristine for the periodic jobs */
+            gboolean mutable_input = (src.input_flags == TASK_INPUT_MUTABLE);
+            gpointer input = input_pool_job_copy(src.input_data, src.input_size, mutable_input);
+            GDestroyNotify input_free = (input != src.input_data) ? g_aligned_free : NULL;
+            if ((job_id = aperiodic_server_submit(srv, req->task_id, req->task_exec, input, input_free)) == 0) {
+                if (input_free) input_free(input);
+                control_reply(em->control, req, FALSE, "aperiodic queue of cpu %d full", cpu);
+            } else {
+                control_reply(em->control, req, TRUE, "submit: job %u on cpu %d", job_id, cpu);
+            }
+        }
+        return;
+    }
+
+    /* 1. Removal: the releases not dispatched yet are dropped */
+    if (req->cmd == CONTROL_CMD_REMOVE) {
+        guint dropped = schedule_disable_task(sched, req->task_id, lead_ns);
+        if (dropped == 0) {
+            control_reply(em->control, req, FALSE, "task %u has no release left", req->task_id);
+            return;
+        }
+        run->live_changes++;
+        control_reply(em->control, req, TRUE, "remove %u: %u release(s) dropped", req->task_id, dropped);
+        return;
+    }
+
+    /* 2. Record of the new release: a copy of the next one for a modify */
+    activation_data_t act = { 0 };
+    const gchar *error = NULL;
+    if (req->cmd == CONTROL_CMD_MODIFY) {
+        if (!schedule_get_activation(sched, req->task_id, lead_ns, &act, NULL, NULL)) error = "task has no release left";
+        else if (act.deps_count > 0) error = "task has dependencies";
+    } else if (schedule_get_activation(sched, req->task_id, -1, &act, NULL, NULL)) {
+        error = "task id in use";
+    } else {
+        activation_data_t src = { 0 };
+        if (req->input_task < 0) error = "input task required";
+        else if (!schedule_get_activation(sched, (guint16)req->input_task, -1, &src, NULL, NULL)) error = "input task not found";
+
+        /* Live tasks share the pooled input of an existing task: the task functions never get a NULL input */
+        act = (activation_data_t){ 0 };
+        act.input_data = src.input_data;
+        act.input_size = src.input_size;
+        act.input_flags = src.input_flags;
+        act.task_id = req->task_id;
+        act.task_exec = req->task_exec;
+        act.policy = (guint8)req->policy;
+        act.repetition = 1;
+        act.criticality = TASK_CRIT_LO;
+        act.deps_offset = sched->schedule_dependencies->len;
+    }
+    act.priority = req->priority;
+    act.cpu_affinity = (gint16)req->cpu_affinity;
+    act.budget_hi_us = req->wcet_us;
+
+    /* 3. Window checks */
+    if (!error && req->start_ns < lead_ns) error = "release too close or already passed";
+    else if (!error && req->end_ns > sched->schedule_duration_ns) error = "deadline after the end of the run";
+    else if (!error && em_time_us_to_ns(req->wcet_us) > req->end_ns - req->start_ns) error = "wcet larger than the window";
+    if (error) {
+        control_reply(em->control, req, FALSE, "task %u: %s (run at %.3f ms, ends at %.3f ms)", req->task_id, error,
+                      (gdouble)now_ns / EM_NSEC_PER_MSEC, (gdouble)sched->schedule_duration_ns / EM_NSEC_PER_MSEC);
+        return;
+    }
+
+    /* 4. Demand on the CPU of the task */
+    gint cpu = em_slot_map_cpu(slot, req->cpu_affinity);
+    gchar *reason = NULL;
+    /* A modify drops the releases after the lead: the job of the task already in flight still counts */
+    if (!em_control_admit(em, cpu, req->start_ns, req->end_ns, req->wcet_us, sched, req->task_id, lead_ns, &reason)) {
+        control_reply(em->control, req, FALSE, "task %u: %s", req->task_id, reason);
+        g_free(reason);
+        return;
+    }
+
+    /* 5. O(log n) merge in the live timeline, planned on the running main loop */
+    if (req->cmd == CONTROL_CMD_MODIFY) schedule_disable_task(sched, req->task_id, lead_ns);
+    timeline_entry_t *start_entry = NULL, *end_entry = NULL;
+    schedule_merge_task_ns(sched, &act, req->name, req->start_ns, req->end_ns, &start_entry, &end_entry);
+    em_control_plan(em, slot, start_entry, end_entry);
+    run->live_changes++;
+
+    control_reply(em->control, req, TRUE, "%s %u at %.3f ms, deadline %.3f ms, cpu %d",
+                  (req->cmd == CONTROL_CMD_MODIFY) ? "modify" : "add", req->task_id,
+                  (gdouble)req->start_ns / EM_NSEC_PER_MSEC, (gdouble)req->end_ns / EM_NSEC_PER_MSEC, cpu);
+}
+
+/* Shared dispatcher: the timelines of all the slots are merged in one main loop */
+static void em_run_slots(execution_manager_t *em, GPtrArray *slots){
+    GMainLoop *loop = g_main_loop_new(NULL, FALSE);
+    deadline_timer_t *deadlines = deadline_timer_new(em->deadline_priority, em->deadline_cpu);
+    GPtrArray *sources = g_ptr_array_new_with_free_func(em_source_release);
+
+    /* Task data is moved next to the worker cores once, before time zero; later runs reuse it */
+    for (guint i = 0; i < slots->len; i++) {
+        em_slot_place(em, g_ptr_array_index(slots, i));
+    }
+    gint64 sync_zero_ns = em_sync_time_zero_ns(em, EM_SYNC_LEAD_US);
+    gint64 time_zero_us = sync_zero_ns < 0 ? g_get_monotonic_time() : em_time_ns_to_us(clock_sync_to_local_ns(em->sync, sync_zero_ns));
+
+    em->run_count++;
+    if (em->trace) trace_reset(em->trace, time_zero_us);
+
+    g_ptr_array_sort(slots, compare_slots_by_importance);
+    em->active_schedules = 0;
+    g_atomic_int_set(&em->mode, EM_MODE_LO);
+    g_atomic_int_set(&em->mode_switches, 0);
+    g_atomic_int_set(&em->lo_dropped, 0);
+    if (em->load) load_monitor_plan_reset(em->load, em->metrics, em->trace);
+    metrics_clear_schedule_info(em->metrics);
+    for (guint i = 0; i < slots->len; i++) {
+        em_schedule_slot_t *slot = g_ptr_array_index(slots, i);
+        if (g_queue_is_empty(slot->sched->schedule_end_info)) continue;
+        if (em->load) em_plan_load(em, slot);
+
+        /* The main loop, the deadline thread and the release spin all run on the monotonic time zero */
+        if (slot->sched->schedule_clock != CLOCK_MONOTONIC) {
+            g_printerr("[WARNING] Execution Manager: schedule %s is timed on CLOCK_TAI, the dispatcher runs it on CLOCK_MONOTONIC (only the cyclic backend follows TAI).\n",
+                       slot->sched->schedule_name->str);
+        }
+
+        metrics_add_schedule_info(em->metrics, slot->sched->schedule_name->str, slot->sched->schedule_version->str);
+        em_plan_schedule(em, slot, loop, deadlines, sources, time_zero_us);
+        em->active_schedules++;
+    }
+
+    if (em->active_schedules == 0) {
+        g_print("[INFO] Execution Manager: No schedule to run.\n");
+        deadline_timer_free(deadlines);
+        g_ptr_array_free(sources, TRUE);
+        g_main_loop_unref(loop);
+        return;
+    }
+
+    /* Without the timing thread the expirations are moved back on the main loop (contexts stay with the timer) */
+    gboolean timer_thread = deadlines && deadline_timer_start(deadlines);
+    if (deadlines && !timer_thread) {
+        for (guint i = 0; i < deadlines->entries->len; i++) {
+            deadline_timer_entry_t *entry = &g_array_index(deadlines->entries, deadline_timer_entry_t, i);
+            deadline_context_t *ctx = entry->data;
+            em_attach_source(sources, loop, em_timer_source_new(entry->target_us), em_slot_source_priority(ctx->slot),
+                             handle_expiration, ctx, NULL);
+        }
+    }
+
+    /* Precise releases: no timer slack on the dispatcher wake ups */
+    gulong timer_slack_ns = 0;
+    if (em->release_guard) {
+        timer_slack_ns = (gulong)prctl(PR_GET_TIMERSLACK, 0, 0, 0, 0);
+        prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+    }
+
+    /* Live admission: requests are applied between the releases, below their priority */
+    em_run_t run = { loop, sources, slots, timer_thread ? deadlines : NULL, time_zero_us, 0 };
+    em->run = &run;     // Also receives the LO budget timers of the releases
+    if (em->control) {
+        em_attach_source(sources, loop, g_unix_fd_source_new(em->control->wakeup_fd, G_IO_IN), G_PRIORITY_LOW,
+                         G_SOURCE_FUNC(handle_control), em, NULL);
+        control_set_live(em->control, TRUE);
+    }
+
+    /* Aperiodic servers: one source per server, woken by its eventfd or at its next budget event */
+    for (guint i = 0; i < em->servers->len; i++) {
+        aperiodic_server_t *srv = g_ptr_array_index(em->servers, i);
+        srv->metrics = em->metrics;
+        srv->trace = em->trace;
+        GSource *source = g_unix_fd_source_new(srv->event_fd, G_IO_IN);
+        g_source_set_ready_time(source, 0);
+        em_attach_source(sources, loop, source, EM_SERVER_SOURCE_PRIORITY, G_SOURCE_FUNC(handle_aperiodic), srv, NULL);
+    }
+
+    g_print("[INFO] Execution Manager: Scheduler started with %d schedule(s)! Waiting for events...\n", em->active_schedules);
     g_main_loop_run(loop);
-    
+
+    if (em->control) control_set_live(em->control, FALSE);
+    em->run = NULL;
+
+    for (guint i = 0; i < em->servers->len; i++) aperiodic_server_print(g_ptr_array_index(em->servers, i));
+    cpu_budget_stats_print(em->budgets);
+    if (em->load) {
+        load_monitor_print(em->load);
+        load_monitor_plan_reset(em->load, em->metrics, NULL);     // Nothing planned between runs, the trace is exported
+    }
+
+    if (em->release_guard) {
+        prctl(PR_SET_TIMERSLACK, timer_slack_ns, 0, 0, 0);
+        release_guard_print(em->release_guard);
+    }
+
+    /* Deadlines left behind by an early completion are not fired */
+    if (timer_thread) {
+        deadline_timer_stop(deadlines);
+        deadline_timer_join(deadlines);
+        g_print("[INFO] Execution Manager: %" G_GUINT64_FORMAT " deadline(s) checked, worst detection delay %ld us.\n",
+                deadlines->fired, (long)deadlines->max_lateness_us);
+    }
+    g_ptr_array_free(sources, TRUE);
+    deadline_timer_free(deadlines);
+    journal_sync(em->journal);
+
+    /* Nothing reads the timelines anymore: the live changes become part of the schedules */
+    if (run.live_changes > 0) {
+        for (guint i = 0; i < slots->len; i++) schedule_compact(((em_schedule_slot_t *)g_ptr_array_index(slots, i))->sched);
+        g_print("[INFO] Execution Manager: %u live change(s) kept for the next runs.\n", run.live_changes);
+    }
+
     g_main_loop_unref(loop);
     g_print("[INFO] Execution Manager: Scheduler terminated successfully.\n");
+
+    if (g_atomic_int_get(&em->mode_switches) > 0) {
+        g_print("[MODE] Execution Manager: %d switch(es) to HI mode, %d LO release(s) dropped.\n",
+                g_atomic_int_get(&em->mode_switches), g_atomic_int_get(&em->lo_dropped));
+    }
+
+    for (guint i = 0; i < slots->len; i++) {
+        em_schedule_slot_t *slot = g_ptr_array_index(slots, i);
+        if (slot->throttled > 0) {
+            g_print("[WARNING] Execution Manager: schedule %s dropped %" G_GUINT64_FORMAT " releases over its CPU budget.\n",
+                    slot->sched->schedule_name->str, slot->throttled);
+        }
+    }
+}
+
+
+void em_run_schedule(execution_manager_t *em, schedule_t *sched) {
+    g_return_if_fail(em != NULL);
+    g_return_if_fail(sched != NULL);
+
+    /* A single schedule runs in a temporary slot with no budget and identity core mapping */
+    GPtrArray *slots = g_ptr_array_new_with_free_func(em_schedule_slot_free);
+    g_ptr_array_add(slots, em_schedule_slot_new(sched, 0, NULL, 0, 0, 0));
+
+    em_run_slots(em, slots);
+    g_ptr_array_free(slots, TRUE);
+
+    /* Export the tracepoints of this run */
+    em_export_trace(em, sched, "run");
+}
+
+
+em_schedule_slot_t* em_add_schedule(execution_manager_t *em, schedule_t *sched, gint importance, const gint *cores, guint n_cores, gint64 budget_us, gint64 window_us) {
+    g_return_val_if_fail(em != NULL, NULL);
+    g_return_val_if_fail(sched != NULL, NULL);
+    g_return_val_if_fail(budget_us >= 0, NULL);
+
+    em_schedule_slot_t *slot = em_schedule_slot_new(sched, importance, cores, n_cores, budget_us, window_us);
+    g_ptr_array_add(em->schedules, slot);
+
+    g_print("[INFO] Execution Manager: hosting schedule %s (importance %d, %u cores, budget %ld/%ld us)\n",
+            sched->schedule_name->str, importance, slot->n_cores, (long)slot->budget_us, (long)slot->window_us);
+    return slot;
+}
+
+
+void em_remove_schedule(execution_manager_t *em, schedule_t *sched) {
+    g_return_if_fail(em != NULL);
+
+    for (guint i = 0; i < em->schedules->len; i++) {
+        em_schedule_slot_t *slot = g_ptr_array_index(em->schedules, i);
+        if (slot->sched == sched) {
+            g_ptr_array_remove_index(em->schedules, i);
+            return;
+        }
+    }
+}
+
+
+void em_run_schedules(execution_manager_t *em) {
+    g_return_if_fail(em != NULL);
+
+    em_run_slots(em, em->schedules);
+
+    /* Export the tracepoints of this run */
+    em_export_trace(em, NULL, "run");
+}
+
+/* Safe from any thread; the job runs while a schedule runs. Returns the job id, 0 if rejected */
+guint32 em_submit_aperiodic(execution_manager_t *em, gint cpu, guint16 task_id, GThreadFunc func, gpointer input, GDestroyNotify input_free){
+    g_return_val_if_fail(em != NULL && func != NULL, 0);
+
+    aperiodic_server_t *srv = em_find_server(em, cpu);
+    if (!srv) return 0;
+    return aperiodic_server_submit(srv, task_id, func, input, input_free);
+}
+
+void em_export_trace(execution_manager_t *em, schedule_t *sched, const gchar *tag){
+    g_return_if_fail(em != NULL);
+
+    if (!em->trace || !em->trace_dir) return;
+
+    /* Runs of several schedules are named after the execution manager */
+    gchar *file_name = sched
+        ? g_strdup_printf("%s-%s-%s%u.json", sched->schedule_name->str, sched->schedule_version->str, tag, em->run_count)
+        : g_strdup_printf("%s-%s%u.json", em->em_name->str, tag, em->run_count);
+    gchar *path = g_build_filename(em->trace_dir->str, file_name, NULL);
+    trace_export_chrome(em->trace, path);
+    g_free(path);
+    g_free(file_name);
+}
+
+/*
+ * Start of a coordinated run on the master clock: the first boundary of the
+ * group epoch at least lead_us ahead, so the instances asked to run within
+ * the same period release together. -1 when the run is not coordinated.
+ */
+gint64 em_sync_time_zero_ns(execution_manager_t *em, gint64 lead_us){
+    g_return_val_if_fail(em != NULL, -1);
+
+    if (!em->sync) return -1;
+    if (!clock_sync_is_locked(em->sync)) {
+        g_printerr("[WARNING] Execution Manager: clock not synchronized yet, the run starts on the local clock.\n");
+        return -1;
+    }
+    gint64 after_ns = em_time_now_ns(CLOCK_MONOTONIC) + lead_us * EM_NSEC_PER_USEC;
+    gint64 local_ns = clock_sync_next_boundary_ns(em->sync, after_ns, em_time_us_to_ns(em->sync_period_us));
+    return clock_sync_to_master_ns(em->sync, local_ns);
+}
+
+/* The CPU time of the job is needed by a schedule budget or by the load monitor */
+static gboolean task_wrapper_accounted(task_wrapper_input_t *tw_input) {
+    return (tw_input->slot && tw_input->slot->budget_us > 0) || tw_input->em->load;
+}
+
+/* Charge the CPU time of task_exec (not the release spin, the input copy or the logs) to the budget of its schedule and to the load of its core */
+static void task_wrapper_charge(task_wrapper_input_t *tw_input) {
+    gboolean charged = tw_input->slot && tw_input->slot->budget_us > 0;
+    if (task_wrapper_accounted(tw_input)) {
+        gint64 cpu_ns = em_time_now_ns(CLOCK_THREAD_CPUTIME_ID) - tw_input->cpu_start_ns;
+        if (charged) __atomic_fetch_add(&tw_input->slot->consumed_us, em_time_ns_to_us(cpu_ns), __ATOMIC_RELAXED);
+        load_monitor_add_job(tw_input->em->load, tw_input->task_id, tw_input->cpu, cpu_ns);
+    }
+}
+
+/* Close the LO budget window of the job */
+static void task_wrapper_finish_monitor(task_wrapper_input_t *tw_input) {
+    if (tw_input->monitor) {
+        g_atomic_int_set(&tw_input->monitor->finished, 1);
+        em_job_monitor_unref(tw_input->monitor);
+        tw_input->monitor = NULL;
+    }
+}
+
+/* Last step of every job, completed or aborted: the system may be idle again, leave HI mode */
+static void task_wrapper_release(task_wrapper_input_t *tw_input) {
+    execution_manager_t *em = tw_input->em;
+
+    task_wrapper_finish_monitor(tw_input);
+    input_pool_job_done(tw_input->data, tw_input->job_input);
+    if (g_atomic_int_dec_and_test(&em->running_jobs)) {
+        em_switch_mode(em, EM_MODE_HI, EM_MODE_LO, tw_input->task_id, tw_input->cpu);
+    }
+    g_free(tw_input);
+    g_atomic_int_add(&em->live_workers, -1);   // Last access to the manager, em_free may run from here
+}
+
+/* Cleanup handler of a job cancelled on its CPU budget (TASK_BUDGET_ABORT): its run ends with no output, memory the task allocated is lost */
+static void task_wrapper_cancelled(void *data) {
+    task_wrapper_input_t *tw_input = (task_wrapper_input_t *)data;
+    execution_manager_t *em = tw_input->em;
+    task_wrapper_charge(tw_input);
+
+    cpu_budget_outcome_t outcome;
+    cpu_budget_disarm(&outcome);
+    gint64 cpu_ns = outcome.cpu_ns;
+    cpu_budget_record_abort(em->budgets, tw_input->task_id, em_time_us_to_ns(tw_input->cpu_budget_us), &outcome);
+    metrics_inc_budget_overrun(em->metrics, tw_input->cpu);
+    metrics_inc_abort(em->metrics, tw_input->cpu);
+    trace_record(em->trace, TRACE_EVENT_BUDGET, tw_input->task_id, tw_input->cpu, em_time_ns_to_us(cpu_ns));
+    trace_record(em->trace, TRACE_EVENT_ABORT, tw_input->task_id, tw_input->cpu, 0);
+    guint8 runs_left = schedule_get_remaining_runs(tw_input->sched, tw_input->task_id);
+    if (runs_left > 0) runs_left--;
+    journal_append(em->journal, JOURNAL_EVENT_ABORT, tw_input->slot ? tw_input->slot->journal_id : JOURNAL_UNKNOWN_SCHEDULE,
+                   tw_input->task_id, tw_input->cpu, runs_left, 0, NULL);
+    g_printerr("[WARNING] Execution Manager: Task %u aborted after %ld us of CPU time (budget %ld us).\n",
+               tw_input->task_id, (long)em_time_ns_to_us(cpu_ns), (long)tw_input->cpu_budget_us);
+
+    /* The run is over like a completed one, last access to the schedule */
+    schedule_abort_job(tw_input->sched, tw_input->task_id, tw_input->release_ns);
+    task_wrapper_release(tw_input);
 }
 
 void* task_wrapper_func(void* data){
@@ -86,24 +966,79 @@ void* task_wrapper_func(void* data){
     
     /* Read the thread context arguments */
     guint16 task_id = tw_input->task_id;
-    gpointer input = tw_input->data;
+    gpointer input = input_pool_job_copy(tw_input->data, tw_input->input_size, tw_input->input_mutable);
+    tw_input->job_input = input;
     GThreadFunc thread_func = tw_input->thread_func;
     schedule_t* sched = tw_input->sched;
 
+    /* Precise release: the thread was created ahead of time, spin up to the release */
+    if (tw_input->ready_us > 0) {
+        gint64 wakeup_us = g_get_monotonic_time() - tw_input->ready_us;
+        gint64 overshoot_ns = release_guard_spin_until(tw_input->release_us);
+        release_guard_observe(tw_input->em->release_guard, tw_input->cpu, wakeup_us, overshoot_ns < 0);
+    }
+
     g_print("[INFO] ThreadCall %u: start thread function.\n", task_id);
     /* Run the thread function */
-    gpointer res = thread_func(input);
+    gint64 start_us = g_get_monotonic_time();
+    gint64 release_latency_us = start_us - tw_input->release_us;
+    metrics_observe_release_latency(tw_input->em->metrics, tw_input->cpu, release_latency_us);
+    trace_record(tw_input->em->trace, TRACE_EVENT_START, task_id, tw_input->cpu, release_latency_us);
+    resource_set_current_task(task_id);
+
+    /* CPU time budget: cancellation is only enabled while task_exec runs, and only for the abort action (taken at a budget checkpoint) */
+    gboolean budgeted = tw_input->cpu_budget_us > 0 && cpu_budget_arm(em_time_us_to_ns(tw_input->cpu_budget_us), tw_input->budget_action);
+    gpointer res = NULL;
+    pthread_setcancelstate(budgeted && tw_input->budget_action == TASK_BUDGET_ABORT ? PTHREAD_CANCEL_ENABLE : PTHREAD_CANCEL_DISABLE, NULL);
+    pthread_cleanup_push(task_wrapper_cancelled, tw_input);
+    if (task_wrapper_accounted(tw_input)) tw_input->cpu_start_ns = em_time_now_ns(CLOCK_THREAD_CPUTIME_ID);
+    res = thread_func(input);
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+    pthread_cleanup_pop(0);
+    task_wrapper_charge(tw_input);
+
+    trace_record(tw_input->em->trace, TRACE_EVENT_FINISH, task_id, tw_input->cpu, 0);
+    metrics_inc_completion(tw_input->em->metrics, tw_input->cpu, g_get_monotonic_time() - start_us);
+
+    if (budgeted) {
+        cpu_budget_outcome_t outcome;
+        gboolean exhausted = cpu_budget_disarm(&outcome);
+        gint64 cpu_ns = outcome.cpu_ns;
+        cpu_budget_record(tw_input->em->budgets, task_id, em_time_us_to_ns(tw_input->cpu_budget_us), &outcome);
+        if (outcome.abort_missed) {
+            g_printerr("[WARNING] Execution Manager: Task %u completed before a budget checkpoint, its abort was not taken.\n", task_id);
+        }
+        if (exhausted) {
+            metrics_inc_budget_overrun(tw_input->em->metrics, tw_input->cpu);
+            trace_record(tw_input->em->trace, TRACE_EVENT_BUDGET, task_id, tw_input->cpu, em_time_ns_to_us(cpu_ns));
+            g_printerr("[WARNING] Execution Manager: Task %u used %ld us of CPU time, over its budget of %ld us.\n",
+                       task_id, (long)em_time_ns_to_us(cpu_ns), (long)tw_input->cpu_budget_us);
+        }
+    }
 
     g_print("[INFO] ThreadCall %u: termination thread function. \n", task_id);
 
-    /* Write the result */
-    schedule_set_result(sched, task_id, "{}");
+    task_wrapper_finish_monitor(tw_input);
+    if (tw_input->budget_hi_us > 0 && g_get_monotonic_time() - start_us > tw_input->budget_hi_us) {
+        g_printerr("[WARNING] Execution Manager: Task %u exceeded its HI budget (%ld us).\n", task_id, (long)tw_input->budget_hi_us);
+    }
+
+    /* Export and journal first: the result may end the run, main can free the schedule right after it */
+    guint8 runs_left = schedule_get_remaining_runs(sched, task_id);
+    if (runs_left > 0) runs_left--;
+    result_exporter_push(tw_input->em->exporter, sched->schedule_name->str, task_id, "{}");
+    journal_append(tw_input->em->journal, JOURNAL_EVENT_COMPLETE, tw_input->slot ? tw_input->slot->journal_id : JOURNAL_UNKNOWN_SCHEDULE,
+                   task_id, tw_input->cpu, runs_left, g_get_monotonic_time() - start_us, "{}");
+
+    /* Write the result, last access to the schedule */
+    schedule_set_job_result(sched, task_id, tw_input->release_ns, "{}");
 
 
-    /* Cleanup */
-    g_free(input);
+    /* Cleanup: the input belongs to the schedule and is reused by the next run */
     g_free(res);
-    g_free(tw_input);
+
+    /* The system is idle again: leave HI mode */
+    task_wrapper_release(tw_input);
     return NULL;
 
 }
@@ -112,27 +1047,73 @@ void* task_wrapper_func(void* data){
 
 gboolean handle_initialization(gpointer user_data) {
     start_context_t *ctx = (start_context_t *)user_data;
-    GSList *tasks = (GSList *)ctx->data;
+    GArray *tasks = ctx->entry->items;
     schedule_t* sched = ctx->sched;
+    gint64 now_us = g_get_monotonic_time();
 
+    trace_record(ctx->em->trace, TRACE_EVENT_WAKEUP, 0, -1, now_us - ctx->ready_us);
 
-    if (tasks == NULL) {
+    if (tasks->len == 0) {
         g_print("[ERROR] Execution Manager: No tasks\n");
-        g_free(ctx);
         return G_SOURCE_REMOVE;
     }
 
-    for (GSList *l = tasks; l != NULL; l = l->next) {
+    /* An overloaded schedule loses its releases instead of delaying the other schedules */
+    if (em_slot_is_throttled(ctx->slot, now_us)) {
+        ctx->slot->throttled += tasks->len;
+        g_print("[WARNING] Execution Manager: schedule %s over CPU budget, releases at %.3f ms dropped.\n",
+                sched->schedule_name->str, (gdouble)ctx->timestamp_ns / EM_NSEC_PER_MSEC);
+        return G_SOURCE_REMOVE;
+    }
+
+    for (guint i = 0; i < tasks->len; i++) {
         
-        /* Read the current task information */
-        activation_data_t *task = (activation_data_t *)l->data;
+        /* Read the current task information (records are contiguous, one cache line each) */
+        activation_data_t *task = timeline_entry_activation(ctx->entry, i);
+        if (task->disabled) continue;   // Removed from the control socket
+        gint cpu = em_slot_map_cpu(ctx->slot, task->cpu_affinity);
+        gint policy = task->policy;
+        gint priority = task->priority;
+
+        /* HI mode: LO releases are dropped or degraded to best effort */
+        if (task->criticality == TASK_CRIT_LO && g_atomic_int_get(&ctx->em->mode) == EM_MODE_HI) {
+            if (ctx->em->lo_action == EM_LO_ACTION_DROP) {
+                g_atomic_int_inc(&ctx->em->lo_dropped);
+                trace_record(ctx->em->trace, TRACE_EVENT_DROP, task->task_id, cpu, 0);
+                g_print("[MODE] Execution Manager: HI mode, release of Task %u dropped.\n", task->task_id);
+                continue;
+            }
+            policy = SCHED_OTHER;
+            priority = 0;
+        }
 
         /* Prepare the thread (wrapper) input */
         task_wrapper_input_t* tw_input = g_new0(task_wrapper_input_t, 1);
         tw_input->task_id = task->task_id;
         tw_input->data = task->input_data;
+        tw_input->input_size = task->input_size;
+        tw_input->input_mutable = (task->input_flags == TASK_INPUT_MUTABLE);
         tw_input->thread_func = task->task_exec;
+        tw_input->cpu = cpu;
         tw_input->sched = sched;
+        tw_input->slot = ctx->slot;
+        tw_input->release_us = ctx->target_us;
+        tw_input->release_ns = ctx->timestamp_ns;
+        tw_input->ready_us = ctx->em->release_guard ? ctx->ready_us : 0;
+        tw_input->em = ctx->em;
+        tw_input->budget_hi_us = task->budget_hi_us;
+        tw_input->cpu_budget_us = task->cpu_budget_us;
+        tw_input->budget_action = (task_budget_action_t)task->budget_action;
+
+        /* HI jobs with an optimistic budget get a monitor checked at release + budget */
+        if (task->criticality == TASK_CRIT_HI && task->budget_lo_us > 0) {
+            em_job_monitor_t *monitor = g_new0(em_job_monitor_t, 1);
+            monitor->refcount = 2;
+            monitor->task_id = task->task_id;
+            monitor->cpu = cpu;
+            monitor->em = ctx->em;
+            tw_input->monitor = monitor;
+        }
 
 
         
@@ -143,7 +1124,7 @@ gboolean handle_initialization(gpointer user_data) {
         /* Set CPU Affinity core */
         cpu_set_t set;
         CPU_ZERO(&set);
-        CPU_SET(task->cpu_affinity, &set);
+        CPU_SET(cpu, &set);
         gint affinity_err = pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &set);
         if (affinity_err != 0) {
             g_warning("[WARNING] Execution Manager: Failed to set CPU affinity for Task ID %u. Error: %d (%s)", task->task_id, affinity_err, g_strerror(affinity_err));
@@ -151,30 +1132,49 @@ gboolean handle_initialization(gpointer user_data) {
 
         /* Setting scheduler policy and priority */
         struct sched_param param;
-        param.sched_priority = task->priority;
+        param.sched_priority = priority;
 
-        pthread_attr_setstacksize(&attr, PTHREAD_STACK_MIN);
-        pthread_attr_setschedpolicy(&attr, task->policy);
+        /* Stack reserved on the node of the CPU, glibc default stack when they are all in use */
+        em_stack_t *stack = stack_pool_acquire(ctx->em->stacks, cpu);
+        if (stack) pthread_attr_setstack(&attr, stack->base, stack->size);
+        else pthread_attr_setstacksize(&attr, PTHREAD_STACK_MIN);
+        pthread_attr_setschedpolicy(&attr, policy);
         pthread_attr_setschedparam(&attr, &param);
         pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
 
+        trace_record(ctx->em->trace, TRACE_EVENT_RELEASE, task->task_id, cpu, 0);
+
+        g_atomic_int_inc(&ctx->em->running_jobs);
+        g_atomic_int_inc(&ctx->em->live_workers);
+        em_job_monitor_t *monitor = tw_input->monitor;
+
         pthread_t thread;
         gint rc = pthread_create(&thread, &attr, task_wrapper_func, tw_input);
         pthread_attr_destroy(&attr); // Clean up attributes
         if (rc) {
             g_printerr("[ERROR] Execution Manager: pthread_create failed with code %d (%s) for Task ID %u\n", rc, g_strerror(rc), task->task_id);
+            g_atomic_int_add(&ctx->em->running_jobs, -1);
+            g_atomic_int_add(&ctx->em->live_workers, -1);
+            g_free(monitor);
+            g_free(tw_input);
             continue;
         }
-        pthread_detach(thread);
+        if (stack) stack_pool_commit(stack, thread);
+        else pthread_detach(thread);
 
-        // Iterate through GSList of dependencies
-        if (task->depends_on) {
+        /* Kept by the run: an early end destroys the timer and drops its reference to the monitor */
+        if (monitor) {
+            em_attach_source(ctx->em->run->sources, ctx->em->run->loop, em_timer_source_new(ctx->target_us + task->budget_lo_us),
+                             G_PRIORITY_HIGH, handle_budget_lo, monitor, (GDestroyNotify)em_job_monitor_unref);
+        }
+        metrics_inc_activation(ctx->em->metrics, cpu);
+
+        // Iterate through the dependencies stored in the schedule
+        if (task->deps_count > 0) {
+            const guint16 *deps = schedule_task_dependencies(sched, task);
             g_print("[INFO] Depends On (IDs): ");
-            for (GSList *dep = task->depends_on; dep != NULL; dep = dep->next) {
-                // Assuming the list stores integers cast to pointers, or pointers to guint
-                // If they are pointers to uint: *(guint*)dep->data
-                // If they are IDs stored directly in the pointer: GPOINTER_TO_UINT(dep->data)
-                g_print("%u ", GPOINTER_TO_UINT(dep->data));
+            for (guint d = 0; d < task->deps_count; d++) {
+                g_print("%u ", deps[d]);
             }
             g_print("\n");
         } else {
@@ -182,7 +1182,6 @@ gboolean handle_initialization(gpointer user_data) {
         }
     }
 
-    g_free(ctx); 
     return G_SOURCE_REMOVE;
 }
 
@@ -190,28 +1189,102 @@ gboolean handle_initialization(gpointer user_data) {
 
 gboolean handle_expiration(gpointer user_data) {
     deadline_context_t *ctx = (deadline_context_t *)user_data;
-    GSList *tasks = (GSList *)ctx->data;
+    GArray *tasks = ctx->entry->items;
+
+    trace_record(ctx->em->trace, TRACE_EVENT_WAKEUP, 0, -1, g_get_monotonic_time() - ctx->target_us);
 
-    if (tasks == NULL) {
+    if (tasks->len == 0) {
         g_print("[INFO] Execution Manager: No tasks to expire\n");
     } else {
-        for (GSList *l = tasks; l != NULL; l = l->next) {
-            expiration_data_t *exp = (expiration_data_t *)l->data;
+        for (guint i = 0; i < tasks->len; i++) {
+            expiration_data_t *exp = timeline_entry_expiration(ctx->entry, i);
+            if (__atomic_load_n(&exp->disabled, __ATOMIC_RELAXED)) continue;
+            gint cpu = em_slot_map_cpu(ctx->slot, exp->cpu_affinity);
+            trace_record(ctx->em->trace, TRACE_EVENT_DEADLINE, exp->task_id, cpu, 0);
             
-            /* Check if the task is jet completed*/
-            if (schedule_is_task_completed(ctx->sched, exp->task_id)) {
+            /* Check if the job released with this deadline is completed, the other runs of the task do not count */
+            if (schedule_is_job_completed(ctx->sched, exp->task_id, exp->release_ns)) {
                 g_print("[INFO] Execution Manager: Task %u already completed.\n", exp->task_id);
                 continue;
             }
+            metrics_inc_deadline_miss(ctx->em->metrics, cpu);
+            metrics_inc_abort(ctx->em->metrics, cpu);
+            trace_record(ctx->em->trace, TRACE_EVENT_ABORT, exp->task_id, cpu, 0);
+            journal_append(ctx->em->journal, JOURNAL_EVENT_ABORT, ctx->slot->journal_id, exp->task_id, cpu,
+                           schedule_get_remaining_runs(ctx->sched, exp->task_id), 0, NULL);
             g_print("[INFO] Execution Manager: Sent ABORT for Task ID %u\n", exp->task_id);
         }
     }
 
+    /* The shared dispatcher stops with the last deadline of the last schedule */
     if (ctx->is_last) {
-        g_print("[INFO] Execution Manager (handle_expiration): Final deadline reached. Quitting...\n");
-        g_main_loop_quit(ctx->loop);
+        g_print("[INFO] Execution Manager (handle_expiration): Final deadline of %s reached.\n", ctx->sched->schedule_name->str);
+        em_slot_finish(ctx->em, ctx->slot, ctx->loop);
     }
 
-    g_free(ctx); 
     return G_SOURCE_REMOVE;
-}
\ No newline at end of file
+}
+
+
+
+gboolean handle_completion(gint fd, GIOCondition condition, gpointer user_data) {
+    completion_context_t *ctx = (completion_context_t *)user_data;
+    gint64 now_us = g_get_monotonic_time();
+
+    /* 1. Consume the notifications, the latency is taken from the last completion */
+    guint64 count = 0;
+    if (read(fd, &count, sizeof(count)) != sizeof(count)) return G_SOURCE_CONTINUE;
+
+    gint64 latency_us = now_us - __atomic_load_n(&ctx->sched->schedule_last_completion_us, __ATOMIC_RELAXED);
+    metrics_observe_notify_latency(ctx->em->metrics, latency_us);
+    trace_record(ctx->em->trace, TRACE_EVENT_COMPLETE, 0, -1, latency_us);
+
+    if (!schedule_is_completed(ctx->sched)) return G_SOURCE_CONTINUE;
+
+    /* 2. Every run done: the schedule ends now instead of at its last deadline */
+    g_print("[INFO] Execution Manager: schedule %s completed %ld us before its last deadline (notified in %ld us).\n",
+            ctx->sched->schedule_name->str, (long)(ctx->last_deadline_us - now_us), (long)latency_us);
+    em_slot_finish(ctx->em, ctx->slot, ctx->loop);
+    return G_SOURCE_REMOVE;
+}
+
+
+
+gboolean handle_budget_lo(gpointer user_data) {
+    em_job_monitor_t *monitor = (em_job_monitor_t *)user_data;
+
+    /* Still running at release + LO budget: the optimistic assumption failed */
+    if (!g_atomic_int_get(&monitor->finished)) {
+        em_switch_mode(monitor->em, EM_MODE_LO, EM_MODE_HI, monitor->task_id, monitor->cpu);
+    }
+
+    return G_SOURCE_REMOVE;     // The source releases its reference to the monitor
+}
+
+
+
+gboolean handle_control(gint fd, GIOCondition condition, gpointer user_data) {
+    execution_manager_t *em = (execution_manager_t *)user_data;
+
+    guint64 count = 0;
+    if (read(fd, &count, sizeof(count)) != sizeof(count)) return G_SOURCE_CONTINUE;
+
+    control_request_t *req;
+    while ((req = control_next_request(em->control)) != NULL) em_control_apply(em, req);
+    return G_SOURCE_CONTINUE;
+}
+
+
+
+gboolean handle_aperiodic(gint fd, GIOCondition condition, gpointer user_data) {
+    aperiodic_server_t *srv = (aperiodic_server_t *)user_data;
+
+    /* Woken by a submission or a completion (eventfd), or by the budget timer (ready time) */
+    guint64 count = 0;
+    if (read(fd, &count, sizeof(count)) < 0) {
+        /* Nothing pending (EAGAIN): timer wake up */
+    }
+    gint64 next_ns = aperiodic_server_update(srv, em_time_now_ns(CLOCK_MONOTONIC));
+    g_source_set_ready_time(g_main_current_source(), next_ns < 0 ? -1 : em_time_ns_to_us(next_ns));
+    return G_SOURCE_CONTINUE;
+}
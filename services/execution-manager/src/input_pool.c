@@ -0,0 +1,189 @@
+#define _GNU_SOURCE
+#include "input_pool.h"
+#include "em_numa.h"
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+
+/* --- Internal Structures --- */
+
+typedef struct {
+    gconstpointer src;          // Staged or adopted input
+    gsize size;
+    gsize span;                 // Bytes reserved in the arena (scratch area included)
+    gsize offset;
+} input_copy_t;
+
+/* Inputs of one core, copied by a thread pinned on it */
+typedef struct {
+    gint cpu;
+    GArray *copies;             // input_copy_t
+    GHashTable *index;          // Map: src -> copy index + 1
+    gsize total;
+    gpointer base;              // Arena, NULL if the mapping failed
+} input_core_job_t;
+
+
+/* -----------------Helper Functions ----------------- */
+
+static void input_core_job_free(gpointer data) {
+    input_core_job_t *job = (input_core_job_t *)data;
+    if (job) {
+        g_array_free(job->copies, TRUE);
+        g_hash_table_destroy(job->index);
+        g_free(job);
+    }
+}
+
+static input_core_job_t *input_core_job_get(GHashTable *jobs, gint cpu) {
+    input_core_job_t *job = g_hash_table_lookup(jobs, GINT_TO_POINTER(cpu));
+    if (!job) {
+        job = g_new0(input_core_job_t, 1);
+        job->cpu = cpu;
+        job->copies = g_array_new(FALSE, FALSE, sizeof(input_copy_t));
+        job->index = g_hash_table_new(g_direct_hash, g_direct_equal);
+        g_hash_table_insert(jobs, GINT_TO_POINTER(cpu), job);
+    }
+    return job;
+}
+
+/* Runs on the target core: the arena is bound to its node and the copies start hot in its caches */
+static void *input_core_job_func(void *data) {
+    input_core_job_t *job = (input_core_job_t *)data;
+
+    void *base = em_numa_alloc(job->total, em_numa_node_of_cpu(job->cpu));
+    if (!base) return NULL;
+
+    for (guint i = 0; i < job->copies->len; i++) {
+        input_copy_t *copy = &g_array_index(job->copies, input_copy_t, i);
+        guint8 *dst = (guint8 *)base + copy->offset;
+        memcpy(dst, copy->src, copy->size);
+        if (copy->span > INPUT_POOL_ALIGN_UP(copy->size)) memcpy(dst + INPUT_POOL_ALIGN_UP(copy->size), copy->src, copy->size);
+    }
+
+    job->base = base;
+    return NULL;
+}
+
+static gboolean input_core_job_run(input_core_job_t *job) {
+    if (job->cpu < 0) {
+        input_core_job_func(job);
+        return job->base != NULL;
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(job->cpu, &set);
+    pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &set);
+
+    pthread_t thread;
+    gint rc = pthread_create(&thread, &attr, input_core_job_func, job);
+    pthread_attr_destroy(&attr);
+    if (rc != 0) {
+        g_printerr("[WARNING] Execution Manager: inputs of CPU %d placed from the dispatcher (%s)\n", job->cpu, g_strerror(rc));
+        input_core_job_func(job);
+    } else {
+        pthread_join(thread, NULL);
+    }
+    return job->base != NULL;
+}
+
+
+/* ----------------- Input Pool Constructor/Destructor ----------------- */
+
+input_pool_t* input_pool_new(void) {
+    input_pool_t *pool = g_new0(input_pool_t, 1);
+    pool->adopted = g_hash_table_new_full(g_direct_hash, g_direct_equal, g_free, NULL);
+    pool->staged = g_ptr_array_new_with_free_func(g_aligned_free);
+    pool->arenas = g_array_new(FALSE, FALSE, sizeof(input_arena_t));
+    return pool;
+}
+
+void input_pool_free(input_pool_t *pool) {
+    if (!pool) return;
+
+    for (guint i = 0; i < pool->arenas->len; i++) {
+        input_arena_t *arena = &g_array_index(pool->arenas, input_arena_t, i);
+        em_numa_free(arena->base, arena->size);
+    }
+    g_array_free(pool->arenas, TRUE);
+    g_ptr_array_free(pool->staged, TRUE);
+    g_hash_table_destroy(pool->adopted);
+    g_free(pool);
+}
+
+
+/* ----------------- Input Pool Methods ----------------- */
+
+/* Inputs of unknown size stay where they are, several activations may share one: freed once with the pool */
+gpointer input_pool_adopt(input_pool_t *pool, gpointer input) {
+    g_return_val_if_fail(pool != NULL, input);
+
+    if (input) g_hash_table_add(pool->adopted, input);
+    return input;
+}
+
+gpointer input_pool_stage(input_pool_t *pool, gconstpointer data, gsize size, gboolean mutable_input) {
+    g_return_val_if_fail(pool != NULL && data != NULL && size > 0, NULL);
+
+    gsize span = INPUT_POOL_ALIGN_UP(size) * (mutable_input ? 2 : 1);
+    guint8 *copy = g_aligned_alloc0(1, span, INPUT_POOL_ALIGN);
+    memcpy(copy, data, size);
+    if (mutable_input) memcpy(copy + INPUT_POOL_ALIGN_UP(size), data, size);
+    g_ptr_array_add(pool->staged, copy);
+    return copy;
+}
+
+/* Called once before the first run: one arena per core, inputs shared by the activations of a core */
+gboolean input_pool_place(input_pool_t *pool, input_pool_request_t *requests, guint n_requests) {
+    g_return_val_if_fail(pool != NULL, FALSE);
+    if (pool->placed) return TRUE;
+    pool->placed = TRUE;
+
+    /* 1. Lay out the arena of every core */
+    GHashTable *jobs = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, input_core_job_free);
+    for (guint i = 0; i < n_requests; i++) {
+        input_pool_request_t *req = &requests[i];
+        if (!*req->input || req->size == 0) continue;
+
+        input_core_job_t *job = input_core_job_get(jobs, req->cpu);
+        if (g_hash_table_contains(job->index, *req->input)) continue;
+
+        input_copy_t copy = { *req->input, req->size, INPUT_POOL_ALIGN_UP(req->size) * (req->mutable_input ? 2 : 1), job->total };
+        g_array_append_val(job->copies, copy);
+        g_hash_table_insert(job->index, *req->input, GUINT_TO_POINTER(job->copies->len));
+        job->total += copy.span;
+    }
+
+    /* 2. Copy from the cores */
+    GHashTableIter iter;
+    gpointer value;
+    gboolean all_placed = TRUE;
+    g_hash_table_iter_init(&iter, jobs);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        input_core_job_t *job = value;
+        if (!input_core_job_run(job)) {
+            g_printerr("[WARNING] Execution Manager: inputs of CPU %d left in place (%s)\n", job->cpu, g_strerror(errno));
+            all_placed = FALSE;
+            continue;
+        }
+        input_arena_t arena = { job->base, job->total, job->cpu };
+        g_array_append_val(pool->arenas, arena);
+    }
+
+    /* 3. Redirect the activations, the staged copies stay valid for the jobs already released */
+    for (guint i = 0; i < n_requests; i++) {
+        input_pool_request_t *req = &requests[i];
+        if (!*req->input || req->size == 0) continue;
+
+        input_core_job_t *job = g_hash_table_lookup(jobs, GINT_TO_POINTER(req->cpu));
+        if (!job || !job->base) continue;
+        guint idx = GPOINTER_TO_UINT(g_hash_table_lookup(job->index, *req->input)) - 1;
+        *req->input = (guint8 *)job->base + g_array_index(job->copies, input_copy_t, idx).offset;
+    }
+
+    g_hash_table_destroy(jobs);
+    return all_placed;
+}
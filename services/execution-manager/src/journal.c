@@ -0,0 +1,243 @@
+#define _GNU_SOURCE
+#include "journal.h"
+#include "em_time.h"
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define JOURNAL_HEADER_SIZE 4096
+
+/* -----------------Helper Functions ----------------- */
+
+static gsize journal_map_size(guint64 capacity) {
+    return JOURNAL_HEADER_SIZE + (gsize)capacity * sizeof(journal_record_t);
+}
+
+static gboolean journal_header_valid(const journal_header_t *h, gsize file_size) {
+    return memcmp(h->magic, JOURNAL_MAGIC, sizeof(h->magic)) == 0
+        && h->version == JOURNAL_VERSION
+        && h->record_size == sizeof(journal_record_t)
+        && h->capacity > 0
+        && journal_map_size(h->capacity) == file_size
+        && h->n_schedules <= JOURNAL_MAX_SCHEDULES;
+}
+
+static journal_t *journal_map(const gchar *path, gint fd, gsize size, gboolean read_only) {
+    gint prot = read_only ? PROT_READ : (PROT_READ | PROT_WRITE);
+    gint flags = read_only ? MAP_SHARED : (MAP_SHARED | MAP_POPULATE);
+    void *map = mmap(NULL, size, prot, flags, fd, 0);
+    if (map == MAP_FAILED) {
+        g_printerr("[ERROR] Execution Manager: cannot map journal %s (%s)\n", path, g_strerror(errno));
+        return NULL;
+    }
+
+    journal_t *j = g_new0(journal_t, 1);
+    j->path = g_strdup(path);
+    j->fd = fd;
+    j->map_size = size;
+    j->header = (journal_header_t *)map;
+    j->records = (journal_record_t *)((guint8 *)map + JOURNAL_HEADER_SIZE);
+    j->read_only = read_only;
+    return j;
+}
+
+/* Runs started and never ended: the process died in the middle of them */
+static void journal_track_runs(const journal_record_t *rec, gpointer user_data) {
+    guint64 *open_runs = (guint64 *)user_data;
+    if (rec->schedule_id >= JOURNAL_MAX_SCHEDULES) return;
+
+    if (rec->type == JOURNAL_EVENT_RUN_START) open_runs[rec->schedule_id] = rec->seq;
+    else if (rec->type == JOURNAL_EVENT_RUN_END) open_runs[rec->schedule_id] = 0;
+}
+
+static void journal_report_resume(journal_t *j) {
+    guint64 open_runs[JOURNAL_MAX_SCHEDULES] = { 0 };
+    guint64 valid = journal_foreach(j, journal_track_runs, open_runs);
+
+    g_print("[INFO] Execution Manager: journal %s resumed at record %" G_GUINT64_FORMAT " (%" G_GUINT64_FORMAT " readable).\n",
+            j->path, j->header->head, valid);
+    for (guint16 id = 0; id < JOURNAL_MAX_SCHEDULES; id++) {
+        if (open_runs[id] == 0) continue;
+        g_printerr("[WARNING] Execution Manager: run of %s started at record %" G_GUINT64_FORMAT " was interrupted.\n",
+                   journal_schedule_name(j, id), open_runs[id] - 1);
+    }
+}
+
+
+/* ----------------- Journal Constructor/Destructor ----------------- */
+
+/* A valid journal with the same capacity is appended to, anything else is recreated */
+journal_t* journal_open(const gchar *path, guint64 capacity) {
+    g_return_val_if_fail(path != NULL, NULL);
+    g_return_val_if_fail(capacity > 0, NULL);
+
+    gint fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        g_printerr("[ERROR] Execution Manager: cannot open journal %s (%s)\n", path, g_strerror(errno));
+        return NULL;
+    }
+
+    gsize size = journal_map_size(capacity);
+    struct stat st;
+    gboolean resume = FALSE;
+    if (fstat(fd, &st) == 0 && (gsize)st.st_size == size) {
+        journal_header_t h;
+        resume = (pread(fd, &h, sizeof(h), 0) == (ssize_t)sizeof(h)) && journal_header_valid(&h, size) && h.capacity == capacity;
+    }
+
+    /* 1. Blocks reserved up front: a store in the mapping can never hit a full disk */
+    if (!resume) {
+        gint rc = (ftruncate(fd, 0) == 0) ? posix_fallocate(fd, 0, (off_t)size) : errno;
+        if (rc != 0) {
+            g_printerr("[ERROR] Execution Manager: cannot allocate journal %s (%s)\n", path, g_strerror(rc));
+            close(fd);
+            return NULL;
+        }
+    }
+
+    /* 2. Mapped and prefaulted before time zero */
+    journal_t *j = journal_map(path, fd, size, FALSE);
+    if (!j) {
+        close(fd);
+        return NULL;
+    }
+    if (mlock(j->header, size) < 0) {
+        g_printerr("[WARNING] Execution Manager: journal %s not locked in memory (%s)\n", path, g_strerror(errno));
+    }
+
+    if (resume) {
+        journal_report_resume(j);
+        return j;
+    }
+
+    memcpy(j->header->magic, JOURNAL_MAGIC, sizeof(j->header->magic));
+    j->header->version = JOURNAL_VERSION;
+    j->header->record_size = sizeof(journal_record_t);
+    j->header->capacity = capacity;
+    j->header->created_us = g_get_real_time();
+    msync(j->header, JOURNAL_HEADER_SIZE, MS_SYNC);
+
+    g_print("[INFO] Execution Manager: journal %s created (%" G_GUINT64_FORMAT " records).\n", path, capacity);
+    return j;
+}
+
+journal_t* journal_open_readonly(const gchar *path) {
+    g_return_val_if_fail(path != NULL, NULL);
+
+    gint fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        g_printerr("[ERROR] Execution Manager: cannot open journal %s (%s)\n", path, g_strerror(errno));
+        return NULL;
+    }
+
+    journal_header_t h;
+    struct stat st;
+    if (fstat(fd, &st) < 0 || pread(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h) || !journal_header_valid(&h, (gsize)st.st_size)) {
+        g_printerr("[ERROR] Execution Manager: %s is not a journal\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    journal_t *j = journal_map(path, fd, (gsize)st.st_size, TRUE);
+    if (!j) close(fd);
+    return j;
+}
+
+void journal_close(journal_t *j) {
+    if (!j) return;
+
+    if (!j->read_only) msync(j->header, j->map_size, MS_SYNC);
+    munmap(j->header, j->map_size);
+    close(j->fd);
+    g_free(j->path);
+    g_free(j);
+}
+
+
+/* ----------------- Journal Methods ----------------- */
+
+/* Called by the dispatcher before time zero, never from the RT path */
+guint16 journal_register_schedule(journal_t *j, const gchar *name, const gchar *version) {
+    g_return_val_if_fail(j != NULL && !j->read_only && name != NULL, JOURNAL_UNKNOWN_SCHEDULE);
+
+    gchar key[JOURNAL_NAME_LEN];
+    g_snprintf(key, sizeof(key), "%s@%s", name, version ? version : "0.0.0");
+
+    guint32 n = j->header->n_schedules;
+    for (guint32 id = 0; id < n; id++) {
+        if (strncmp(j->header->schedules[id], key, JOURNAL_NAME_LEN) == 0) return (guint16)id;
+    }
+    if (n == JOURNAL_MAX_SCHEDULES) {
+        g_printerr("[WARNING] Execution Manager: journal schedule table full, %s recorded as unknown.\n", key);
+        return JOURNAL_UNKNOWN_SCHEDULE;
+    }
+
+    g_strlcpy(j->header->schedules[n], key, JOURNAL_NAME_LEN);
+    __atomic_store_n(&j->header->n_schedules, n + 1, __ATOMIC_RELEASE);
+    return (guint16)n;
+}
+
+const gchar *journal_schedule_name(journal_t *j, guint16 schedule_id) {
+    if (!j || schedule_id >= __atomic_load_n(&j->header->n_schedules, __ATOMIC_ACQUIRE)) return "unknown";
+    return j->header->schedules[schedule_id];
+}
+
+/* Hot path: memory stores only, the kernel writes the pages back (they survive a crash of the process) */
+void journal_append(journal_t *j, journal_event_type_t type, guint16 schedule_id, guint16 task_id, gint cpu, guint32 remaining_runs, gint64 arg, const gchar *output) {
+    if (!j || j->read_only) return;
+
+    guint64 seq = __atomic_fetch_add(&j->header->head, 1, __ATOMIC_RELAXED);
+    journal_record_t *rec = &j->records[seq % j->header->capacity];
+
+    /* 1. Invalidate the slot, a crash from here on leaves a record the reader skips */
+    __atomic_store_n(&rec->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    /* 2. Payload */
+    rec->timestamp_ns = em_time_now_ns(CLOCK_MONOTONIC);
+    rec->arg = arg;
+    rec->remaining_runs = remaining_runs;
+    rec->task_id = task_id;
+    rec->cpu = (gint16)cpu;
+    rec->schedule_id = schedule_id;
+    rec->type = (guint8)type;
+    rec->flags = 0;
+    rec->output_len = 0;
+    if (output) {
+        gsize len = strlen(output);
+        if (len > JOURNAL_OUTPUT_LEN) {
+            len = JOURNAL_OUTPUT_LEN;
+            rec->flags |= JOURNAL_FLAG_TRUNCATED;
+        }
+        memcpy(rec->output, output, len);
+        rec->output_len = (guint8)len;
+    }
+
+    /* 3. Commit */
+    __atomic_store_n(&rec->seq, seq + 1, __ATOMIC_RELEASE);
+}
+
+/* Visits the records still in the ring, oldest first; returns how many were valid */
+guint64 journal_foreach(journal_t *j, journal_func_t func, gpointer user_data) {
+    g_return_val_if_fail(j != NULL && func != NULL, 0);
+
+    guint64 capacity = j->header->capacity;
+    guint64 head = __atomic_load_n(&j->header->head, __ATOMIC_ACQUIRE);
+    guint64 valid = 0;
+
+    for (guint64 seq = (head > capacity) ? head - capacity : 0; seq < head; seq++) {
+        const journal_record_t *rec = &j->records[seq % capacity];
+        if (__atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) != seq + 1) continue;     // Torn or overwritten
+        func(rec, user_data);
+        valid++;
+    }
+    return valid;
+}
+
+/* Schedules the write back of the dirty pages, without waiting for it */
+void journal_sync(journal_t *j) {
+    if (j && !j->read_only) msync(j->header, j->map_size, MS_ASYNC);
+}
@@ -0,0 +1,246 @@
+#define _GNU_SOURCE
+#include "load_monitor.h"
+#include "em_time.h"
+#include <errno.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+/* -----------------Helper Functions ----------------- */
+
+static inline void counter_add(guint64 *counter, guint64 value) {
+    __atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+}
+
+static inline guint64 counter_get(const guint64 *counter) {
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+static inline gint to_permille(gdouble fraction) {
+    return (gint)(fraction * 1000.0 + 0.5);
+}
+
+/* Fold the per-task counters of the last tick into the task windows */
+static void load_monitor_tick_tasks(load_monitor_t *lm, gint64 window_ns) {
+    guint head = lm->head;
+    for (guint id = 0; id < LOAD_MONITOR_MAX_TASKS; id++) {
+        load_task_counter_t *in = &lm->tasks_in[id];
+        guint64 jobs = counter_get(&in->jobs);
+        load_task_t *t = g_hash_table_lookup(lm->tasks, GUINT_TO_POINTER(id));
+        if (!t) {
+            if (jobs == 0) continue;
+            t = g_new0(load_task_t, 1);
+            t->task_id = (guint16)id;
+            g_mutex_lock(&lm->lock);
+            g_hash_table_insert(lm->tasks, GUINT_TO_POINTER(id), t);
+            g_mutex_unlock(&lm->lock);
+        }
+
+        guint64 busy = counter_get(&in->busy_ns);
+        gint64 max_ns = (gint64)__atomic_exchange_n(&in->max_ns, 0, __ATOMIC_RELAXED);
+        gint64 busy_delta = (gint64)(busy - t->last_busy_ns);
+        guint64 jobs_delta = jobs - t->last_jobs;
+        t->last_busy_ns = busy;
+        t->last_jobs = jobs;
+
+        t->window_busy_ns += busy_delta - t->ring_busy[head];
+        t->window_jobs += jobs_delta - t->ring_jobs[head];
+        t->ring_busy[head] = busy_delta;
+        t->ring_jobs[head] = jobs_delta;
+        t->ring_max[head] = max_ns;
+
+        gint64 worst_ns = 0;
+        for (guint i = 0; i < LOAD_MONITOR_WINDOW; i++) worst_ns = MAX(worst_ns, t->ring_max[i]);
+        t->worst_ns = worst_ns;
+        g_atomic_int_set(&t->utilization, to_permille((gdouble)t->window_busy_ns / window_ns));
+    }
+}
+
+/* Planned releases of every core times the worst CPU time of the task (its budget before the first job) */
+static void load_monitor_project(load_monitor_t *lm, gdouble *projected) {
+    g_mutex_lock(&lm->lock);
+    for (guint i = 0; i < lm->plan->len; i++) {
+        load_plan_t *p = &g_array_index(lm->plan, load_plan_t, i);
+        if (p->cpu < 0 || p->cpu >= LOAD_MONITOR_MAX_CPUS) continue;
+        load_task_t *t = g_hash_table_lookup(lm->tasks, GUINT_TO_POINTER((guint)p->task_id));
+        gint64 cost_ns = (t && t->worst_ns > 0) ? t->worst_ns : p->declared_ns;
+        projected[p->cpu] += p->releases_per_s * (gdouble)cost_ns / EM_NSEC_PER_SEC;
+    }
+    g_mutex_unlock(&lm->lock);
+}
+
+/* Edge triggered: one event per overload, cleared under threshold - hysteresis */
+static void load_monitor_check(load_monitor_t *lm, gint cpu, metrics_t *metrics, trace_buffer_t *trace) {
+    load_core_t *core = &lm->cores[cpu];
+    gint measured = g_atomic_int_get(&core->utilization);
+    gint projected = g_atomic_int_get(&core->projected);
+    gint level = MAX(measured, projected);
+
+    if (!core->overloaded && level >= to_permille(lm->threshold)) {
+        core->overloaded = TRUE;
+        counter_add(&core->overloads, 1);
+        metrics_inc_overload(metrics, cpu);
+        trace_record(trace, TRACE_EVENT_OVERLOAD, 0, cpu, level);
+        g_printerr("[WARNING] Execution Manager: CPU %d overloaded, measured %.1f%%, projected %.1f%% (threshold %.0f%%).\n",
+                   cpu, measured / 10.0, projected / 10.0, lm->threshold * 100.0);
+    } else if (core->overloaded && level < to_permille(lm->threshold - LOAD_MONITOR_HYSTERESIS)) {
+        core->overloaded = FALSE;
+        g_print("[INFO] Execution Manager: CPU %d back to %.1f%% load.\n", cpu, level / 10.0);
+    }
+}
+
+static gpointer load_monitor_func(gpointer data) {
+    load_monitor_t *lm = (load_monitor_t *)data;
+
+    /* Nice 19: the monitor only runs on time the RT threads and the other services leave */
+    if (setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), 19) < 0) {
+        g_printerr("[WARNING] Execution Manager: load monitor nice level not set (%s)\n", g_strerror(errno));
+    }
+
+    gint64 tick_ns = (gint64)lm->tick_ms * EM_NSEC_PER_MSEC;
+    gint64 window_ns = tick_ns * LOAD_MONITOR_WINDOW;
+    gint64 next_ns = em_time_now_ns(CLOCK_MONOTONIC);
+    while (!g_atomic_int_get(&lm->stop)) {
+        next_ns += tick_ns;
+        struct timespec ts = em_time_to_timespec(next_ns);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+            /* Restart after signals */
+        }
+        metrics_t *metrics = __atomic_load_n(&lm->metrics, __ATOMIC_ACQUIRE);
+        trace_buffer_t *trace = __atomic_load_n(&lm->trace, __ATOMIC_ACQUIRE);
+
+        /* 1. Advance the windows by one tick */
+        lm->head = (lm->head + 1) % LOAD_MONITOR_WINDOW;
+        for (gint cpu = 0; cpu < LOAD_MONITOR_MAX_CPUS; cpu++) {
+            load_core_t *core = &lm->cores[cpu];
+            guint64 busy = counter_get(&lm->cores_in[cpu].busy_ns);
+            gint64 delta = (gint64)(busy - core->last_busy_ns);
+            core->last_busy_ns = busy;
+            core->window_busy_ns += delta - core->ring[lm->head];
+            core->ring[lm->head] = delta;
+            g_atomic_int_set(&core->utilization, to_permille((gdouble)core->window_busy_ns / window_ns));
+        }
+        load_monitor_tick_tasks(lm, window_ns);
+
+        /* 2. Projection and overload detection */
+        gdouble projected[LOAD_MONITOR_MAX_CPUS] = { 0 };
+        load_monitor_project(lm, projected);
+        for (gint cpu = 0; cpu < LOAD_MONITOR_MAX_CPUS; cpu++) {
+            load_core_t *core = &lm->cores[cpu];
+            g_atomic_int_set(&core->projected, to_permille(projected[cpu]));
+            if (core->window_busy_ns == 0 && projected[cpu] == 0 && !core->overloaded) continue;
+            metrics_set_core_load(metrics, cpu, g_atomic_int_get(&core->utilization), g_atomic_int_get(&core->projected));
+            load_monitor_check(lm, cpu, metrics, trace);
+        }
+    }
+    return NULL;
+}
+
+
+
+/* ----------------- Load Monitor Constructor/Destructor ----------------- */
+
+load_monitor_t* load_monitor_new(gdouble threshold, guint tick_ms) {
+    g_return_val_if_fail(threshold > LOAD_MONITOR_HYSTERESIS, NULL);
+
+    load_monitor_t *lm = g_aligned_alloc0(1, sizeof(load_monitor_t), 64);
+    lm->threshold = threshold;
+    lm->tick_ms = tick_ms > 0 ? tick_ms : LOAD_MONITOR_DEFAULT_TICK_MS;
+    lm->tasks = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    lm->plan = g_array_new(FALSE, FALSE, sizeof(load_plan_t));
+    g_mutex_init(&lm->lock);
+    lm->thread = g_thread_new("em-load-monitor", load_monitor_func, lm);
+
+    g_print("[INFO] Execution Manager: load monitor every %u ms over %u ms, overload above %.0f%%\n",
+            lm->tick_ms, lm->tick_ms * LOAD_MONITOR_WINDOW, threshold * 100.0);
+    return lm;
+}
+
+void load_monitor_free(load_monitor_t *lm) {
+    if (!lm) return;
+
+    g_atomic_int_set(&lm->stop, 1);
+    g_thread_join(lm->thread);
+    g_hash_table_destroy(lm->tasks);
+    g_array_free(lm->plan, TRUE);
+    g_mutex_clear(&lm->lock);
+    g_aligned_free(lm);
+}
+
+
+/* ----------------- Load Monitor Plan ----------------- */
+
+void load_monitor_plan_reset(load_monitor_t *lm, metrics_t *metrics, trace_buffer_t *trace) {
+    g_return_if_fail(lm != NULL);
+
+    __atomic_store_n(&lm->metrics, metrics, __ATOMIC_RELEASE);
+    __atomic_store_n(&lm->trace, trace, __ATOMIC_RELEASE);
+    g_mutex_lock(&lm->lock);
+    g_array_set_size(lm->plan, 0);
+    g_mutex_unlock(&lm->lock);
+}
+
+void load_monitor_plan_task(load_monitor_t *lm, guint16 task_id, gint cpu, gdouble releases_per_s, gint64 declared_ns) {
+    g_return_if_fail(lm != NULL);
+
+    load_plan_t p = { task_id, cpu, releases_per_s, declared_ns };
+    g_mutex_lock(&lm->lock);
+    g_array_append_val(lm->plan, p);
+    g_mutex_unlock(&lm->lock);
+}
+
+
+/* ----------------- Load Monitor Updates ----------------- */
+
+void load_monitor_add_job(load_monitor_t *lm, guint16 task_id, gint cpu, gint64 cpu_ns) {
+    if (!lm || cpu < 0 || cpu >= LOAD_MONITOR_MAX_CPUS || cpu_ns < 0) return;
+
+    counter_add(&lm->cores_in[cpu].busy_ns, (guint64)cpu_ns);
+    counter_add(&lm->cores_in[cpu].jobs, 1);
+    if (task_id >= LOAD_MONITOR_MAX_TASKS) return;
+
+    load_task_counter_t *in = &lm->tasks_in[task_id];
+    counter_add(&in->busy_ns, (guint64)cpu_ns);
+    counter_add(&in->jobs, 1);
+    guint64 max_ns = counter_get(&in->max_ns);
+    while ((guint64)cpu_ns > max_ns &&
+           !__atomic_compare_exchange_n(&in->max_ns, &max_ns, (guint64)cpu_ns, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        /* max_ns reloaded by the failed exchange */
+    }
+}
+
+
+/* ----------------- Load Monitor Reports ----------------- */
+
+gdouble load_monitor_core_utilization(load_monitor_t *lm, gint cpu) {
+    g_return_val_if_fail(lm != NULL && cpu >= 0 && cpu < LOAD_MONITOR_MAX_CPUS, 0.0);
+    return g_atomic_int_get(&lm->cores[cpu].utilization) / 1000.0;
+}
+
+gdouble load_monitor_core_projected(load_monitor_t *lm, gint cpu) {
+    g_return_val_if_fail(lm != NULL && cpu >= 0 && cpu < LOAD_MONITOR_MAX_CPUS, 0.0);
+    return g_atomic_int_get(&lm->cores[cpu].projected) / 1000.0;
+}
+
+/* Snapshot for the operator: the windows keep moving while they are printed */
+void load_monitor_print(load_monitor_t *lm) {
+    if (!lm) return;
+
+    g_print("=============== Core Load (last %u ms) ===============\n", lm->tick_ms * LOAD_MONITOR_WINDOW);
+    for (gint cpu = 0; cpu < LOAD_MONITOR_MAX_CPUS; cpu++) {
+        load_core_t *core = &lm->cores[cpu];
+        guint64 overloads = counter_get(&core->overloads);
+        if (counter_get(&lm->cores_in[cpu].jobs) == 0 && overloads == 0) continue;
+        g_print("CPU %2d: measured %5.1f%%, projected %5.1f%%, %" G_GUINT64_FORMAT " overload(s)\n",
+                cpu, g_atomic_int_get(&core->utilization) / 10.0, g_atomic_int_get(&core->projected) / 10.0, overloads);
+    }
+    g_mutex_lock(&lm->lock);
+    for (guint id = 0; id < LOAD_MONITOR_MAX_TASKS; id++) {
+        load_task_t *t = g_hash_table_lookup(lm->tasks, GUINT_TO_POINTER(id));
+        if (!t || t->window_jobs == 0) continue;
+        g_print("Task %4u: %5.1f%% of a core, %" G_GUINT64_FORMAT " job(s), worst %.3f ms\n",
+                t->task_id, g_atomic_int_get(&t->utilization) / 10.0, t->window_jobs, (gdouble)t->worst_ns / EM_NSEC_PER_MSEC);
+    }
+    g_mutex_unlock(&lm->lock);
+    g_print("=======================================================\n");
+}
@@ -3,10 +3,15 @@
 #include <unistd.h> // For sleep()
 #include <sched.h>
 #include <sys/mman.h>
+#include <string.h>
 
 #include "schedule.h"
 #include "execution_manager.h"
+#include "simulator.h"
+#include "cyclic_executive.h"
 #include "app_task.h"
+#include "rt_audit.h"
+#include "static_schedule.h"
 
 
 
@@ -42,7 +47,145 @@ int main(int argc, char *argv[]) {
         g_error("[ERROR] Execution Manager: em_new failed.");
         return 1;
     }
+
+    /* Optional tracepoints export (EM_TRACE_DIR=<dir>, EM_TRACE_MARKER=1) */
+    const gchar *trace_dir = g_getenv("EM_TRACE_DIR");
+    if (trace_dir) {
+        gboolean use_marker = (g_strcmp0(g_getenv("EM_TRACE_MARKER"), "1") == 0);
+        em_enable_trace(em, trace_dir, DEFAULT_TRACE_CAPACITY, use_marker);
+        g_print("[INFO] Execution Manager: tracing enabled, traces written to %s\n", trace_dir);
+    }
     
+    /* Optional metrics endpoint (EM_METRICS_SOCKET=<unix socket path>) */
+    const gchar *metrics_socket = g_getenv("EM_METRICS_SOCKET");
+    if (metrics_socket && !em_enable_metrics(em, metrics_socket)) {
+        g_printerr("[WARNING] Execution Manager: metrics endpoint disabled.\n");
+    }
+
+    /* Optional runtime admission socket (EM_CONTROL_SOCKET=<unix socket path>), add commands name "sum" */
+    const gchar *control_socket = g_getenv("EM_CONTROL_SOCKET");
+    if (control_socket) {
+        em_register_control_task(em, "sum", task_main);
+        if (!em_enable_control(em, control_socket)) g_printerr("[WARNING] Execution Manager: control socket disabled.\n");
+    }
+
+    /* Optional aperiodic servers (EM_APERIODIC_SERVER=<cpu>:<budget us>:<period us>[:<priority>],...), fed by submit commands */
+    const gchar *servers = g_getenv("EM_APERIODIC_SERVER");
+    if (servers) {
+        gchar **items = g_strsplit(servers, ",", -1);
+        for (gchar **item = items; *item; item++) {
+            gchar **fields = g_strsplit(*item, ":", 4);
+            if (g_strv_length(fields) < 3 ||
+                !em_add_aperiodic_server(em, (gint)g_ascii_strtoll(fields[0], NULL, 10),
+                                         fields[3] ? (gint)g_ascii_strtoll(fields[3], NULL, 10) : APERIODIC_DEFAULT_PRIORITY,
+                                         g_ascii_strtoll(fields[1], NULL, 10), g_ascii_strtoll(fields[2], NULL, 10))) {
+                g_printerr("[WARNING] Execution Manager: aperiodic server '%s' ignored.\n", *item);
+            }
+            g_strfreev(fields);
+        }
+        g_strfreev(items);
+    }
+
+    /* Optional coordination of several instances (EM_SYNC=master[:<port>] or <master host>[:<port>],
+     * EM_SYNC_PERIOD_MS=<start boundary period>, EM_SYNC_INTERVAL_MS=<exchange period>) */
+    const gchar *sync_spec = g_getenv("EM_SYNC");
+    if (sync_spec) {
+        gchar **parts = g_strsplit(sync_spec, ":", 2);
+        gint port = parts[1] ? (gint)g_ascii_strtoll(parts[1], NULL, 10) : CLOCK_SYNC_DEFAULT_PORT;
+        const gchar *master_host = g_strcmp0(parts[0], "master") == 0 ? NULL : parts[0];
+        const gchar *period_ms = g_getenv("EM_SYNC_PERIOD_MS");
+        const gchar *interval_ms = g_getenv("EM_SYNC_INTERVAL_MS");
+        if (!em_enable_clock_sync(em, master_host, port, interval_ms ? (guint)g_ascii_strtoll(interval_ms, NULL, 10) : 0,
+                                  period_ms ? g_ascii_strtoll(period_ms, NULL, 10) * 1000 : 0)) {
+            g_printerr("[WARNING] Execution Manager: clock synchronization disabled.\n");
+        } else if (master_host && !clock_sync_wait_locked(em->sync, 2 * G_USEC_PER_SEC)) {
+            g_printerr("[WARNING] Execution Manager: no answer from the clock master %s yet.\n", master_host);
+        }
+        g_strfreev(parts);
+    }
+
+    /* Optional overload monitor (EM_LOAD_MONITOR=<threshold percent of a core>, EM_LOAD_MONITOR_TICK_MS=<window tick>) */
+    const gchar *load_threshold = g_getenv("EM_LOAD_MONITOR");
+    if (load_threshold) {
+        const gchar *tick_ms = g_getenv("EM_LOAD_MONITOR_TICK_MS");
+        em_enable_load_monitor(em, g_ascii_strtod(load_threshold, NULL) / 100.0, tick_ms ? (guint)g_ascii_strtoll(tick_ms, NULL, 10) : 0);
+    }
+
+    /* Optional result export (EM_RESULT_STORE=<host>:<port>, EM_RESULT_STREAM=<stream key>) */
+    const gchar *result_store = g_getenv("EM_RESULT_STORE");
+    if (result_store) {
+        const gchar *stream = g_getenv("EM_RESULT_STREAM");
+        gchar **parts = g_strsplit(result_store, ":", 2);
+        gint port = parts[1] ? (gint)g_ascii_strtoll(parts[1], NULL, 10) : 6379;
+        if (!em_enable_result_export(em, parts[0], port, stream ? stream : "em:results")) {
+            g_printerr("[WARNING] Execution Manager: result export disabled.\n");
+        }
+        g_strfreev(parts);
+    }
+
+    /* Optional crash-safe event journal (EM_JOURNAL=<file>, EM_JOURNAL_RECORDS=<ring size>) */
+    const gchar *journal_path = g_getenv("EM_JOURNAL");
+    if (journal_path) {
+        const gchar *records = g_getenv("EM_JOURNAL_RECORDS");
+        if (!em_enable_journal(em, journal_path, records ? g_ascii_strtoull(records, NULL, 10) : 0)) {
+            g_printerr("[WARNING] Execution Manager: journal disabled.\n");
+        }
+    }
+
+    /* Optional pinning of the deadline timer thread (EM_DEADLINE_CPU=<cpu>) */
+    const gchar *deadline_cpu = g_getenv("EM_DEADLINE_CPU");
+    if (deadline_cpu) {
+        em_set_deadline_timer(em, em->deadline_priority, (gint)g_ascii_strtoll(deadline_cpu, NULL, 10));
+    }
+
+    /* Optional sleep-then-spin releases (EM_PRECISE_RELEASE=<initial guard us>, EM_RELEASE_GUARD=<cpu>:<us>,...) */
+    const gchar *precise_release = g_getenv("EM_PRECISE_RELEASE");
+    if (precise_release) {
+        em_enable_precise_release(em, g_ascii_strtoll(precise_release, NULL, 10));
+
+        const gchar *guards = g_getenv("EM_RELEASE_GUARD");
+        gchar **items = g_strsplit(guards ? guards : "", ",", -1);
+        for (gchar **item = items; *item; item++) {
+            gchar *sep = strchr(*item, ':');
+            if (!sep) continue;
+            em_set_release_guard(em, (gint)g_ascii_strtoll(*item, NULL, 10), g_ascii_strtoll(sep + 1, NULL, 10));
+        }
+        g_strfreev(items);
+        g_print("[INFO] Execution Manager: precise releases enabled.\n");
+    }
+
+    /* Optional virtual time backend (EM_BACKEND=sim, EM_SIM_MODEL=fixed|profile|measured) */
+    sim_config_t *sim_cfg = NULL;
+    if (g_strcmp0(g_getenv("EM_BACKEND"), "sim") == 0) {
+        const gchar *model_name = g_getenv("EM_SIM_MODEL");
+        const gchar *exec_us = g_getenv("EM_SIM_EXEC_US");
+        const gchar *seed = g_getenv("EM_SIM_SEED");
+        const gchar *profile = g_getenv("EM_SIM_WCET_PROFILE");
+
+        sim_exec_model_t model = SIM_EXEC_FIXED;
+        if (g_strcmp0(model_name, "profile") == 0) model = SIM_EXEC_PROFILE;
+        else if (g_strcmp0(model_name, "measured") == 0) model = SIM_EXEC_MEASURED;
+
+        sim_cfg = sim_config_new(model, exec_us ? g_ascii_strtoll(exec_us, NULL, 10) : 100,
+                                 seed ? (guint32)g_ascii_strtoull(seed, NULL, 10) : 1);
+        if (profile) sim_config_load_wcet_profile(sim_cfg, profile);
+        g_print("[INFO] Execution Manager: simulation backend enabled.\n");
+    }
+
+    /* Optional static cyclic executive (EM_BACKEND=cyclic, EM_CE_CYCLES=<hyperperiods per run>) */
+    guint ce_cycles = 0;
+    if (g_strcmp0(g_getenv("EM_BACKEND"), "cyclic") == 0) {
+        const gchar *cycles = g_getenv("EM_CE_CYCLES");
+        ce_cycles = cycles ? (guint)g_ascii_strtoull(cycles, NULL, 10) : 1;
+        ce_cycles = MAX(ce_cycles, 1);
+        g_print("[INFO] Execution Manager: cyclic executive backend enabled (%u hyperperiod(s) per run).\n", ce_cycles);
+    }
+
+    /* RT environment audit before the first run (EM_RT_AUDIT=report: no tuning, EM_RT_AUDIT=off: skipped) */
+    const gchar *audit_mode = g_getenv("EM_RT_AUDIT");
+    rt_audit_t *audit = (g_strcmp0(audit_mode, "off") == 0) ? NULL : rt_audit_new();
+    gboolean audit_apply = (g_strcmp0(audit_mode, "report") != 0);
+
     schedule_t *sched = NULL; // Init to NULL
 
     g_print("=== Execution Manager Initialized ===\n");
@@ -57,28 +200,85 @@ int main(int argc, char *argv[]) {
             sched = NULL;   // Avoid double-free at exit 
         }
 
+#ifdef EM_STATIC_SCHEDULE
+        /* Schedule compiled into the binary (cmake -DEM_STATIC_SCHEDULE=<description>) */
+        sched = schedule_new_static(&em_static_schedule);
+        if (!sched) {
+            g_error("[ERROR] Execution Manager (%s) : static schedule load failed.", em_static_schedule.name);
+        }
+        if (g_strcmp0(g_getenv("EM_SCHEDULE_CLOCK"), "tai") == 0) schedule_set_clock(sched, CLOCK_TAI);
+#else
         /* Create a schedule */
         gchar *schedule_name = "schedule";
         sched = schedule_new(schedule_name, "0.0.1");
         if (!sched) {
             g_error("[ERROR] Execution Manager (%s) : scheduler creation failed.", schedule_name);
         }
+        if (g_strcmp0(g_getenv("EM_SCHEDULE_CLOCK"), "tai") == 0) schedule_set_clock(sched, CLOCK_TAI);
 
-        input_t *sum_input = g_new0(input_t, 1);
-        sum_input->a = 10;
-        sum_input->b = 5;
+        input_t sum_input = { .a = 10, .b = 5 };
 
 
-        schedule_add_task(sched, 1, "sum", task_main, SCHED_FIFO, 1, 0, 1, NULL, 1 * 1000, 2 * 1000, sum_input);
+        /* The task comes from a plugin when EM_TASK_PLUGIN is set, the compiled-in task_main otherwise */
+        const gchar *task_plugin = g_getenv("EM_TASK_PLUGIN");
+        if (task_plugin) {
+            if (!schedule_add_plugin_task(sched, 1, "sum", task_plugin, NULL, SCHED_FIFO, 1, 0, 1, NULL, 1 * 1000, 2 * 1000, NULL)) {
+                g_printerr("[ERROR] Execution Manager: task plugin %s unusable.\n", task_plugin);
+                keep_running = FALSE;
+                continue;
+            }
+        } else {
+            schedule_add_task(sched, 1, "sum", task_main, SCHED_FIFO, 1, 0, 1, NULL, 1 * 1000, 2 * 1000, NULL);
+        }
+        /* Copied in the schedule input pool, shared read-only by every run */
+        schedule_set_task_input(sched, 1, &sum_input, sizeof(sum_input), TASK_INPUT_SHARED);
 
         //schedule_add_task(sched, 2, "subtract", SCHED_FIFO, 8, 1, NULL, 1 * 1000, 7 * 1000, "[{\"a\":20, \"b\":8}]");
 
         //schedule_add_task(sched, 3, "multiply", SCHED_FIFO, 6, 1, NULL, 2 * 1000, 7 * 1000, "[{\"a\":4, \"b\":7}]");
+#endif
+
+        /* Optional CPU time budget of task 1 (EM_CPU_BUDGET=<us>[:notify|demote|abort]) */
+        const gchar *cpu_budget = g_getenv("EM_CPU_BUDGET");
+        if (cpu_budget) {
+            gchar **parts = g_strsplit(cpu_budget, ":", 2);
+            task_budget_action_t action = TASK_BUDGET_NOTIFY;
+            if (parts[0] && parts[1]) {
+                if (g_strcmp0(parts[1], "demote") == 0) action = TASK_BUDGET_DEMOTE;
+                else if (g_strcmp0(parts[1], "abort") == 0) action = TASK_BUDGET_ABORT;
+                else if (g_strcmp0(parts[1], "notify") != 0) g_printerr("[WARNING] Execution Manager: unknown CPU budget action %s, notify only.\n", parts[1]);
+            }
+            schedule_set_task_cpu_budget(sched, 1, g_ascii_strtoll(parts[0] ? parts[0] : "0", NULL, 10), action);
+            g_strfreev(parts);
+        }
 
         schedule_print(sched);
 
-        /* Run the schedule */
-        em_run_schedule(em, sched);
+        /* Simulate the schedule once in virtual time, or run it */
+        if (sim_cfg) {
+            em_simulate_schedule(em, sched, sim_cfg, NULL);
+            schedule_print(sched);
+            keep_running = FALSE;
+            continue;
+        }
+        if (audit && !audit->done) {
+            rt_audit_add_schedule(audit, sched, NULL, 0);
+            rt_audit_run(audit, audit_apply);
+            rt_audit_print(audit);
+        }
+        if (ce_cycles > 0) {
+            ce_table_t *table = ce_table_compile(sched, sched_get_priority_max(SCHED_FIFO) - 1);
+            if (!table) {
+                keep_running = FALSE;
+                continue;
+            }
+            ce_table_print(table);
+            em_run_cyclic(em, table, ce_cycles, NULL);
+            ce_table_free(table);
+        } else {
+            em_run_schedule(em, sched);
+        }
+        clock_sync_print(em->sync);
 
         if (keep_running) {
             g_print("\n[INFO] Execution Manager: Schedule Completed. Reboot in 5 seconds... (or push Ctrl+C for exit)...\n\n");
@@ -93,6 +293,8 @@ int main(int argc, char *argv[]) {
     g_print("\n[SYSTEM] Execution Manager: Exit from the main loop. Cleanup ...\n");
 
     if (em) em_free(em);
+    rt_audit_free(audit);       // Drops the cpu_dma_latency request
+    sim_config_free(sim_cfg);
     if (sched) schedule_free(sched);
     
     g_print("[SYSTEM] Execution Manager: Cleanup completed.\n");
@@ -0,0 +1,358 @@
+#include "metrics.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/* -----------------Helper Functions ----------------- */
+
+static inline core_counters_t *metrics_core(metrics_t *m, gint cpu) {
+    if (G_UNLIKELY(!m || cpu < 0 || cpu >= METRICS_MAX_CPUS)) return NULL;
+    return &m->cores[cpu];
+}
+
+static inline void counter_add(guint64 *counter, guint64 value) {
+    __atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+}
+
+static inline guint64 counter_get(const guint64 *counter) {
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+/* Bucket b holds latencies in [2^(b-1), 2^b) us, bucket 0 holds 0 us */
+static guint latency_bucket(gint64 latency_us) {
+    if (latency_us <= 0) return 0;
+    guint bucket = g_bit_storage((gulong)latency_us);
+    return MIN(bucket, METRICS_LATENCY_BUCKETS - 1);
+}
+
+static guint64 latency_quantile(const guint64 *buckets, guint64 total, gdouble q) {
+    if (total == 0) return 0;
+    guint64 rank = (guint64)(q * (gdouble)total);
+    guint64 seen = 0;
+    for (guint b = 0; b < METRICS_LATENCY_BUCKETS; b++) {
+        seen += buckets[b];
+        if (seen > rank) return (b == 0) ? 0 : (G_GUINT64_CONSTANT(1) << b);
+    }
+    return G_GUINT64_CONSTANT(1) << (METRICS_LATENCY_BUCKETS - 1);
+}
+
+static void render_per_core(GString *out, metrics_t *m, const gchar *name, const gchar *type, const gchar *help, gsize offset) {
+    g_string_append_printf(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+    for (gint cpu = 0; cpu < METRICS_MAX_CPUS; cpu++) {
+        core_counters_t *c = &m->cores[cpu];
+        if (counter_get(&c->activations) == 0 && counter_get(&c->server_jobs) == 0) continue;
+        const guint64 *value = (const guint64 *)((const guint8 *)c + offset);
+        g_string_append_printf(out, "%s{cpu=\"%d\"} %" G_GUINT64_FORMAT "\n", name, cpu, counter_get(value));
+    }
+}
+
+static void render_load_ratio(GString *out, metrics_t *m, const gchar *name, const gchar *help, gsize offset) {
+    g_string_append_printf(out, "# HELP %s %s\n# TYPE %s gauge\n", name, help, name);
+    for (gint cpu = 0; cpu < METRICS_MAX_CPUS; cpu++) {
+        core_counters_t *c = &m->cores[cpu];
+        if (counter_get(&c->load_permille) == 0 && counter_get(&c->projected_permille) == 0) continue;
+        const guint64 *value = (const guint64 *)((const guint8 *)c + offset);
+        g_string_append_printf(out, "%s{cpu=\"%d\"} %.3f\n", name, cpu, counter_get(value) / 1000.0);
+    }
+}
+
+static void handle_client(metrics_t *m, gint fd) {
+    /* Peek at the request: plain connections get the text body, HTTP clients get a response header */
+    gchar request[256] = {0};
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    if (poll(&pfd, 1, 50) > 0) {
+        if (read(fd, request, sizeof(request) - 1) < 0) request[0] = '\0';
+    }
+
+    GString *body = metrics_render(m);
+    GString *reply = g_string_new(NULL);
+    if (g_str_has_prefix(request, "GET ")) {
+        g_string_append_printf(reply, "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %" G_GSIZE_FORMAT "\r\n\r\n", body->len);
+    }
+    g_string_append_len(reply, body->str, body->len);
+
+    gsize written = 0;
+    while (written < reply->len) {
+        gssize n = write(fd, reply->str + written, reply->len - written);
+        if (n <= 0) break;
+        written += n;
+    }
+
+    g_string_free(reply, TRUE);
+    g_string_free(body, TRUE);
+}
+
+static gpointer metrics_server_func(gpointer data) {
+    metrics_t *m = (metrics_t *)data;
+
+    while (!g_atomic_int_get(&m->stop)) {
+        struct pollfd pfd = { .fd = m->listen_fd, .events = POLLIN };
+        gint rc = poll(&pfd, 1, 200);
+        if (rc <= 0) continue;
+
+        gint client = accept(m->listen_fd, NULL, NULL);
+        if (client < 0) continue;
+        handle_client(m, client);
+        close(client);
+    }
+    return NULL;
+}
+
+
+
+/* ----------------- Metrics Constructor/Destructor ----------------- */
+
+metrics_t* metrics_new(void) {
+    metrics_t *m = g_aligned_alloc0(1, sizeof(metrics_t), 64);
+    g_mutex_init(&m->info_lock);
+    m->listen_fd = -1;
+    return m;
+}
+
+void metrics_free(metrics_t *m) {
+    if (!m) return;
+
+    metrics_stop_server(m);
+    g_mutex_clear(&m->info_lock);
+    g_aligned_free(m);
+}
+
+
+/* ----------------- Metrics Endpoint ----------------- */
+
+gboolean metrics_start_server(metrics_t *m, const gchar *socket_path) {
+    g_return_val_if_fail(m != NULL, FALSE);
+    g_return_val_if_fail(socket_path != NULL, FALSE);
+    g_return_val_if_fail(m->server_thread == NULL, FALSE);
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        g_printerr("[ERROR] Execution Manager: metrics socket path too long: %s\n", socket_path);
+        return FALSE;
+    }
+    g_strlcpy(addr.sun_path, socket_path, sizeof(addr.sun_path));
+
+    gint fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        g_printerr("[ERROR] Execution Manager: metrics socket failed (%s)\n", g_strerror(errno));
+        return FALSE;
+    }
+
+    unlink(socket_path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+        g_printerr("[ERROR] Execution Manager: cannot listen on %s (%s)\n", socket_path, g_strerror(errno));
+        close(fd);
+        return FALSE;
+    }
+
+    m->listen_fd = fd;
+    m->socket_path = g_strdup(socket_path);
+    g_atomic_int_set(&m->stop, 0);
+    m->server_thread = g_thread_new("em-metrics", metrics_server_func, m);
+
+    g_print("[INFO] Execution Manager: metrics endpoint listening on %s\n", socket_path);
+    return TRUE;
+}
+
+void metrics_stop_server(metrics_t *m) {
+    if (!m || !m->server_thread) return;
+
+    g_atomic_int_set(&m->stop, 1);
+    g_thread_join(m->server_thread);
+    m->server_thread = NULL;
+
+    close(m->listen_fd);
+    m->listen_fd = -1;
+    unlink(m->socket_path);
+    g_free(m->socket_path);
+    m->socket_path = NULL;
+}
+
+
+/* ----------------- Metrics Updates ----------------- */
+
+void metrics_inc_activation(metrics_t *m, gint cpu) {
+    core_counters_t *c = metrics_core(m, cpu);
+    if (c) counter_add(&c->activations, 1);
+}
+
+void metrics_inc_completion(metrics_t *m, gint cpu, gint64 busy_us) {
+    core_counters_t *c = metrics_core(m, cpu);
+    if (!c) return;
+    counter_add(&c->completions, 1);
+    if (busy_us > 0) counter_add(&c->busy_us, (guint64)busy_us);
+}
+
+void metrics_inc_deadline_miss(metrics_t *m, gint cpu) {
+    core_counters_t *c = metrics_core(m, cpu);
+    if (c) counter_add(&c->deadline_misses, 1);
+}
+
+void metrics_inc_abort(metrics_t *m, gint cpu) {
+    core_counters_t *c = metrics_core(m, cpu);
+    if (c) counter_add(&c->aborts, 1);
+}
+
+void metrics_observe_release_latency(metrics_t *m, gint cpu, gint64 latency_us) {
+    core_counters_t *c = metrics_core(m, cpu);
+    if (c) counter_add(&c->release_latency[latency_bucket(latency_us)], 1);
+}
+
+void metrics_observe_notify_latency(metrics_t *m, gint64 latency_us) {
+    if (m) counter_add(&m->notify_latency[latency_bucket(latency_us)], 1);
+}
+
+void metrics_observe_server_response(metrics_t *m, gint cpu, gint64 response_us) {
+    core_counters_t *c = metrics_core(m, cpu);
+    if (!c) return;
+    counter_add(&c->server_jobs, 1);
+    counter_add(&m->server_response[latency_bucket(response_us)], 1);
+}
+
+void metrics_add_server_budget(metrics_t *m, gint cpu, gint64 consumed_us) {
+    core_counters_t *c = metrics_core(m, cpu);
+    if (c && consumed_us > 0) counter_add(&c->server_budget_us, (guint64)consumed_us);
+}
+
+void metrics_inc_server_exhaustion(metrics_t *m, gint cpu) {
+    core_counters_t *c = metrics_core(m, cpu);
+    if (c) counter_add(&c->server_exhaustions, 1);
+}
+
+void metrics_set_core_load(metrics_t *m, gint cpu, gint load_permille, gint projected_permille) {
+    core_counters_t *c = metrics_core(m, cpu);
+    if (!c) return;
+    __atomic_store_n(&c->load_permille, (guint64)MAX(load_permille, 0), __ATOMIC_RELAXED);
+    __atomic_store_n(&c->projected_permille, (guint64)MAX(projected_permille, 0), __ATOMIC_RELAXED);
+}
+
+void metrics_inc_overload(metrics_t *m, gint cpu) {
+    core_counters_t *c = metrics_core(m, cpu);
+    if (c) counter_add(&c->overloads, 1);
+}
+
+void metrics_inc_budget_overrun(metrics_t *m, gint cpu) {
+    core_counters_t *c = metrics_core(m, cpu);
+    if (c) counter_add(&c->budget_overruns, 1);
+}
+
+/* Called by the dispatcher before time zero, never by the RT threads: a new run forgets the schedules of the last one */
+void metrics_clear_schedule_info(metrics_t *m) {
+    if (!m) return;
+
+    g_mutex_lock(&m->info_lock);
+    m->n_schedules = 0;
+    g_mutex_unlock(&m->info_lock);
+}
+
+/* One em_schedule_info series per schedule of the run (a shared run loads several) */
+void metrics_add_schedule_info(metrics_t *m, const gchar *name, const gchar *version) {
+    if (!m) return;
+
+    g_mutex_lock(&m->info_lock);
+    if (m->n_schedules < METRICS_MAX_SCHEDULES) {
+        g_strlcpy(m->schedule_name[m->n_schedules], name ? name : "", METRICS_INFO_LEN);
+        g_strlcpy(m->schedule_version[m->n_schedules], version ? version : "", METRICS_INFO_LEN);
+        m->n_schedules++;
+    }
+    g_mutex_unlock(&m->info_lock);
+    counter_add(&m->schedule_runs, 1);
+}
+
+
+/* ----------------- Metrics Rendering ----------------- */
+
+GString* metrics_render(metrics_t *m) {
+    g_return_val_if_fail(m != NULL, NULL);
+
+    GString *out = g_string_sized_new(4096);
+
+    /* 1. Schedule information */
+    g_string_append(out, "# HELP em_schedule_info Schedules of the current run.\n# TYPE em_schedule_info gauge\n");
+    g_mutex_lock(&m->info_lock);
+    for (guint i = 0; i < m->n_schedules; i++) {
+        g_string_append_printf(out, "em_schedule_info{name=\"%s\",version=\"%s\"} 1\n", m->schedule_name[i], m->schedule_version[i]);
+    }
+    g_mutex_unlock(&m->info_lock);
+    g_string_append_printf(out, "# HELP em_schedule_runs_total Schedule runs started.\n# TYPE em_schedule_runs_total counter\n"
+                                "em_schedule_runs_total %" G_GUINT64_FORMAT "\n", counter_get(&m->schedule_runs));
+
+    /* 2. Per core counters */
+    render_per_core(out, m, "em_activations_total", "counter", "Task activations released.", G_STRUCT_OFFSET(core_counters_t, activations));
+    render_per_core(out, m, "em_completions_total", "counter", "Task activations completed.", G_STRUCT_OFFSET(core_counters_t, completions));
+    render_per_core(out, m, "em_deadline_misses_total", "counter", "Tasks not completed at their deadline.", G_STRUCT_OFFSET(core_counters_t, deadline_misses));
+    render_per_core(out, m, "em_aborts_total", "counter", "Abort requests sent.", G_STRUCT_OFFSET(core_counters_t, aborts));
+    render_per_core(out, m, "em_budget_overruns_total", "counter", "Jobs that exhausted their CPU time budget.", G_STRUCT_OFFSET(core_counters_t, budget_overruns));
+
+    g_string_append(out, "# HELP em_cpu_busy_seconds_total Time spent running tasks.\n# TYPE em_cpu_busy_seconds_total counter\n");
+    for (gint cpu = 0; cpu < METRICS_MAX_CPUS; cpu++) {
+        core_counters_t *c = &m->cores[cpu];
+        if (counter_get(&c->activations) == 0) continue;
+        g_string_append_printf(out, "em_cpu_busy_seconds_total{cpu=\"%d\"} %.6f\n", cpu, counter_get(&c->busy_us) / 1e6);
+    }
+
+    /* Load monitor gauges, also for cores that only host aperiodic work */
+    render_load_ratio(out, m, "em_cpu_load_ratio", "Thread CPU time of the jobs over the load monitor window.", G_STRUCT_OFFSET(core_counters_t, load_permille));
+    render_load_ratio(out, m, "em_cpu_projected_load_ratio", "Planned releases times the worst observed job CPU time.", G_STRUCT_OFFSET(core_counters_t, projected_permille));
+    render_per_core(out, m, "em_overloads_total", "counter", "Overload events raised by the load monitor.", G_STRUCT_OFFSET(core_counters_t, overloads));
+
+    /* 3. Release latency percentiles over all cores */
+    guint64 buckets[METRICS_LATENCY_BUCKETS] = {0};
+    guint64 total = 0;
+    for (gint cpu = 0; cpu < METRICS_MAX_CPUS; cpu++) {
+        for (guint b = 0; b < METRICS_LATENCY_BUCKETS; b++) {
+            guint64 v = counter_get(&m->cores[cpu].release_latency[b]);
+            buckets[b] += v;
+            total += v;
+        }
+    }
+    const gdouble quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+    g_string_append(out, "# HELP em_release_latency_us Release to task start latency (log2 bucket upper bound).\n# TYPE em_release_latency_us summary\n");
+    for (guint i = 0; i < G_N_ELEMENTS(quantiles); i++) {
+        g_string_append_printf(out, "em_release_latency_us{quantile=\"%g\"} %" G_GUINT64_FORMAT "\n",
+                               quantiles[i], latency_quantile(buckets, total, quantiles[i]));
+    }
+    g_string_append_printf(out, "em_release_latency_us_count %" G_GUINT64_FORMAT "\n", total);
+
+    /* 4. Completion notification latency */
+    total = 0;
+    for (guint b = 0; b < METRICS_LATENCY_BUCKETS; b++) {
+        buckets[b] = counter_get(&m->notify_latency[b]);
+        total += buckets[b];
+    }
+    g_string_append(out, "# HELP em_completion_notify_latency_us Task completion to dispatcher wake up latency (log2 bucket upper bound).\n# TYPE em_completion_notify_latency_us summary\n");
+    for (guint i = 0; i < G_N_ELEMENTS(quantiles); i++) {
+        g_string_append_printf(out, "em_completion_notify_latency_us{quantile=\"%g\"} %" G_GUINT64_FORMAT "\n",
+                               quantiles[i], latency_quantile(buckets, total, quantiles[i]));
+    }
+    g_string_append_printf(out, "em_completion_notify_latency_us_count %" G_GUINT64_FORMAT "\n", total);
+
+    /* 5. Aperiodic servers: budget consumption and response times */
+    render_per_core(out, m, "em_server_jobs_total", "counter", "Aperiodic jobs served.", G_STRUCT_OFFSET(core_counters_t, server_jobs));
+    render_per_core(out, m, "em_server_exhaustions_total", "counter", "Aperiodic server budget exhausted by a job.", G_STRUCT_OFFSET(core_counters_t, server_exhaustions));
+    g_string_append(out, "# HELP em_server_budget_seconds_total Aperiodic server budget consumed.\n# TYPE em_server_budget_seconds_total counter\n");
+    for (gint cpu = 0; cpu < METRICS_MAX_CPUS; cpu++) {
+        core_counters_t *c = &m->cores[cpu];
+        if (counter_get(&c->server_jobs) == 0 && counter_get(&c->server_budget_us) == 0) continue;
+        g_string_append_printf(out, "em_server_budget_seconds_total{cpu=\"%d\"} %.6f\n", cpu, counter_get(&c->server_budget_us) / 1e6);
+    }
+    total = 0;
+    for (guint b = 0; b < METRICS_LATENCY_BUCKETS; b++) {
+        buckets[b] = counter_get(&m->server_response[b]);
+        total += buckets[b];
+    }
+    g_string_append(out, "# HELP em_server_response_us Aperiodic submission to completion time (log2 bucket upper bound).\n# TYPE em_server_response_us summary\n");
+    for (guint i = 0; i < G_N_ELEMENTS(quantiles); i++) {
+        g_string_append_printf(out, "em_server_response_us{quantile=\"%g\"} %" G_GUINT64_FORMAT "\n",
+                               quantiles[i], latency_quantile(buckets, total, quantiles[i]));
+    }
+    g_string_append_printf(out, "em_server_response_us_count %" G_GUINT64_FORMAT "\n", total);
+
+    return out;
+}
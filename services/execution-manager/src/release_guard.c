@@ -0,0 +1,108 @@
+#include "release_guard.h"
+#include "em_time.h"
+
+/* -----------------Helper Functions ----------------- */
+
+static inline release_guard_core_t *release_guard_core(release_guard_t *rg, gint cpu) {
+    if (G_UNLIKELY(!rg || cpu < 0 || cpu >= RELEASE_GUARD_MAX_CPUS)) return NULL;
+    return &rg->cores[cpu];
+}
+
+/* Same clock as g_get_monotonic_time, read through the vDSO */
+static inline gint64 release_guard_now_ns(void) {
+    return em_time_now_ns(CLOCK_MONOTONIC);
+}
+
+
+/* ----------------- Release Guard Constructor/Destructor ----------------- */
+
+release_guard_t* release_guard_new(gint64 initial_us) {
+    release_guard_t *rg = g_aligned_alloc0(1, sizeof(release_guard_t), 64);
+    rg->initial_us = CLAMP(initial_us, RELEASE_GUARD_MIN_US, RELEASE_GUARD_MAX_US);
+    for (gint cpu = 0; cpu < RELEASE_GUARD_MAX_CPUS; cpu++) {
+        rg->cores[cpu].guard_us = rg->initial_us;
+    }
+    return rg;
+}
+
+void release_guard_free(release_guard_t *rg) {
+    if (rg) g_aligned_free(rg);
+}
+
+
+/* ----------------- Release Guard Setters/Getters ----------------- */
+
+void release_guard_set(release_guard_t *rg, gint cpu, gint64 guard_us) {
+    release_guard_core_t *c = release_guard_core(rg, cpu);
+    g_return_if_fail(c != NULL);
+    g_return_if_fail(guard_us >= 0);
+
+    c->fixed_us = guard_us;
+    __atomic_store_n(&c->guard_us, guard_us > 0 ? guard_us : rg->initial_us, __ATOMIC_RELAXED);
+}
+
+gint64 release_guard_get(release_guard_t *rg, gint cpu) {
+    release_guard_core_t *c = release_guard_core(rg, cpu);
+    if (!c) return rg ? rg->initial_us : 0;
+    return __atomic_load_n(&c->guard_us, __ATOMIC_RELAXED);
+}
+
+
+/* ----------------- Release Guard Methods ----------------- */
+
+void release_guard_observe(release_guard_t *rg, gint cpu, gint64 wakeup_us, gboolean late) {
+    release_guard_core_t *c = release_guard_core(rg, cpu);
+    if (!c) return;
+    wakeup_us = MAX(wakeup_us, 0);
+
+    /* Concurrent workers of one core may lose a sample, never corrupt the guard */
+    __atomic_fetch_add(&c->samples, 1, __ATOMIC_RELAXED);
+    if (late) __atomic_fetch_add(&c->late, 1, __ATOMIC_RELAXED);
+    if (c->fixed_us > 0) return;
+
+    gint64 srtt8 = __atomic_load_n(&c->srtt8, __ATOMIC_RELAXED);
+    gint64 rttvar4 = __atomic_load_n(&c->rttvar4, __ATOMIC_RELAXED);
+    if (srtt8 == 0) {
+        srtt8 = wakeup_us << 3;
+        rttvar4 = wakeup_us << 1;
+    } else {
+        gint64 err = wakeup_us - (srtt8 >> 3);
+        srtt8 += err;
+        rttvar4 += ABS(err) - (rttvar4 >> 2);
+    }
+    __atomic_store_n(&c->srtt8, srtt8, __ATOMIC_RELAXED);
+    __atomic_store_n(&c->rttvar4, rttvar4, __ATOMIC_RELAXED);
+
+    gint64 guard_us = (srtt8 >> 3) + rttvar4 + RELEASE_GUARD_MIN_US;
+    __atomic_store_n(&c->guard_us, CLAMP(guard_us, RELEASE_GUARD_MIN_US, RELEASE_GUARD_MAX_US), __ATOMIC_RELAXED);
+}
+
+/* Busy wait up to target_us, returns the overshoot in ns (negative if already late) */
+gint64 release_guard_spin_until(gint64 target_us) {
+    gint64 target_ns = em_time_us_to_ns(target_us);
+    gint64 now_ns = release_guard_now_ns();
+    if (now_ns > target_ns) return target_ns - now_ns;
+
+    while (now_ns < target_ns) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#endif
+        now_ns = release_guard_now_ns();
+    }
+    return now_ns - target_ns;
+}
+
+void release_guard_print(release_guard_t *rg) {
+    if (!rg) return;
+
+    for (gint cpu = 0; cpu < RELEASE_GUARD_MAX_CPUS; cpu++) {
+        release_guard_core_t *c = &rg->cores[cpu];
+        guint64 samples = __atomic_load_n(&c->samples, __ATOMIC_RELAXED);
+        if (samples == 0) continue;
+        g_print("[INFO] Execution Manager: CPU %d release guard %ld us (%s), %" G_GUINT64_FORMAT " release(s), %" G_GUINT64_FORMAT " late.\n",
+                cpu, (long)release_guard_get(rg, cpu), c->fixed_us > 0 ? "fixed" : "calibrated",
+                samples, __atomic_load_n(&c->late, __ATOMIC_RELAXED));
+    }
+}
@@ -0,0 +1,168 @@
+#define _GNU_SOURCE
+#include "resource.h"
+#include "cpu_budget.h"
+#include "em_time.h"
+
+/* Task of the job running on this thread */
+static __thread guint16 current_task = RESOURCE_NO_TASK;
+
+/* Resources held by this thread, no cancellation while it is not 0 */
+static __thread guint held_count = 0;
+static __thread gint held_cancel_state;
+
+/* -----------------Helper Functions ----------------- */
+
+static void resource_atomic_max(gint64 *target, gint64 value) {
+    gint64 seen = __atomic_load_n(target, __ATOMIC_RELAXED);
+    while (value > seen && !__atomic_compare_exchange_n(target, &seen, value, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        /* seen reloaded by the failed exchange */
+    }
+}
+
+static gboolean resource_init_mutex(resource_t *res, gint ceiling) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    gint protocol = (ceiling > 0) ? PTHREAD_PRIO_PROTECT : PTHREAD_PRIO_INHERIT;
+    pthread_mutexattr_setprotocol(&attr, protocol);
+    if (protocol == PTHREAD_PRIO_PROTECT) pthread_mutexattr_setprioceiling(&attr, ceiling);
+    gint rc = pthread_mutex_init(&res->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    if (rc != 0) {
+        g_printerr("[ERROR] Execution Manager: resource %s mutex init failed (%s)\n", res->name, g_strerror(rc));
+        return FALSE;
+    }
+    res->initialized = TRUE;
+    res->protocol = protocol;
+    res->ceiling = ceiling;
+    return TRUE;
+}
+
+
+/* ----------------- Resource Constructor/Destructor ----------------- */
+
+resource_t* resource_new(const gchar *name, guint16 id) {
+    g_return_val_if_fail(name != NULL, NULL);
+
+    resource_t *res = g_new0(resource_t, 1);
+    res->name = g_strdup(name);
+    res->id = id;
+    res->users = g_array_new(FALSE, FALSE, sizeof(resource_use_t));
+    res->holder_task = RESOURCE_NO_TASK;
+    return res;
+}
+
+void resource_free(resource_t *res) {
+    if (!res) return;
+
+    if (res->initialized) pthread_mutex_destroy(&res->mutex);
+    g_array_free(res->users, TRUE);
+    g_free(res->name);
+    g_free(res);
+}
+
+
+/* ----------------- Resource Methods ----------------- */
+
+void resource_add_user(resource_t *res, guint16 task_id, gint64 cs_us) {
+    g_return_if_fail(res != NULL);
+
+    resource_use_t *use = resource_get_user(res, task_id);
+    if (use) {
+        use->cs_us = MAX(cs_us, 0);
+        return;
+    }
+    resource_use_t new_use = { task_id, MAX(cs_us, 0), 0 };
+    g_array_append_val(res->users, new_use);
+}
+
+resource_use_t* resource_get_user(resource_t *res, guint16 task_id) {
+    g_return_val_if_fail(res != NULL, NULL);
+
+    for (guint i = 0; i < res->users->len; i++) {
+        resource_use_t *use = &g_array_index(res->users, resource_use_t, i);
+        if (use->task_id == task_id) return use;
+    }
+    return NULL;
+}
+
+/* Called before the run, with the resource free */
+gboolean resource_set_ceiling(resource_t *res, gint ceiling) {
+    g_return_val_if_fail(res != NULL, FALSE);
+
+    if (!res->initialized) return resource_init_mutex(res, ceiling);
+    if (ceiling == res->ceiling) return TRUE;
+
+    /* Same protocol: the ceiling is changed in place, otherwise the mutex is rebuilt */
+    if (ceiling > 0 && res->protocol == PTHREAD_PRIO_PROTECT) {
+        gint old_ceiling;
+        gint rc = pthread_mutex_setprioceiling(&res->mutex, ceiling, &old_ceiling);
+        if (rc == 0) {
+            res->ceiling = ceiling;
+            return TRUE;
+        }
+    }
+    pthread_mutex_destroy(&res->mutex);
+    res->initialized = FALSE;
+    return resource_init_mutex(res, ceiling);
+}
+
+/* Last resource released: cancellation allowed again, and a CPU budget action held back is applied */
+static void resource_leave(void) {
+    if (--held_count > 0) return;
+    pthread_setcancelstate(held_cancel_state, NULL);
+    cpu_budget_resources_released();
+}
+
+/* FALSE when the lock is refused: the caller runs above the ceiling (EINVAL) or is not RT under PRIO_PROTECT */
+gboolean resource_lock(resource_t *res) {
+    g_return_val_if_fail(res != NULL && res->initialized, FALSE);
+
+    /* Counted before the lock, so a budget signal during the acquisition is already held back */
+    if (held_count++ == 0) pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &held_cancel_state);
+    gint rc = pthread_mutex_lock(&res->mutex);
+    if (rc != 0) {
+        __atomic_fetch_add(&res->lock_errors, 1, __ATOMIC_RELAXED);
+        resource_leave();
+        return FALSE;
+    }
+
+    res->holder_task = current_task;
+    res->lock_ns = em_time_now_ns(CLOCK_MONOTONIC);
+    return TRUE;
+}
+
+void resource_unlock(resource_t *res) {
+    g_return_if_fail(res != NULL && res->initialized);
+
+    gint64 hold_ns = em_time_now_ns(CLOCK_MONOTONIC) - res->lock_ns;
+    guint16 task_id = res->holder_task;
+    res->holder_task = RESOURCE_NO_TASK;
+    pthread_mutex_unlock(&res->mutex);
+    resource_leave();
+
+    /* Accounted after the release, out of the critical section */
+    __atomic_fetch_add(&res->acquisitions, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&res->total_hold_ns, hold_ns, __ATOMIC_RELAXED);
+    resource_atomic_max(&res->max_hold_ns, hold_ns);
+
+    resource_use_t *use = resource_get_user(res, task_id);
+    if (!use) {
+        __atomic_fetch_add(&res->undeclared, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    resource_atomic_max(&use->max_hold_ns, hold_ns);
+    if (use->cs_us > 0 && hold_ns > em_time_us_to_ns(use->cs_us)) __atomic_fetch_add(&res->overruns, 1, __ATOMIC_RELAXED);
+}
+
+void resource_set_current_task(guint16 task_id) {
+    current_task = task_id;
+}
+
+guint16 resource_current_task(void) {
+    return current_task;
+}
+
+guint resource_held_count(void) {
+    return held_count;
+}
@@ -0,0 +1,249 @@
+#include "result_exporter.h"
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+
+#ifdef EM_HAVE_HIREDIS
+#include <hiredis/hiredis.h>
+#endif
+
+#define RESULT_EXPORTER_CONNECT_TIMEOUT_MS 200
+#define RESULT_EXPORTER_RETRY_MIN_US 10000
+#define RESULT_EXPORTER_RETRY_MAX_US G_USEC_PER_SEC
+
+/* -----------------Helper Functions ----------------- */
+
+static inline void counter_add(guint64 *counter, guint64 value) {
+    __atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+}
+
+static inline guint64 counter_get(const guint64 *counter) {
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+#ifdef EM_HAVE_HIREDIS
+
+/* Single consumer side of the queue: copy up to max records out and hand the cells back */
+static guint result_exporter_collect(result_exporter_t *re, result_record_t *out, guint max) {
+    guint n = 0;
+    while (n < max) {
+        result_record_t *cell = &re->ring[re->tail & re->mask];
+        if (__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) != re->tail + 1) break;     // Empty or still being written
+
+        memcpy(&out[n++], cell, sizeof(result_record_t));
+        __atomic_store_n(&cell->sequence, re->tail + re->mask + 1, __ATOMIC_RELEASE);
+        re->tail++;
+    }
+    return n;
+}
+
+static gboolean result_exporter_pending(result_exporter_t *re) {
+    result_record_t *cell = &re->ring[re->tail & re->mask];
+    return __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) == re->tail + 1;
+}
+
+static void result_exporter_disconnect(result_exporter_t *re) {
+    if (re->conn) redisFree((redisContext *)re->conn);
+    re->conn = NULL;
+}
+
+/* Reconnections back off exponentially, the queue absorbs the outage meanwhile */
+static gboolean result_exporter_connect(result_exporter_t *re) {
+    if (re->conn) return TRUE;
+
+    gint64 now_us = g_get_monotonic_time();
+    if (now_us < re->retry_at_us) return FALSE;
+
+    struct timeval timeout = { .tv_sec = 0, .tv_usec = RESULT_EXPORTER_CONNECT_TIMEOUT_MS * 1000 };
+    redisContext *c = redisConnectWithTimeout(re->host, re->port, timeout);
+    if (!c || c->err) {
+        if (re->retry_delay_us == RESULT_EXPORTER_RETRY_MIN_US) {
+            g_printerr("[WARNING] Execution Manager: result store %s:%d unreachable (%s), retrying.\n",
+                       re->host, re->port, c ? c->errstr : "out of memory");
+        }
+        if (c) redisFree(c);
+        re->retry_at_us = now_us + re->retry_delay_us;
+        re->retry_delay_us = MIN(re->retry_delay_us * 2, RESULT_EXPORTER_RETRY_MAX_US);
+        return FALSE;
+    }
+
+    redisSetTimeout(c, timeout);
+    re->conn = c;
+    re->retry_delay_us = RESULT_EXPORTER_RETRY_MIN_US;
+    g_print("[INFO] Execution Manager: results exported to %s:%d, stream %s\n", re->host, re->port, re->stream);
+    return TRUE;
+}
+
+/* One pipelined round trip per batch: all the commands are written before reading the replies */
+static void result_exporter_send(result_exporter_t *re, const result_record_t *batch, guint n) {
+    redisContext *c = (redisContext *)re->conn;
+
+    for (guint i = 0; i < n; i++) {
+        const result_record_t *r = &batch[i];
+        redisAppendCommand(c, "XADD %s MAXLEN ~ %d * schedule %s task %u ts_us %lld output %b",
+                           re->stream, RESULT_EXPORTER_STREAM_MAXLEN, r->schedule, (guint)r->task_id,
+                           (long long)r->timestamp_us, r->output, (size_t)r->output_len);
+    }
+
+    for (guint i = 0; i < n; i++) {
+        redisReply *reply = NULL;
+        if (redisGetReply(c, (void **)&reply) != REDIS_OK) {
+            g_printerr("[WARNING] Execution Manager: result store connection lost (%s)\n", c->errstr);
+            re->failed += n - i;
+            result_exporter_disconnect(re);
+            return;
+        }
+        if (reply->type == REDIS_REPLY_ERROR) re->failed++;
+        else re->exported++;
+        freeReplyObject(reply);
+    }
+}
+
+static gpointer result_exporter_thread_func(gpointer data) {
+    result_exporter_t *re = (result_exporter_t *)data;
+    gboolean stopping = FALSE;
+
+    while (!stopping) {
+        stopping = g_atomic_int_get(&re->stop);
+
+        /* 1. Sleep until a full batch, the flush interval or the stop request */
+        if (!stopping) {
+            struct pollfd pfd = { .fd = re->wake_fd, .events = POLLIN };
+            if (poll(&pfd, 1, RESULT_EXPORTER_FLUSH_MS) > 0) {
+                guint64 count;
+                if (read(re->wake_fd, &count, sizeof(count)) < 0) {
+                    /* Nothing pending (EAGAIN) */
+                }
+            }
+        }
+        if (!result_exporter_pending(re)) continue;
+
+        /* 2. Records stay queued while the store is down, new ones are dropped once it is full */
+        if (!result_exporter_connect(re)) {
+            if (stopping) break;
+            continue;
+        }
+
+        /* 3. Drain in batches */
+        guint n;
+        while (re->conn && (n = result_exporter_collect(re, re->batch, RESULT_EXPORTER_BATCH)) > 0) {
+            result_exporter_send(re, re->batch, n);
+        }
+    }
+    result_exporter_disconnect(re);
+    return NULL;
+}
+
+#endif
+
+
+/* ----------------- Result Exporter Constructor/Destructor ----------------- */
+
+result_exporter_t* result_exporter_new(const gchar *host, gint port, const gchar *stream) {
+    g_return_val_if_fail(host != NULL && stream != NULL, NULL);
+    g_return_val_if_fail(port > 0 && port <= G_MAXUINT16, NULL);
+    G_STATIC_ASSERT((RESULT_EXPORTER_CAPACITY & (RESULT_EXPORTER_CAPACITY - 1)) == 0);
+
+#ifndef EM_HAVE_HIREDIS
+    g_printerr("[ERROR] Execution Manager: built without hiredis, results not exported.\n");
+    return NULL;
+#else
+    result_exporter_t *re = g_new0(result_exporter_t, 1);
+    re->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (re->wake_fd < 0) {
+        g_printerr("[ERROR] Execution Manager: no result exporter eventfd (%s)\n", g_strerror(errno));
+        g_free(re);
+        return NULL;
+    }
+
+    /* Allocated and touched before time zero, the RT path never faults on it */
+    re->ring = g_aligned_alloc0(RESULT_EXPORTER_CAPACITY, sizeof(result_record_t), 64);
+    re->batch = g_aligned_alloc0(RESULT_EXPORTER_BATCH, sizeof(result_record_t), 64);
+    re->mask = RESULT_EXPORTER_CAPACITY - 1;
+    for (guint64 i = 0; i < RESULT_EXPORTER_CAPACITY; i++) re->ring[i].sequence = i;
+
+    re->host = g_strdup(host);
+    re->port = port;
+    re->stream = g_strdup(stream);
+    re->retry_delay_us = RESULT_EXPORTER_RETRY_MIN_US;
+    re->thread = g_thread_new("em-results", result_exporter_thread_func, re);
+    return re;
+#endif
+}
+
+void result_exporter_free(result_exporter_t *re) {
+    if (!re) return;
+
+    /* The thread flushes what is queued before leaving */
+    g_atomic_int_set(&re->stop, 1);
+    guint64 one = 1;
+    if (write(re->wake_fd, &one, sizeof(one)) < 0) {
+        /* Counter saturated: the thread is already woken up */
+    }
+    g_thread_join(re->thread);
+    result_exporter_print(re);
+
+    close(re->wake_fd);
+    g_aligned_free(re->ring);
+    g_aligned_free(re->batch);
+    g_free(re->host);
+    g_free(re->stream);
+    g_free(re);
+}
+
+
+/* ----------------- Result Exporter Methods ----------------- */
+
+/* Lock-free and wait-free for the caller: a full queue or an oversized output loses the record */
+gboolean result_exporter_push(result_exporter_t *re, const gchar *schedule, guint16 task_id, const gchar *output) {
+    if (!re || !schedule || !output) return FALSE;
+
+    gsize output_len = strlen(output);
+    if (G_UNLIKELY(output_len >= RESULT_EXPORTER_OUTPUT_LEN)) {
+        counter_add(&re->oversized, 1);
+        return FALSE;
+    }
+
+    /* 1. Claim a cell */
+    result_record_t *cell;
+    guint64 pos = __atomic_load_n(&re->head, __ATOMIC_RELAXED);
+    for (;;) {
+        cell = &re->ring[pos & re->mask];
+        gint64 diff = (gint64)__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - (gint64)pos;
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&re->head, &pos, pos + 1, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        } else if (diff < 0) {
+            counter_add(&re->dropped, 1);
+            return FALSE;
+        } else {
+            pos = __atomic_load_n(&re->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    /* 2. Fill it and publish it */
+    cell->timestamp_us = g_get_real_time();
+    cell->task_id = task_id;
+    cell->output_len = (guint16)output_len;
+    g_strlcpy(cell->schedule, schedule, sizeof(cell->schedule));
+    memcpy(cell->output, output, output_len + 1);
+    __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+
+    /* 3. Wake the exporter once per full batch, partial batches wait for the flush interval */
+    if ((pos + 1) % RESULT_EXPORTER_BATCH == 0) {
+        guint64 one = 1;
+        if (write(re->wake_fd, &one, sizeof(one)) < 0) {
+            /* Counter saturated: the thread is already woken up */
+        }
+    }
+    return TRUE;
+}
+
+void result_exporter_print(result_exporter_t *re) {
+    if (!re) return;
+
+    g_print("[INFO] Execution Manager: results exported %" G_GUINT64_FORMAT ", dropped %" G_GUINT64_FORMAT
+            ", oversized %" G_GUINT64_FORMAT ", failed %" G_GUINT64_FORMAT ".\n",
+            re->exported, counter_get(&re->dropped), counter_get(&re->oversized), re->failed);
+}
@@ -0,0 +1,366 @@
+#define _GNU_SOURCE
+#include "rt_audit.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+
+#define RT_AUDIT_DMA_LATENCY "/dev/cpu_dma_latency"
+#define RT_AUDIT_RT_RUNTIME "/proc/sys/kernel/sched_rt_runtime_us"
+#define RT_AUDIT_RT_PERIOD "/proc/sys/kernel/sched_rt_period_us"
+#define RT_AUDIT_ISOLATED "/sys/devices/system/cpu/isolated"
+#define RT_AUDIT_NOHZ_FULL "/sys/devices/system/cpu/nohz_full"
+#define RT_AUDIT_THP "/sys/kernel/mm/transparent_hugepage/enabled"
+
+/* -----------------Helper Functions ----------------- */
+
+static const gchar *audit_status_name(rt_audit_status_t status) {
+    switch (status) {
+        case RT_AUDIT_OK:    return "OK";
+        case RT_AUDIT_TUNED: return "TUNED";
+        case RT_AUDIT_WARN:  return "WARN";
+        case RT_AUDIT_FAIL:  return "FAIL";
+        default:             return "UNKNOWN";
+    }
+}
+
+static void audit_check_clear(gpointer data) {
+    g_free(((rt_audit_check_t *)data)->detail);
+}
+
+G_GNUC_PRINTF(5, 6)
+static void audit_add(rt_audit_t *audit, const gchar *name, gint weight, rt_audit_status_t status, const gchar *format, ...) {
+    rt_audit_check_t check = { name, status, weight, NULL };
+    va_list args;
+    va_start(args, format);
+    check.detail = g_strdup_vprintf(format, args);
+    va_end(args);
+    g_array_append_val(audit->checks, check);
+}
+
+/* Stripped content of a sysfs/procfs file, NULL if it cannot be read */
+static gchar *audit_read(const gchar *path) {
+    gchar *text = NULL;
+    if (!g_file_get_contents(path, &text, NULL, NULL)) return NULL;
+    return g_strstrip(text);
+}
+
+/* Kernel cpulist ("0-3,8") to a CPU set */
+static void audit_parse_cpulist(const gchar *list, cpu_set_t *set) {
+    CPU_ZERO(set);
+    if (!list) return;
+    gchar **ranges = g_strsplit(list, ",", -1);
+    for (gchar **r = ranges; *r; r++) {
+        gchar *end = NULL;
+        glong first = strtol(*r, &end, 10);
+        if (end == *r) continue;
+        glong last = (*end == '-') ? strtol(end + 1, NULL, 10) : first;
+        for (glong cpu = MAX(first, 0); cpu <= last && cpu < CPU_SETSIZE; cpu++) CPU_SET(cpu, set);
+    }
+    g_strfreev(ranges);
+}
+
+/* Task CPUs missing from set, as a comma separated list ("" when none) */
+static GString *audit_cpus_outside(rt_audit_t *audit, const cpu_set_t *set) {
+    GString *missing = g_string_new(NULL);
+    for (guint i = 0; i < audit->cpus->len; i++) {
+        gint cpu = g_array_index(audit->cpus, gint, i);
+        if (CPU_ISSET(cpu, set)) continue;
+        g_string_append_printf(missing, "%s%d", missing->len ? "," : "", cpu);
+    }
+    return missing;
+}
+
+static void *audit_noop_thread(void *data) {
+    return data;
+}
+
+
+/* --- Checks --- */
+
+static void audit_memory_lock(rt_audit_t *audit) {
+    gchar *status = audit_read("/proc/self/status");
+    gchar *line = status ? strstr(status, "VmLck:") : NULL;
+    if (!line) {
+        audit_add(audit, "memory_lock", 10, RT_AUDIT_UNKNOWN, "/proc/self/status not readable");
+    } else {
+        glong locked_kb = strtol(line + strlen("VmLck:"), NULL, 10);
+        if (locked_kb > 0) audit_add(audit, "memory_lock", 10, RT_AUDIT_OK, "%ld kB locked", locked_kb);
+        else audit_add(audit, "memory_lock", 10, RT_AUDIT_WARN, "nothing locked, page faults on the RT path");
+    }
+    g_free(status);
+}
+
+/* Same request as a worker: SCHED_FIFO set through the thread attributes */
+static void audit_rt_policy(rt_audit_t *audit) {
+    pthread_attr_t attr;
+    struct sched_param param = { .sched_priority = sched_get_priority_min(SCHED_FIFO) };
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &param);
+
+    pthread_t thread;
+    gint rc = pthread_create(&thread, &attr, audit_noop_thread, NULL);
+    pthread_attr_destroy(&attr);
+    if (rc == 0) {
+        pthread_join(thread, NULL);
+        audit_add(audit, "rt_policy", 20, RT_AUDIT_OK, "SCHED_FIFO allowed (priority %d-%d)",
+                  sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO));
+    } else {
+        audit_add(audit, "rt_policy", 20, RT_AUDIT_FAIL, "SCHED_FIFO refused (%s), needs CAP_SYS_NICE or RLIMIT_RTPRIO", g_strerror(rc));
+    }
+}
+
+/* The PM QoS request lasts as long as the fd is open */
+static void audit_dma_latency(rt_audit_t *audit, gboolean apply) {
+    if (audit->dma_latency_fd >= 0) {
+        audit_add(audit, "cpu_dma_latency", 15, RT_AUDIT_TUNED, "0 us requested, held until exit");
+        return;
+    }
+
+    gint fd = open(RT_AUDIT_DMA_LATENCY, (apply ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+    if (fd < 0) {
+        audit_add(audit, "cpu_dma_latency", 15, (errno == ENOENT) ? RT_AUDIT_UNKNOWN : RT_AUDIT_WARN,
+                  "%s not opened (%s), deep C-states stay allowed", RT_AUDIT_DMA_LATENCY, g_strerror(errno));
+        return;
+    }
+
+    gint32 target = 0;
+    if (apply && write(fd, &target, sizeof(target)) == (ssize_t)sizeof(target)) {
+        audit->dma_latency_fd = fd;
+        audit_add(audit, "cpu_dma_latency", 15, RT_AUDIT_TUNED, "0 us requested, held until exit");
+        return;
+    }
+
+    gint32 current = -1;
+    if (read(fd, &current, sizeof(current)) != (ssize_t)sizeof(current)) current = -1;
+    close(fd);
+    if (current == 0) audit_add(audit, "cpu_dma_latency", 15, RT_AUDIT_OK, "0 us requested by another process");
+    else audit_add(audit, "cpu_dma_latency", 15, RT_AUDIT_WARN, "current limit %d us, deep C-states allowed", current);
+}
+
+static void audit_rt_throttling(rt_audit_t *audit) {
+    gchar *runtime = audit_read(RT_AUDIT_RT_RUNTIME);
+    gchar *period = audit_read(RT_AUDIT_RT_PERIOD);
+    if (!runtime) {
+        audit_add(audit, "rt_throttling", 15, RT_AUDIT_UNKNOWN, "%s not readable", RT_AUDIT_RT_RUNTIME);
+    } else if (g_ascii_strtoll(runtime, NULL, 10) < 0) {
+        audit_add(audit, "rt_throttling", 15, RT_AUDIT_OK, "disabled");
+    } else {
+        audit_add(audit, "rt_throttling", 15, RT_AUDIT_WARN, "RT tasks get %s of every %s us (sysctl kernel.sched_rt_runtime_us=-1)",
+                  runtime, period ? period : "?");
+    }
+    g_free(runtime);
+    g_free(period);
+}
+
+/* Inherited by the threads created afterwards: the dispatcher, the deadline timer and the workers */
+static void audit_timer_slack(rt_audit_t *audit, gboolean apply) {
+    glong slack_ns = (glong)prctl(PR_GET_TIMERSLACK, 0, 0, 0, 0);
+    if (slack_ns >= 0 && slack_ns <= 1) {
+        audit_add(audit, "timer_slack", 10, RT_AUDIT_OK, "%ld ns", slack_ns);
+    } else if (apply && prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0) == 0) {
+        audit_add(audit, "timer_slack", 10, RT_AUDIT_TUNED, "%ld ns -> 1 ns", slack_ns);
+    } else {
+        audit_add(audit, "timer_slack", 10, RT_AUDIT_WARN, "%ld ns, timed waits wake up late", slack_ns);
+    }
+}
+
+static void audit_irq_affinity(rt_audit_t *audit) {
+    if (audit->cpus->len == 0) {
+        audit_add(audit, "irq_affinity", 10, RT_AUDIT_UNKNOWN, "no pinned task CPU");
+        return;
+    }
+
+    GDir *dir = g_dir_open("/proc/irq", 0, NULL);
+    if (!dir) {
+        audit_add(audit, "irq_affinity", 10, RT_AUDIT_UNKNOWN, "/proc/irq not readable");
+        return;
+    }
+
+    guint on_task_cpus = 0, total = 0;
+    const gchar *name;
+    while ((name = g_dir_read_name(dir)) != NULL) {
+        if (!g_ascii_isdigit(name[0])) continue;
+
+        /* The effective affinity is what the interrupt controller was programmed with */
+        gchar *path = g_strdup_printf("/proc/irq/%s/effective_affinity_list", name);
+        gchar *list = audit_read(path);
+        if (!list || !*list) {
+            g_free(list);
+            g_free(path);
+            path = g_strdup_printf("/proc/irq/%s/smp_affinity_list", name);
+            list = audit_read(path);
+        }
+        if (list) {
+            cpu_set_t set;
+            audit_parse_cpulist(list, &set);
+            total++;
+            for (guint i = 0; i < audit->cpus->len; i++) {
+                if (CPU_ISSET(g_array_index(audit->cpus, gint, i), &set)) {
+                    on_task_cpus++;
+                    break;
+                }
+            }
+        }
+        g_free(list);
+        g_free(path);
+    }
+    g_dir_close(dir);
+
+    if (total == 0) audit_add(audit, "irq_affinity", 10, RT_AUDIT_UNKNOWN, "no IRQ affinity readable");
+    else if (on_task_cpus == 0) audit_add(audit, "irq_affinity", 10, RT_AUDIT_OK, "%u IRQs, none on the task CPUs", total);
+    else audit_add(audit, "irq_affinity", 10, RT_AUDIT_WARN, "%u of %u IRQs can fire on the task CPUs", on_task_cpus, total);
+}
+
+static void audit_cpu_isolation(rt_audit_t *audit) {
+    if (audit->cpus->len == 0) {
+        audit_add(audit, "cpu_isolation", 10, RT_AUDIT_UNKNOWN, "no pinned task CPU");
+        return;
+    }
+
+    gchar *isolated = audit_read(RT_AUDIT_ISOLATED);
+    if (!isolated) {
+        audit_add(audit, "cpu_isolation", 10, RT_AUDIT_UNKNOWN, "%s not readable", RT_AUDIT_ISOLATED);
+        return;
+    }
+    gchar *nohz_full = audit_read(RT_AUDIT_NOHZ_FULL);      // Absent without CONFIG_NO_HZ_FULL
+
+    cpu_set_t set;
+    audit_parse_cpulist(isolated, &set);
+    GString *not_isolated = audit_cpus_outside(audit, &set);
+    audit_parse_cpulist(nohz_full, &set);
+    GString *ticking = audit_cpus_outside(audit, &set);
+
+    if (not_isolated->len == 0 && ticking->len == 0) {
+        audit_add(audit, "cpu_isolation", 10, RT_AUDIT_OK, "task CPUs isolated and nohz_full");
+    } else {
+        audit_add(audit, "cpu_isolation", 10, RT_AUDIT_WARN, "not in isolcpus: %s; not in nohz_full: %s",
+                  not_isolated->len ? not_isolated->str : "-", ticking->len ? ticking->str : "-");
+    }
+    g_string_free(not_isolated, TRUE);
+    g_string_free(ticking, TRUE);
+    g_free(isolated);
+    g_free(nohz_full);
+}
+
+/* khugepaged collapses and fault-time compaction stall the task that touches the memory */
+static void audit_transparent_hugepages(rt_audit_t *audit, gboolean apply) {
+    gchar *thp = audit_read(RT_AUDIT_THP);
+    if (!thp) {
+        audit_add(audit, "transparent_hugepages", 10, RT_AUDIT_UNKNOWN, "%s not readable", RT_AUDIT_THP);
+        return;
+    }
+
+    if (!strstr(thp, "[always]")) {
+        audit_add(audit, "transparent_hugepages", 10, RT_AUDIT_OK, "%s", thp);
+    } else if (prctl(PR_GET_THP_DISABLE, 0, 0, 0, 0) == 1) {
+        audit_add(audit, "transparent_hugepages", 10, RT_AUDIT_OK, "always, disabled for this process");
+    } else if (apply && prctl(PR_SET_THP_DISABLE, 1, 0, 0, 0) == 0) {
+        audit_add(audit, "transparent_hugepages", 10, RT_AUDIT_TUNED, "always -> disabled for this process");
+    } else {
+        audit_add(audit, "transparent_hugepages", 10, RT_AUDIT_WARN, "always, compaction stalls on page faults");
+    }
+    g_free(thp);
+}
+
+
+/* ----------------- RT Audit Constructor/Destructor ----------------- */
+
+rt_audit_t* rt_audit_new(void) {
+    rt_audit_t *audit = g_new0(rt_audit_t, 1);
+    audit->checks = g_array_new(FALSE, FALSE, sizeof(rt_audit_check_t));
+    g_array_set_clear_func(audit->checks, audit_check_clear);
+    audit->cpus = g_array_new(FALSE, FALSE, sizeof(gint));
+    audit->dma_latency_fd = -1;
+    return audit;
+}
+
+/* Closing the fd drops the cpu_dma_latency request */
+void rt_audit_free(rt_audit_t *audit) {
+    if (!audit) return;
+
+    if (audit->dma_latency_fd >= 0) close(audit->dma_latency_fd);
+    g_array_free(audit->checks, TRUE);
+    g_array_free(audit->cpus, TRUE);
+    g_free(audit);
+}
+
+
+/* ----------------- RT Audit Methods ----------------- */
+
+void rt_audit_add_cpu(rt_audit_t *audit, gint cpu) {
+    g_return_if_fail(audit != NULL);
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return;
+
+    guint i = 0;
+    while (i < audit->cpus->len && g_array_index(audit->cpus, gint, i) < cpu) i++;
+    if (i < audit->cpus->len && g_array_index(audit->cpus, gint, i) == cpu) return;
+    g_array_insert_val(audit->cpus, i, cpu);
+}
+
+/* CPUs of the activations, mapped as the dispatcher does (cpu_affinity indexes cores, NULL = identity) */
+void rt_audit_add_schedule(rt_audit_t *audit, schedule_t *sched, const gint *cores, guint n_cores) {
+    g_return_if_fail(audit != NULL && sched != NULL);
+
+    for (GList *l = sched->schedule_start_info->head; l; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        for (guint i = 0; i < entry->items->len; i++) {
+            gint cpu_affinity = timeline_entry_activation(entry, i)->cpu_affinity;
+            rt_audit_add_cpu(audit, (cores && n_cores > 0 && cpu_affinity >= 0) ? cores[cpu_affinity % n_cores] : cpu_affinity);
+        }
+    }
+}
+
+/* Runs once, before the first schedule; returns the score */
+gint rt_audit_run(rt_audit_t *audit, gboolean apply) {
+    g_return_val_if_fail(audit != NULL, 0);
+    if (audit->done) return audit->score;
+
+    audit_memory_lock(audit);
+    audit_rt_policy(audit);
+    audit_dma_latency(audit, apply);
+    audit_rt_throttling(audit);
+    audit_timer_slack(audit, apply);
+    audit_irq_affinity(audit);
+    audit_cpu_isolation(audit);
+    audit_transparent_hugepages(audit, apply);
+
+    gint earned = 0, total = 0;
+    for (guint i = 0; i < audit->checks->len; i++) {
+        rt_audit_check_t *check = &g_array_index(audit->checks, rt_audit_check_t, i);
+        if (check->status == RT_AUDIT_UNKNOWN) continue;
+        total += check->weight;
+        if (check->status == RT_AUDIT_OK || check->status == RT_AUDIT_TUNED) earned += check->weight;
+    }
+    audit->score = (total > 0) ? earned * 100 / total : 0;
+    audit->done = TRUE;
+    return audit->score;
+}
+
+void rt_audit_print(rt_audit_t *audit) {
+    g_return_if_fail(audit != NULL);
+
+    GString *cpus = g_string_new(NULL);
+    for (guint i = 0; i < audit->cpus->len; i++) {
+        g_string_append_printf(cpus, "%s%d", i ? "," : "", g_array_index(audit->cpus, gint, i));
+    }
+
+    g_print("\n=== RT ENVIRONMENT [task CPUs: %s] ===\n", cpus->len ? cpus->str : "not pinned");
+    guint unknown = 0;
+    for (guint i = 0; i < audit->checks->len; i++) {
+        rt_audit_check_t *check = &g_array_index(audit->checks, rt_audit_check_t, i);
+        if (check->status == RT_AUDIT_UNKNOWN) unknown++;
+        g_print("[%-7s] %-22s (%2d) %s\n", audit_status_name(check->status), check->name, check->weight, check->detail);
+    }
+    g_print("Score: %d/100", audit->score);
+    if (unknown) g_print(" (%u check(s) not readable, left out)", unknown);
+    g_print("\n==========================================\n");
+    g_string_free(cpus, TRUE);
+}
@@ -1,8 +1,11 @@
 #include "schedule.h"
+#include "task_plugin.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
 
 /* -----------------Helper Functions ----------------- */
 
@@ -15,59 +18,180 @@ static gboolean is_version_valid(const gchar *version) {
     return g_regex_match(regex, version, 0, NULL);
 }
 
-static gint compare_timeline_entries(gconstpointer a, gconstpointer b, gpointer user_data) {
-    const timeline_entry_t *entry_a = (const timeline_entry_t *)a;
-    const timeline_entry_t *entry_b = (const timeline_entry_t *)b;
-    return (entry_a->timestamp < entry_b->timestamp) ? -1 : (entry_a->timestamp > entry_b->timestamp) ? 1 : 0;
+static gint compare_timestamps(gconstpointer a, gconstpointer b) {
+    gint64 ta = *(const gint64 *)a;
+    gint64 tb = *(const gint64 *)b;
+    return (ta > tb) - (ta < tb);
 }
 
+/* O(log n) lookup in the timestamp index; fresh entries never share the records of an existing timestamp */
+static timeline_entry_t *timeline_get_entry(GQueue *timeline, GTree *index, gint64 timestamp_ns, guint item_size, gboolean fresh) {
+    GList *link = g_tree_lookup(index, &timestamp_ns);
+    if (link && !fresh) return link->data;
+
+    timeline_entry_t *new_e = g_new0(timeline_entry_t, 1);
+    new_e->timestamp_ns = timestamp_ns;
+    new_e->items = g_array_new(FALSE, FALSE, item_size);
+
+    /* After the entries with the same timestamp, before the first later one */
+    GTreeNode *next = g_tree_upper_bound(index, &timestamp_ns);
+    if (next) {
+        GList *next_link = g_tree_node_value(next);
+        g_queue_insert_before(timeline, next_link, new_e);
+        if (!link) g_tree_insert(index, &new_e->timestamp_ns, next_link->prev);
+    } else {
+        g_queue_push_tail(timeline, new_e);
+        if (!link) g_tree_insert(index, &new_e->timestamp_ns, timeline->tail);
+    }
+    return new_e;
+}
 
 static void g_string_free_wrapper(gpointer data) {
     if (data) g_string_free((GString *)data, TRUE);
 }
 
-static void activation_data_free(gpointer data) {
-    activation_data_t *act = (activation_data_t *)data;
-    if (act) {
-        g_string_free(act->task_name, TRUE);
-        g_free(act->input_data);
-        g_slist_free(act->depends_on);
-        g_free(act);
-    }
-}
+/* Task names are stored once per schedule and referenced by index */
+static guint32 schedule_intern_name(schedule_t *sched, const gchar *name) {
+    gpointer idx = g_hash_table_lookup(sched->schedule_name_index, name);
+    if (idx) return GPOINTER_TO_UINT(idx) - 1;
 
-static void expiration_data_free(gpointer data) {
-    expiration_data_t *exp = (expiration_data_t *)data;
-    if (exp) {
-        g_string_free(exp->task_name, TRUE);
-        g_free(exp);
-    }
+    gchar *copy = g_strdup(name);
+    g_ptr_array_add(sched->schedule_task_names, copy);
+    guint32 name_id = sched->schedule_task_names->len - 1;
+    g_hash_table_insert(sched->schedule_name_index, copy, GUINT_TO_POINTER(name_id + 1));
+    return name_id;
 }
 
-static void timeline_entry_free_generic(gpointer data, GDestroyNotify data_free_func) {
+/* Inputs are released with the input pool, not with the activations that share them */
+static void timeline_entry_free_wrapper(gpointer data) {
     timeline_entry_t *entry = (timeline_entry_t *)data;
     if (entry) {
-        g_slist_free_full(entry->data_list, data_free_func);
+        g_array_free(entry->items, TRUE);
         g_free(entry);
     }
 }
 
-static void start_entry_free_wrapper(gpointer data) {
-    timeline_entry_free_generic(data, (GDestroyNotify)activation_data_free);
+/* Results tables replaced by live merges, their slots all moved to the current table */
+static void schedule_free_retired_results(schedule_t *sched) {
+    for (guint i = 0; i < sched->schedule_retired_results->len; i++) {
+        GHashTable *retired = g_ptr_array_index(sched->schedule_retired_results, i);
+        g_hash_table_steal_all(retired);
+        g_hash_table_unref(retired);
+    }
+    g_ptr_array_set_size(sched->schedule_retired_results, 0);
+}
+
+static guint schedule_job_hash(gconstpointer key) {
+    const schedule_job_key_t *job = (const schedule_job_key_t *)key;
+    return g_int64_hash(&job->release_ns) ^ ((guint)job->task_id * 2654435761u);
 }
 
-static void end_entry_free_wrapper(gpointer data) {
-    timeline_entry_free_generic(data, (GDestroyNotify)expiration_data_free);
+static gboolean schedule_job_equal(gconstpointer a, gconstpointer b) {
+    const schedule_job_key_t *ja = (const schedule_job_key_t *)a;
+    const schedule_job_key_t *jb = (const schedule_job_key_t *)b;
+    return ja->task_id == jb->task_id && ja->release_ns == jb->release_ns;
 }
 
 static void task_result_free(gpointer data) {
     task_result_t *res = (task_result_t *)data;
     if (res) {
         g_slist_free_full(res->output_list, g_string_free_wrapper);
-        g_free(res);
+        if (!res->placed) g_free(res);
     }
 }
 
+/* RT priority and cpu_affinity of the first activation of a task, FALSE if it has none */
+static gboolean schedule_task_sched_info(schedule_t *sched, guint16 id, gint *priority, gint *cpu_affinity) {
+    for (GList *l = sched->schedule_start_info->head; l; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        for (guint i = 0; i < entry->items->len; i++) {
+            activation_data_t *act = timeline_entry_activation(entry, i);
+            if (act->task_id != id) continue;
+            *priority = (act->policy == SCHED_FIFO || act->policy == SCHED_RR) ? act->priority : 0;
+            *cpu_affinity = act->cpu_affinity;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/* Wakes up the completion handler of the dispatcher */
+static void schedule_notify_completion(schedule_t *sched) {
+    if (sched->schedule_completion_fd < 0) return;
+
+    guint64 one = 1;
+    if (write(sched->schedule_completion_fd, &one, sizeof(one)) < 0) {
+        /* Counter saturated: the dispatcher is already woken up */
+    }
+}
+
+/* Physical CPU of an activation: task cpu_affinity indexes cores, NULL = identity */
+static gint schedule_map_cpu(const gint *cores, guint n_cores, gint cpu_affinity) {
+    return (cores && n_cores > 0 && cpu_affinity >= 0) ? cores[cpu_affinity % n_cores] : cpu_affinity;
+}
+
+
+/* Records of one activation: built schedules share the entries of a timestamp, live merges get fresh ones */
+static gboolean schedule_insert_activation(schedule_t *sched, const activation_data_t *act, gint64 start_ns, gint64 end_ns,
+                                           gboolean live, timeline_entry_t **start_entry, timeline_entry_t **end_entry) {
+    /* 1. Insert in timeline queue */
+    timeline_entry_t *st_entry = timeline_get_entry(sched->schedule_start_info, sched->schedule_start_index, start_ns, sizeof(activation_data_t), live);
+    g_array_append_val(st_entry->items, *act);
+
+    /* 2. Create Expiration Data */
+    expiration_data_t exp = { 0 };
+    exp.release_ns = start_ns;
+    exp.task_id = act->task_id;
+    exp.name_id = act->name_id;
+    exp.cpu_affinity = act->cpu_affinity;
+
+    /* 3. Insert in timeline queue */
+    timeline_entry_t *exp_entry = timeline_get_entry(sched->schedule_end_info, sched->schedule_end_index, end_ns, sizeof(expiration_data_t), live);
+    g_array_append_val(exp_entry->items, exp);
+
+    if (start_entry) *start_entry = st_entry;
+    if (end_entry) *end_entry = exp_entry;
+
+    /* 4. Init results in HashTable */
+    pthread_mutex_lock(&sched->schedule_results_mutex);     // LOCK MUTEX
+    task_result_t *old = g_hash_table_lookup(sched->schedule_results, GINT_TO_POINTER((gint)act->task_id));
+    if (live && old) {
+        /* Modified task: same slot, the lock-free readers never see it go away; one run more than the jobs still in flight */
+        if (old->remaining_runs < G_MAXUINT8) {
+            __atomic_store_n(&old->remaining_runs, old->remaining_runs + 1, __ATOMIC_RELEASE);
+            g_atomic_int_inc(&sched->schedule_pending_runs);
+        }
+        if (old->repetition < G_MAXUINT8) old->repetition++;
+    } else {
+        task_result_t *res = g_new0(task_result_t, 1);
+        res->remaining_runs = act->repetition;
+        res->repetition = act->repetition;
+        res->output_list = NULL;
+        if (old) g_atomic_int_add(&sched->schedule_pending_runs, -(gint)old->remaining_runs);
+
+        /* New task while running: the table is copied and swapped, never resized under the lock-free readers */
+        if (live) {
+            GHashTable *results = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, task_result_free);
+            GHashTableIter iter;
+            gpointer key, value;
+            g_hash_table_iter_init(&iter, sched->schedule_results);
+            while (g_hash_table_iter_next(&iter, &key, &value)) g_hash_table_insert(results, key, value);
+            g_hash_table_insert(results, GINT_TO_POINTER((gint)act->task_id), res);
+            g_ptr_array_add(sched->schedule_retired_results, sched->schedule_results);
+            __atomic_store_n(&sched->schedule_results, results, __ATOMIC_RELEASE);
+        } else {
+            g_hash_table_insert(sched->schedule_results, GINT_TO_POINTER((gint)act->task_id), res);
+        }
+        g_atomic_int_add(&sched->schedule_pending_runs, act->repetition);
+    }
+    pthread_mutex_unlock(&sched->schedule_results_mutex);   // UNLOCK MUTEX
+
+    /* 5. Update schedule duration */
+    if (end_ns > sched->schedule_duration_ns)
+        sched->schedule_duration_ns = end_ns;
+    sched->schedule_max_window_ns = MAX(sched->schedule_max_window_ns, end_ns - start_ns);
+    return TRUE;
+}
 
 
 /* ----------------- Schedule Constructor/Destructor ----------------- */
@@ -84,6 +208,8 @@ schedule_t* schedule_new(const gchar *name, const gchar *version) {
     /* Timeline Start/End Queue Initialization */
     sched->schedule_start_info = g_queue_new();
     sched->schedule_end_info = g_queue_new();
+    sched->schedule_start_index = g_tree_new(compare_timestamps);
+    sched->schedule_end_index = g_tree_new(compare_timestamps);
 
     /* Mutex Initializzations */
     pthread_mutexattr_t attr;
@@ -94,8 +220,33 @@ schedule_t* schedule_new(const gchar *name, const gchar *version) {
     
     /* HashTable Initialization */
     sched->schedule_results = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, task_result_free);
+    sched->schedule_result_arenas = g_array_new(FALSE, FALSE, sizeof(result_arena_t));
+    sched->schedule_retired_results = g_ptr_array_new();
+    sched->schedule_done_jobs = g_hash_table_new_full(schedule_job_hash, schedule_job_equal, g_free, NULL);
+
+    /* Plugins are loaded once per path and closed with the schedule */
+    sched->schedule_plugins = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)task_plugin_free);
+
+    /* Inputs belong to the schedule, the jobs only borrow them */
+    sched->schedule_inputs = input_pool_new();
+
+    /* Resources shared by the tasks, declared with the schedule */
+    sched->schedule_resources = g_ptr_array_new_with_free_func((GDestroyNotify)resource_free);
+    sched->schedule_resource_index = g_hash_table_new(g_str_hash, g_str_equal);
 
-    sched->schedule_duration = 0;
+    /* Interned names and dependency lists shared by the compact activation records */
+    sched->schedule_task_names = g_ptr_array_new_with_free_func(g_free);
+    sched->schedule_name_index = g_hash_table_new(g_str_hash, g_str_equal);
+    sched->schedule_dependencies = g_array_new(FALSE, FALSE, sizeof(guint16));
+
+    /* Completions are signalled on an eventfd, the dispatcher does not poll the results */
+    sched->schedule_completion_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (sched->schedule_completion_fd < 0) {
+        g_printerr("[WARNING] Execution Manager: no completion eventfd for %s (%s)\n", name, g_strerror(errno));
+    }
+
+    sched->schedule_duration_ns = 0;
+    sched->schedule_clock = CLOCK_MONOTONIC;
     return sched;
 }
 
@@ -107,9 +258,27 @@ void schedule_free(schedule_t *sched) {
     /* Destroy the other datas structures */
     g_string_free(sched->schedule_name, TRUE);
     g_string_free(sched->schedule_version, TRUE);
-    g_queue_free_full(sched->schedule_start_info, start_entry_free_wrapper);
-    g_queue_free_full(sched->schedule_end_info, end_entry_free_wrapper);
+    g_tree_destroy(sched->schedule_start_index);
+    g_tree_destroy(sched->schedule_end_index);
+    g_queue_free_full(sched->schedule_start_info, timeline_entry_free_wrapper);
+    g_queue_free_full(sched->schedule_end_info, timeline_entry_free_wrapper);
+    input_pool_free(sched->schedule_inputs);
+    g_hash_table_destroy(sched->schedule_resource_index);
+    g_ptr_array_free(sched->schedule_resources, TRUE);
+    schedule_free_retired_results(sched);
+    g_ptr_array_free(sched->schedule_retired_results, TRUE);
     g_hash_table_destroy(sched->schedule_results);
+    g_hash_table_destroy(sched->schedule_done_jobs);
+    for (guint i = 0; i < sched->schedule_result_arenas->len; i++) {
+        result_arena_t *arena = &g_array_index(sched->schedule_result_arenas, result_arena_t, i);
+        em_numa_free(arena->base, arena->size);
+    }
+    g_array_free(sched->schedule_result_arenas, TRUE);
+    g_hash_table_destroy(sched->schedule_plugins);
+    g_hash_table_destroy(sched->schedule_name_index);
+    g_ptr_array_free(sched->schedule_task_names, TRUE);
+    g_array_free(sched->schedule_dependencies, TRUE);
+    if (sched->schedule_completion_fd >= 0) close(sched->schedule_completion_fd);
     g_free(sched);
 }
 
@@ -134,107 +303,144 @@ GSList *schedule_get_results(schedule_t *sched, guint16 id)
 }
 
 
-void schedule_set_result(schedule_t *sched, guint16 id, const gchar *output) {
-    g_return_if_fail(sched != NULL);
-    g_return_if_fail(output != NULL);
-
+/* End of a run of the task: output appended (NULL for an aborted job), the job released at release_ns (-1 = none) marked, the dispatcher is notified */
+static void schedule_finish_run(schedule_t *sched, guint16 id, gint64 release_ns, const gchar *output, const gchar *caller) {
     pthread_mutex_lock(&sched->schedule_results_mutex);     // LOCK MUTEX
 
     /* Find the result associated to the ID in the HashTable */
     task_result_t *res = g_hash_table_lookup(sched->schedule_results, GINT_TO_POINTER((gint)id));
 
     if (res == NULL) {
-        g_printerr("[WARNING] Execution Manager: in schedule_set_result Task ID %u not found.\n", id);
+        pthread_mutex_unlock(&sched->schedule_results_mutex);   // UNLOCK MUTEX
+        g_printerr("[WARNING] Execution Manager: in %s Task ID %u not found.\n", caller, id);
         return;
     }
 
     
     /* 1. Add the new output in the list */
-    GString *new_output = g_string_new(output);
-    res->output_list = g_slist_append(res->output_list, new_output);
+    if (output) {
+        GString *new_output = g_string_new(output);
+        res->output_list = g_slist_append(res->output_list, new_output);
+    }
 
     /* 2. Decrement the remainning runs (if greather than 0) */
+    guint8 runs_left = res->remaining_runs;
+    gboolean completed_run = (runs_left > 0);
+    if (completed_run) {
+        runs_left--;
+        __atomic_store_n(&res->remaining_runs, runs_left, __ATOMIC_RELEASE);
+    }
 
-    if (res->remaining_runs > 0) {
-        res->remaining_runs--;
+    /* 3. Mark the job, its expiration checks this one and not the other runs of the task */
+    if (release_ns >= 0) {
+        schedule_job_key_t *job = g_new(schedule_job_key_t, 1);
+        job->release_ns = release_ns;
+        job->task_id = id;
+        g_hash_table_add(sched->schedule_done_jobs, job);
     }
 
     pthread_mutex_unlock(&sched->schedule_results_mutex);   // UNLOCK MUTEX
 
-    g_print("[INFO] Execution Manager: Task %u updated: %u runs left.\n", id, res->remaining_runs);
+    /* 4. Notify the dispatcher */
+    if (completed_run) {
+        __atomic_store_n(&sched->schedule_last_completion_us, g_get_monotonic_time(), __ATOMIC_RELAXED);
+        g_atomic_int_add(&sched->schedule_pending_runs, -1);
+        schedule_notify_completion(sched);
+    }
+
+    g_print("[INFO] Execution Manager: Task %u updated: %u runs left.\n", id, runs_left);
 }
 
+void schedule_set_result(schedule_t *sched, guint16 id, const gchar *output) {
+    g_return_if_fail(sched != NULL);
+    g_return_if_fail(output != NULL);
 
-/* ----------------- Schedule Methods ----------------- */
+    schedule_finish_run(sched, id, -1, output, "schedule_set_result");
+}
 
-void schedule_add_task(schedule_t *sched, 
-                guint16 id, const gchar *name, GThreadFunc task_exec, gint policy, 
-                gint8 priority, gint cpu_affinity, guint8 repetition, GSList *depends_on, 
-                gint64 start_time, gint64 end_time, gpointer input) {
+/* A cancelled job ends its run without output, so an early end of the schedule still happens */
+void schedule_abort_run(schedule_t *sched, guint16 id) {
+    g_return_if_fail(sched != NULL);
 
-    g_return_if_fail(sched != NULL && name != NULL);
-    g_return_if_fail(start_time >= 0 && start_time < end_time);
+    schedule_finish_run(sched, id, -1, NULL, "schedule_abort_run");
+}
+
+/* Same as schedule_set_result, for the job of a timeline release (release_ns is its timeline offset) */
+void schedule_set_job_result(schedule_t *sched, guint16 id, gint64 release_ns, const gchar *output) {
+    g_return_if_fail(sched != NULL);
+    g_return_if_fail(output != NULL);
 
+    schedule_finish_run(sched, id, release_ns, output, "schedule_set_job_result");
+}
 
-    /* 2. Create Activation Data */
-    activation_data_t *act = g_new0(activation_data_t, 1);
-    act->task_id = id;
-    act->task_name = g_string_new(name);
-    act->task_exec = task_exec;
-    act->policy = policy;
-    act->priority = priority;
-    act->repetition = repetition;
-    act->cpu_affinity = cpu_affinity;
-    act->depends_on = g_slist_copy(depends_on);
-    act->input_data = input; 
+/* Same as schedule_abort_run, for the job of a timeline release: it no longer counts as a miss */
+void schedule_abort_job(schedule_t *sched, guint16 id, gint64 release_ns) {
+    g_return_if_fail(sched != NULL);
 
-    /* 3. Insert in timeline queue */
-    timeline_entry_t *st_entry = NULL;
-    for (GList *l = sched->schedule_start_info->head; l; l = l->next) {
-        timeline_entry_t *e = l->data;
-        if (e->timestamp == start_time) { st_entry = e; break; }
-    }
-    if (st_entry) {
-        st_entry->data_list = g_slist_append(st_entry->data_list, act);
-    } else {
-        timeline_entry_t *new_e = g_new0(timeline_entry_t, 1);
-        new_e->timestamp = start_time;
-        new_e->data_list = g_slist_append(NULL, act);
-        g_queue_insert_sorted(sched->schedule_start_info, new_e, compare_timeline_entries, NULL);
-    }
+    schedule_finish_run(sched, id, release_ns, NULL, "schedule_abort_job");
+}
 
-    /* 4. Create Expiration Data */
-    expiration_data_t *exp = g_new0(expiration_data_t, 1);
-    exp->task_id = id;
-    exp->task_name = g_string_new(name);
 
-    /* 5. Insert in timeline queue */
-    timeline_entry_t *end_entry = NULL;
-    for (GList *l = sched->schedule_end_info->head; l; l = l->next) {
-        timeline_entry_t *e = l->data;
-        if (e->timestamp == end_time) { end_entry = e; break; }
+/* Only clocks that never jump: TAI for schedules shared across hosts, MONOTONIC otherwise */
+gboolean schedule_set_clock(schedule_t *sched, clockid_t clock) {
+    g_return_val_if_fail(sched != NULL, FALSE);
+
+    if (clock != CLOCK_MONOTONIC && clock != CLOCK_TAI) {
+        g_printerr("[ERROR] Execution Manager: clock %d not supported for schedule %s\n", (gint)clock, sched->schedule_name->str);
+        return FALSE;
     }
-    if (end_entry) {
-        end_entry->data_list = g_slist_append(end_entry->data_list, exp);
-    } else {
-        timeline_entry_t *new_e = g_new0(timeline_entry_t, 1);
-        new_e->timestamp = end_time;
-        new_e->data_list = g_slist_append(NULL, exp);
-        g_queue_insert_sorted(sched->schedule_end_info, new_e, compare_timeline_entries, NULL);
+    sched->schedule_clock = clock;
+    return TRUE;
+}
+
+
+/* ----------------- Schedule Methods ----------------- */
+
+gboolean schedule_add_task_ns(schedule_t *sched, 
+                guint16 id, const gchar *name, GThreadFunc task_exec, gint policy, 
+                gint8 priority, gint cpu_affinity, guint8 repetition, GSList *depends_on, 
+                gint64 start_ns, gint64 end_ns, gpointer input) {
+
+    g_return_val_if_fail(sched != NULL && name != NULL, FALSE);
+    g_return_val_if_fail(start_ns >= 0 && start_ns < end_ns, FALSE);
+
+
+    /* 2. Create Activation Data (name interned, dependencies appended to the shared array) */
+    activation_data_t act = { 0 };
+    act.task_id = id;
+    act.name_id = schedule_intern_name(sched, name);
+    act.task_exec = task_exec;
+    act.policy = (guint8)policy;
+    act.priority = priority;
+    act.repetition = repetition;
+    act.cpu_affinity = (gint16)cpu_affinity;
+    act.deps_offset = sched->schedule_dependencies->len;
+    for (GSList *l = depends_on; l != NULL; l = l->next) {
+        guint16 dep = (guint16)GPOINTER_TO_INT(l->data);
+        g_array_append_val(sched->schedule_dependencies, dep);
+        act.deps_count++;
     }
+    act.input_data = input_pool_adopt(sched->schedule_inputs, input);
+    act.criticality = TASK_CRIT_LO;
 
+    return schedule_insert_activation(sched, &act, start_ns, end_ns, FALSE, NULL, NULL);
+}
 
-    /* 6. Init results in HashTable */
-    task_result_t *res = g_new0(task_result_t, 1);
-    res->remaining_runs = repetition;
-    res->output_list = NULL;
-    pthread_mutex_lock(&sched->schedule_results_mutex);     // LOCK MUTEX     
-    g_hash_table_insert(sched->schedule_results, GINT_TO_POINTER((gint)id), res);
-    pthread_mutex_unlock(&sched->schedule_results_mutex);   // UNLOCK MUTEX
+/* Millisecond API kept for the existing schedules, the timeline stores ns */
+void schedule_add_task(schedule_t *sched, 
+                guint16 id, const gchar *name, GThreadFunc task_exec, gint policy, 
+                gint8 priority, gint cpu_affinity, guint8 repetition, GSList *depends_on, 
+                gint64 start_time, gint64 end_time, gpointer input) {
 
-    /* 7. Update schedule duration */
-    if (end_time > sched->schedule_duration)
-        sched->schedule_duration = end_time;
+    g_return_if_fail(sched != NULL && name != NULL);
+    g_return_if_fail(start_time >= 0 && start_time < end_time);
+
+    gint64 start_ns, end_ns;
+    if (!em_time_ms_to_ns(start_time, &start_ns) || !em_time_ms_to_ns(end_time, &end_ns)) {
+        g_printerr("[ERROR] Execution Manager: Task ID %u window [%ld, %ld] ms out of range\n", id, (long)start_time, (long)end_time);
+        return;
+    }
+    schedule_add_task_ns(sched, id, name, task_exec, policy, priority, cpu_affinity, repetition, depends_on, start_ns, end_ns, input);
 }
 
 void schedule_reset(schedule_t *sched) {
@@ -244,12 +450,12 @@ void schedule_reset(schedule_t *sched) {
 
     GHashTableIter iter;
     gpointer key, value;
+    gint pending_runs = 0;
 
 
     /* Iterate on all the results that are stored in the HashTable */
     g_hash_table_iter_init(&iter, sched->schedule_results);
     while (g_hash_table_iter_next(&iter, &key, &value)) {
-        guint16 task_id = (guint16)GPOINTER_TO_INT(key);
         task_result_t *res = (task_result_t *)value;
 
         /* 1. Clean the list of the outputs */
@@ -261,17 +467,17 @@ void schedule_reset(schedule_t *sched) {
         res->output_list = NULL;
 
         /* 2. Restore the remaining_runs */
-        gboolean found = FALSE;
-        for (GList *l = sched->schedule_start_info->head; l && !found; l = l->next) {
-            timeline_entry_t *entry = l->data;
-            for (GSList *s = entry->data_list; s; s = s->next) {
-                activation_data_t *act = s->data;
-                if (act->task_id == task_id) {
-                    res->remaining_runs = act->repetition;
-                    found = TRUE;
-                    break;
-                }
-            }
+        res->remaining_runs = res->repetition;
+        pending_runs += res->repetition;
+    }
+    g_atomic_int_set(&sched->schedule_pending_runs, pending_runs);
+    g_hash_table_remove_all(sched->schedule_done_jobs);
+
+    /* 3. Drop the notifications of the previous run */
+    if (sched->schedule_completion_fd >= 0) {
+        guint64 count;
+        if (read(sched->schedule_completion_fd, &count, sizeof(count)) < 0) {
+            /* Nothing pending (EAGAIN) */
         }
     }
 
@@ -279,38 +485,565 @@ void schedule_reset(schedule_t *sched) {
 }
 
 
+gboolean schedule_add_plugin_task(schedule_t *sched,
+                guint16 id, const gchar *name, const gchar *plugin_path, const gchar *symbol, gint policy,
+                gint8 priority, gint cpu_affinity, guint8 repetition, GSList *depends_on,
+                gint64 start_time, gint64 end_time, gpointer input) {
+
+    g_return_val_if_fail(sched != NULL && name != NULL && plugin_path != NULL, FALSE);
+    g_return_val_if_fail(start_time >= 0 && start_time < end_time, FALSE);
+
+    /* 1. Load the plugin at schedule load, before time zero */
+    task_plugin_t *plugin = g_hash_table_lookup(sched->schedule_plugins, plugin_path);
+    if (!plugin) {
+        plugin = task_plugin_load(plugin_path);
+        if (!plugin) return FALSE;
+        g_hash_table_insert(sched->schedule_plugins, g_strdup(plugin_path), plugin);
+    }
+
+    /* 2. Resolve the entry point */
+    GThreadFunc task_exec = symbol ? task_plugin_resolve(plugin, symbol) : plugin->task_exec;
+    if (!task_exec) {
+        g_printerr("[ERROR] Execution Manager: Task ID %u has no entry point in %s\n", id, plugin_path);
+        return FALSE;
+    }
+
+    schedule_add_task(sched, id, name, task_exec, policy, priority, cpu_affinity, repetition, depends_on, start_time, end_time, input);
+    return TRUE;
+}
+
+void schedule_set_task_criticality(schedule_t *sched, guint16 id, task_criticality_t criticality, gint64 budget_lo_us, gint64 budget_hi_us) {
+    g_return_if_fail(sched != NULL);
+    g_return_if_fail(criticality == TASK_CRIT_LO || criticality == TASK_CRIT_HI);
+    g_return_if_fail(budget_lo_us >= 0 && (budget_hi_us == 0 || budget_lo_us <= budget_hi_us));
+
+    /* Applied to every activation of the task */
+    guint updated = 0;
+    for (GList *l = sched->schedule_start_info->head; l; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        for (guint i = 0; i < entry->items->len; i++) {
+            activation_data_t *act = timeline_entry_activation(entry, i);
+            if (act->task_id != id) continue;
+            act->criticality = criticality;
+            act->budget_lo_us = budget_lo_us;
+            act->budget_hi_us = budget_hi_us;
+            updated++;
+        }
+    }
+
+    if (updated == 0)
+        g_printerr("[WARNING] Execution Manager: in schedule_set_task_criticality Task ID %u not found.\n", id);
+}
+
+/* CPU time a job of the task may use, enforced on its worker independently of the deadline */
+gboolean schedule_set_task_cpu_budget(schedule_t *sched, guint16 id, gint64 cpu_budget_us, task_budget_action_t action) {
+    g_return_val_if_fail(sched != NULL, FALSE);
+    g_return_val_if_fail(cpu_budget_us >= 0 && cpu_budget_us <= G_MAXUINT32, FALSE);
+    g_return_val_if_fail(action == TASK_BUDGET_NOTIFY || action == TASK_BUDGET_DEMOTE || action == TASK_BUDGET_ABORT, FALSE);
+
+    guint updated = 0;
+    for (GList *l = sched->schedule_start_info->head; l; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        for (guint i = 0; i < entry->items->len; i++) {
+            activation_data_t *act = timeline_entry_activation(entry, i);
+            if (act->task_id != id) continue;
+            act->cpu_budget_us = (guint32)cpu_budget_us;
+            act->budget_action = (guint8)action;
+            updated++;
+        }
+    }
+
+    if (updated == 0) {
+        g_printerr("[WARNING] Execution Manager: in schedule_set_task_cpu_budget Task ID %u not found.\n", id);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* The input is copied once in the pool and shared by all the activations of the task */
+gboolean schedule_set_task_input(schedule_t *sched, guint16 id, gconstpointer data, gsize size, task_input_flags_t flags) {
+    g_return_val_if_fail(sched != NULL && data != NULL, FALSE);
+    g_return_val_if_fail(size > 0 && size <= G_MAXUINT32, FALSE);
+    g_return_val_if_fail(flags == TASK_INPUT_SHARED || flags == TASK_INPUT_MUTABLE, FALSE);
+
+    if (sched->schedule_inputs->placed) {
+        g_printerr("[ERROR] Execution Manager: inputs of %s are immutable after the first run.\n", sched->schedule_name->str);
+        return FALSE;
+    }
+
+    gpointer input = NULL;
+    for (GList *l = sched->schedule_start_info->head; l; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        for (guint i = 0; i < entry->items->len; i++) {
+            activation_data_t *act = timeline_entry_activation(entry, i);
+            if (act->task_id != id) continue;
+            if (!input) input = input_pool_stage(sched->schedule_inputs, data, size, flags == TASK_INPUT_MUTABLE);
+            act->input_data = input;
+            act->input_size = (guint32)size;
+            act->input_flags = (guint8)flags;
+        }
+    }
+
+    if (!input) {
+        g_printerr("[WARNING] Execution Manager: in schedule_set_task_input Task ID %u not found.\n", id);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* Moves the pooled inputs next to the CPUs of their workers (task cpu_affinity indexes cores, NULL = identity) */
+gboolean schedule_place_inputs(schedule_t *sched, const gint *cores, guint n_cores) {
+    g_return_val_if_fail(sched != NULL, FALSE);
+    if (sched->schedule_inputs->placed) return TRUE;
+
+    GArray *requests = g_array_new(FALSE, FALSE, sizeof(input_pool_request_t));
+    for (GList *l = sched->schedule_start_info->head; l; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        for (guint i = 0; i < entry->items->len; i++) {
+            activation_data_t *act = timeline_entry_activation(entry, i);
+            if (act->input_size == 0) continue;
+
+            input_pool_request_t req = { 0 };
+            req.input = &act->input_data;
+            req.size = act->input_size;
+            req.mutable_input = (act->input_flags == TASK_INPUT_MUTABLE);
+            req.cpu = schedule_map_cpu(cores, n_cores, act->cpu_affinity);
+            g_array_append_val(requests, req);
+        }
+    }
+
+    gboolean placed = input_pool_place(sched->schedule_inputs, (input_pool_request_t *)requests->data, requests->len);
+    g_array_free(requests, TRUE);
+    return placed;
+}
+
+/* Moves the result slots still on the heap to the NUMA node of the core running their task */
+gboolean schedule_place_results(schedule_t *sched, const gint *cores, guint n_cores) {
+    g_return_val_if_fail(sched != NULL, FALSE);
+
+    /* 1. Node of every task, from its first activation */
+    GHashTable *task_nodes = g_hash_table_new(g_direct_hash, g_direct_equal);     // Map: Task ID -> node + 1
+    for (GList *l = sched->schedule_start_info->head; l; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        for (guint i = 0; i < entry->items->len; i++) {
+            activation_data_t *act = timeline_entry_activation(entry, i);
+            gpointer key = GINT_TO_POINTER((gint)act->task_id);
+            if (g_hash_table_contains(task_nodes, key)) continue;
+            gint node = em_numa_node_of_cpu(schedule_map_cpu(cores, n_cores, act->cpu_affinity));
+            g_hash_table_insert(task_nodes, key, GINT_TO_POINTER(node + 1));
+        }
+    }
+
+    pthread_mutex_lock(&sched->schedule_results_mutex);     // LOCK MUTEX
+
+    /* 2. Slots to move per node (unpinned tasks keep theirs) */
+    guint counts[EM_NUMA_MAX_NODES] = { 0 };
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, sched->schedule_results);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        gint node = GPOINTER_TO_INT(g_hash_table_lookup(task_nodes, key)) - 1;
+        if (!((task_result_t *)value)->placed && node >= 0 && node < EM_NUMA_MAX_NODES) counts[node]++;
+    }
+
+    /* 3. One arena per node */
+    guint8 *next[EM_NUMA_MAX_NODES] = { NULL };
+    gboolean placed = TRUE;
+    for (gint node = 0; node < EM_NUMA_MAX_NODES; node++) {
+        if (counts[node] == 0) continue;
+        result_arena_t arena = { NULL, (gsize)counts[node] * SCHEDULE_RESULT_SLOT, node };
+        arena.base = em_numa_alloc(arena.size, node);
+        if (!arena.base) {
+            placed = FALSE;
+            continue;
+        }
+        g_array_append_val(sched->schedule_result_arenas, arena);
+        next[node] = arena.base;
+    }
+
+    /* 4. Move, the heap copy is released by the value destroy function */
+    g_hash_table_iter_init(&iter, sched->schedule_results);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        task_result_t *res = value;
+        gint node = GPOINTER_TO_INT(g_hash_table_lookup(task_nodes, key)) - 1;
+        if (res->placed || node < 0 || node >= EM_NUMA_MAX_NODES || !next[node]) continue;
+
+        task_result_t *slot = (task_result_t *)next[node];
+        next[node] += SCHEDULE_RESULT_SLOT;
+        *slot = *res;
+        slot->placed = TRUE;
+        res->output_list = NULL;
+        g_hash_table_iter_replace(&iter, slot);
+    }
+
+    pthread_mutex_unlock(&sched->schedule_results_mutex);   // UNLOCK MUTEX
+    g_hash_table_destroy(task_nodes);
+    return placed;
+}
+
+
+
+/* ----------------- Live Changes ----------------- */
+
+/* Copy of the first enabled activation of a task released after after_ns, with its window */
+gboolean schedule_get_activation(schedule_t *sched, guint16 id, gint64 after_ns, activation_data_t *act, gint64 *start_ns, gint64 *end_ns) {
+    g_return_val_if_fail(sched != NULL && act != NULL, FALSE);
+
+    gint64 found_ns = -1;
+    GTreeNode *node = g_tree_upper_bound(sched->schedule_start_index, &after_ns);
+    for (GList *l = node ? g_tree_node_value(node) : NULL; l && found_ns < 0; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        for (guint i = 0; i < entry->items->len; i++) {
+            activation_data_t *a = timeline_entry_activation(entry, i);
+            if (a->task_id != id || a->disabled) continue;
+            *act = *a;
+            found_ns = entry->timestamp_ns;
+            break;
+        }
+    }
+    if (found_ns < 0) return FALSE;
+
+    /* The matching expiration is the one of the task paired with the release */
+    gint64 deadline_ns = -1;
+    node = g_tree_upper_bound(sched->schedule_end_index, &found_ns);
+    for (GList *l = node ? g_tree_node_value(node) : NULL; l && deadline_ns < 0; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        for (guint i = 0; i < entry->items->len; i++) {
+            expiration_data_t *exp = timeline_entry_expiration(entry, i);
+            if (exp->task_id == id && exp->release_ns == found_ns && !exp->disabled) {
+                deadline_ns = entry->timestamp_ns;
+                break;
+            }
+        }
+    }
+    if (start_ns) *start_ns = found_ns;
+    if (end_ns) *end_ns = (deadline_ns >= 0) ? deadline_ns : sched->schedule_duration_ns;
+    return TRUE;
+}
+
+/* Enabled activation of a task released at release_ns (the pair of an expiration), NULL if none: O(log n) */
+activation_data_t* schedule_find_activation(schedule_t *sched, guint16 id, gint64 release_ns) {
+    g_return_val_if_fail(sched != NULL, NULL);
+
+    /* The index points to the first entry of the timestamp, live merges add fresh ones right after it */
+    for (GList *l = g_tree_lookup(sched->schedule_start_index, &release_ns); l; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        if (entry->timestamp_ns != release_ns) break;
+        for (guint i = 0; i < entry->items->len; i++) {
+            activation_data_t *act = timeline_entry_activation(entry, i);
+            if (act->task_id == id && !act->disabled) return act;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Adds one activation while the schedule runs: the position is found in
+ * O(log n) and the records go in fresh entries, so the entries already
+ * planned (read by the dispatcher and the deadline timer thread) are never
+ * touched. Live tasks have no dependencies; the caller plans the returned
+ * entries.
+ */
+gboolean schedule_merge_task_ns(schedule_t *sched, const activation_data_t *act, const gchar *name, gint64 start_ns, gint64 end_ns,
+                                timeline_entry_t **start_entry, timeline_entry_t **end_entry) {
+    g_return_val_if_fail(sched != NULL && act != NULL, FALSE);
+    g_return_val_if_fail(start_ns >= 0 && start_ns < end_ns, FALSE);
+    g_return_val_if_fail(act->deps_count == 0, FALSE);
+
+    /* NULL name: the record keeps the interned name of the task it was copied from */
+    activation_data_t merged = *act;
+    if (name) merged.name_id = schedule_intern_name(sched, name);
+    merged.disabled = FALSE;
+    return schedule_insert_activation(sched, &merged, start_ns, end_ns, TRUE, start_entry, end_entry);
+}
+
+/*
+ * Disables the activations of a task released after after_ns and their
+ * expirations, returns the activations disabled. The jobs released before
+ * after_ns keep their deadline and their runs: they are still waited for
+ * and a miss is still reported.
+ */
+guint schedule_disable_task(schedule_t *sched, guint16 id, gint64 after_ns) {
+    g_return_val_if_fail(sched != NULL, 0);
+
+    /* 1. Activations not released yet (read by the dispatcher only) */
+    guint disabled = 0;
+    GTreeNode *node = g_tree_upper_bound(sched->schedule_start_index, &after_ns);
+    for (GList *l = node ? g_tree_node_value(node) : NULL; l; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        for (guint i = 0; i < entry->items->len; i++) {
+            activation_data_t *act = timeline_entry_activation(entry, i);
+            if (act->task_id != id || act->disabled) continue;
+            act->disabled = TRUE;
+            disabled++;
+        }
+    }
+    if (disabled == 0) return 0;
+
+    /* 2. Their expirations (paired by release), possibly being checked by the deadline timer thread */
+    node = g_tree_upper_bound(sched->schedule_end_index, &after_ns);
+    for (GList *l = node ? g_tree_node_value(node) : NULL; l; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        for (guint i = 0; i < entry->items->len; i++) {
+            expiration_data_t *exp = timeline_entry_expiration(entry, i);
+            if (exp->task_id == id && exp->release_ns > after_ns) __atomic_store_n(&exp->disabled, TRUE, __ATOMIC_RELAXED);
+        }
+    }
+
+    /* 3. The dropped runs are not waited for anymore, in this run or the next ones */
+    pthread_mutex_lock(&sched->schedule_results_mutex);     // LOCK MUTEX
+    task_result_t *res = g_hash_table_lookup(sched->schedule_results, GINT_TO_POINTER((gint)id));
+    gint pending = g_atomic_int_get(&sched->schedule_pending_runs);
+    if (res) {
+        guint8 dropped = (guint8)MIN(disabled, res->remaining_runs);
+        pending = g_atomic_int_add(&sched->schedule_pending_runs, -(gint)dropped) - dropped;
+        res->repetition -= (guint8)MIN(disabled, res->repetition);
+        __atomic_store_n(&res->remaining_runs, res->remaining_runs - dropped, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&sched->schedule_results_mutex);   // UNLOCK MUTEX
+
+    if (pending <= 0) schedule_notify_completion(sched);
+    return disabled;
+}
+
+/* Drops the disabled records, merges the entries sharing a timestamp and rebuilds the index */
+static void timeline_compact(GQueue *timeline, GTree **index, gboolean activations) {
+    timeline_entry_t *prev = NULL;
+    GList *l = timeline->head;
+    while (l) {
+        GList *next = l->next;
+        timeline_entry_t *entry = l->data;
+
+        for (guint i = entry->items->len; i-- > 0;) {
+            gboolean disabled = activations ? timeline_entry_activation(entry, i)->disabled : timeline_entry_expiration(entry, i)->disabled;
+            if (disabled) g_array_remove_index(entry->items, i);
+        }
+        if (prev && prev->timestamp_ns == entry->timestamp_ns) {
+            g_array_append_vals(prev->items, entry->items->data, entry->items->len);
+            g_array_set_size(entry->items, 0);
+        }
+
+        if (entry->items->len == 0) {
+            g_queue_delete_link(timeline, l);
+            timeline_entry_free_wrapper(entry);
+        } else {
+            prev = entry;
+        }
+        l = next;
+    }
+
+    g_tree_destroy(*index);
+    *index = g_tree_new(compare_timestamps);
+    for (l = timeline->head; l; l = l->next) g_tree_insert(*index, &((timeline_entry_t *)l->data)->timestamp_ns, l);
+}
+
+/* Folds the live changes of the last run in the schedule, called once nothing reads it */
+void schedule_compact(schedule_t *sched) {
+    g_return_if_fail(sched != NULL);
+
+    timeline_compact(sched->schedule_start_info, &sched->schedule_start_index, TRUE);
+    timeline_compact(sched->schedule_end_info, &sched->schedule_end_index, FALSE);
+
+    timeline_entry_t *last = g_queue_peek_tail(sched->schedule_end_info);
+    sched->schedule_duration_ns = last ? last->timestamp_ns : 0;
+
+    pthread_mutex_lock(&sched->schedule_results_mutex);     // LOCK MUTEX
+    schedule_free_retired_results(sched);
+    pthread_mutex_unlock(&sched->schedule_results_mutex);   // UNLOCK MUTEX
+}
+
+//* ----------------- Shared Resources -----------------*/
+
+resource_t* schedule_add_resource(schedule_t *sched, const gchar *name) {
+    g_return_val_if_fail(sched != NULL && name != NULL, NULL);
+
+    resource_t *res = g_hash_table_lookup(sched->schedule_resource_index, name);
+    if (res) return res;
+    if (sched->schedule_resources->len >= RESOURCE_NO_TASK) {
+        g_printerr("[ERROR] Execution Manager: too many resources in %s.\n", sched->schedule_name->str);
+        return NULL;
+    }
+
+    res = resource_new(name, (guint16)sched->schedule_resources->len);
+    g_ptr_array_add(sched->schedule_resources, res);
+    g_hash_table_insert(sched->schedule_resource_index, res->name, res);
+    return res;
+}
+
+resource_t* schedule_get_resource(schedule_t *sched, const gchar *name) {
+    g_return_val_if_fail(sched != NULL && name != NULL, NULL);
+    return g_hash_table_lookup(sched->schedule_resource_index, name);
+}
+
+/* The task locks the resource, for at most cs_us per critical section */
+gboolean schedule_task_uses_resource(schedule_t *sched, guint16 id, const gchar *name, gint64 cs_us) {
+    g_return_val_if_fail(sched != NULL && name != NULL, FALSE);
+
+    resource_t *res = schedule_get_resource(sched, name);
+    if (!res) {
+        g_printerr("[WARNING] Execution Manager: in schedule_task_uses_resource resource %s not declared.\n", name);
+        return FALSE;
+    }
+    resource_add_user(res, id, cs_us);
+    return TRUE;
+}
+
+/* Ceiling of every resource = highest priority of its users; called before each run */
+gboolean schedule_prepare_resources(schedule_t *sched) {
+    g_return_val_if_fail(sched != NULL, FALSE);
+
+    gboolean ready = TRUE;
+    for (guint r = 0; r < sched->schedule_resources->len; r++) {
+        resource_t *res = g_ptr_array_index(sched->schedule_resources, r);
+        gint ceiling = 0;
+        for (guint u = 0; u < res->users->len; u++) {
+            gint priority, cpu_affinity;
+            if (schedule_task_sched_info(sched, g_array_index(res->users, resource_use_t, u).task_id, &priority, &cpu_affinity)) {
+                ceiling = MAX(ceiling, priority);
+            }
+        }
+        ready &= resource_set_ceiling(res, ceiling);
+    }
+    return ready;
+}
+
+/*
+ * Worst case blocking of a task, in us. Local: under the priority ceiling a
+ * job waits at most for one critical section of a lower priority task of its
+ * core on a resource whose ceiling reaches its priority. Remote: one critical
+ * section of another core for every resource the task uses. Critical sections
+ * are the declared ones, or the measured ones when longer.
+ */
+gint64 schedule_resource_blocking_us(schedule_t *sched, guint16 id) {
+    g_return_val_if_fail(sched != NULL, 0);
+
+    gint priority, cpu_affinity;
+    if (!schedule_task_sched_info(sched, id, &priority, &cpu_affinity)) return 0;
+
+    gint64 local_us = 0, remote_us = 0;
+    for (guint r = 0; r < sched->schedule_resources->len; r++) {
+        resource_t *res = g_ptr_array_index(sched->schedule_resources, r);
+        gboolean uses = (resource_get_user(res, id) != NULL);
+        gint64 remote_cs_us = 0;
+
+        for (guint u = 0; u < res->users->len; u++) {
+            resource_use_t *use = &g_array_index(res->users, resource_use_t, u);
+            gint other_priority, other_cpu;
+            if (use->task_id == id || !schedule_task_sched_info(sched, use->task_id, &other_priority, &other_cpu)) continue;
+
+            gint64 measured_us = (__atomic_load_n(&use->max_hold_ns, __ATOMIC_RELAXED) + EM_NSEC_PER_USEC - 1) / EM_NSEC_PER_USEC;
+            gint64 cs_us = MAX(use->cs_us, measured_us);
+            if (other_cpu == cpu_affinity) {
+                if (other_priority < priority && res->ceiling >= priority) local_us = MAX(local_us, cs_us);
+            } else if (uses) {
+                remote_cs_us = MAX(remote_cs_us, cs_us);
+            }
+        }
+        remote_us += remote_cs_us;
+    }
+    return local_us + remote_us;
+}
+
+void schedule_print_resources(schedule_t *sched) {
+    if (!sched || sched->schedule_resources->len == 0) return;
+
+    g_print("\n--- SHARED RESOURCES ---\n");
+    for (guint r = 0; r < sched->schedule_resources->len; r++) {
+        resource_t *res = g_ptr_array_index(sched->schedule_resources, r);
+        guint64 acquisitions = __atomic_load_n(&res->acquisitions, __ATOMIC_RELAXED);
+        g_print("%s: %s ceiling %d, %" G_GUINT64_FORMAT " lock(s), hold avg %.1f us max %.1f us, %" G_GUINT64_FORMAT " overrun(s), %"
+                G_GUINT64_FORMAT " undeclared, %" G_GUINT64_FORMAT " refused\n",
+                res->name, (res->protocol == PTHREAD_PRIO_PROTECT) ? "PRIO_PROTECT" : "PRIO_INHERIT", res->ceiling, acquisitions,
+                acquisitions ? (gdouble)__atomic_load_n(&res->total_hold_ns, __ATOMIC_RELAXED) / acquisitions / EM_NSEC_PER_USEC : 0.0,
+                (gdouble)__atomic_load_n(&res->max_hold_ns, __ATOMIC_RELAXED) / EM_NSEC_PER_USEC,
+                __atomic_load_n(&res->overruns, __ATOMIC_RELAXED), __atomic_load_n(&res->undeclared, __ATOMIC_RELAXED),
+                __atomic_load_n(&res->lock_errors, __ATOMIC_RELAXED));
+        for (guint u = 0; u < res->users->len; u++) {
+            resource_use_t *use = &g_array_index(res->users, resource_use_t, u);
+            g_print("    Task ID %u: CS %ld us declared, %.1f us measured, Blocking: %ld us\n",
+                    use->task_id, (long)use->cs_us, (gdouble)__atomic_load_n(&use->max_hold_ns, __ATOMIC_RELAXED) / EM_NSEC_PER_USEC,
+                    (long)schedule_resource_blocking_us(sched, use->task_id));
+        }
+    }
+}
+
+
 //* ----------------- Other Methods -----------------*/
 
 
+const gchar *schedule_task_name(schedule_t *sched, guint32 name_id) {
+    g_return_val_if_fail(sched != NULL, NULL);
+    g_return_val_if_fail(name_id < sched->schedule_task_names->len, NULL);
+    return g_ptr_array_index(sched->schedule_task_names, name_id);
+}
+
+const guint16 *schedule_task_dependencies(schedule_t *sched, const activation_data_t *act) {
+    g_return_val_if_fail(sched != NULL && act != NULL, NULL);
+    if (act->deps_count == 0) return NULL;
+    return &g_array_index(sched->schedule_dependencies, guint16, act->deps_offset);
+}
+
+gboolean schedule_has_task(schedule_t *sched, guint16 id)
+{
+    if (!sched) return FALSE;
+    return g_hash_table_contains(__atomic_load_n(&sched->schedule_results, __ATOMIC_ACQUIRE), GINT_TO_POINTER((gint)id));
+}
+
 gboolean schedule_is_task_completed(schedule_t *sched, guint16 id)
 {
     if (!sched) return FALSE;
 
-    pthread_mutex_lock(&sched->schedule_results_mutex);     // LOCK MUTEX
+    /* Lock-free: the table is only resized while building the schedule, live merges swap it */
     task_result_t *res = g_hash_table_lookup(
-        sched->schedule_results,
+        __atomic_load_n(&sched->schedule_results, __ATOMIC_ACQUIRE),
         GINT_TO_POINTER(id)
     );
-    gboolean completed = (res && res->remaining_runs == 0);
+    return (res && __atomic_load_n(&res->remaining_runs, __ATOMIC_ACQUIRE) == 0);
+}
+
+/* Job released at release_ns finished (or aborted) in the current run: the per-job check of an expiration */
+gboolean schedule_is_job_completed(schedule_t *sched, guint16 id, gint64 release_ns)
+{
+    if (!sched) return FALSE;
+
+    schedule_job_key_t job = { release_ns, id };
+    pthread_mutex_lock(&sched->schedule_results_mutex);     // LOCK MUTEX
+    gboolean done = g_hash_table_contains(sched->schedule_done_jobs, &job);
     pthread_mutex_unlock(&sched->schedule_results_mutex);   // UNLOCK MUTEX
+    return done;
+}
+
+guint8 schedule_get_remaining_runs(schedule_t *sched, guint16 id)
+{
+    if (!sched) return 0;
+
+    /* Lock-free, same as schedule_is_task_completed */
+    task_result_t *res = g_hash_table_lookup(__atomic_load_n(&sched->schedule_results, __ATOMIC_ACQUIRE), GINT_TO_POINTER(id));
+    return res ? __atomic_load_n(&res->remaining_runs, __ATOMIC_ACQUIRE) : 0;
+}
+
 
-    return completed;
+gboolean schedule_is_completed(schedule_t *sched)
+{
+    if (!sched) return FALSE;
+    return g_atomic_int_get(&sched->schedule_pending_runs) <= 0;
 }
 
 
 void schedule_print(schedule_t *sched) {
     if (!sched) return;
 
-    g_print("\n=== SCHEDULE: %s (v%s) [%ld ms] ===\n", 
-            sched->schedule_name->str, sched->schedule_version->str, (long)sched->schedule_duration);
+    g_print("\n=== SCHEDULE: %s (v%s) [%.3f ms, %s] ===\n", 
+            sched->schedule_name->str, sched->schedule_version->str, (gdouble)sched->schedule_duration_ns / EM_NSEC_PER_MSEC,
+            (sched->schedule_clock == CLOCK_TAI) ? "TAI" : "MONOTONIC");
 
     g_print("\n--- TIMELINE (START) ---\n");
     for (GList *l = sched->schedule_start_info->head; l; l = l->next) {
         timeline_entry_t *e = l->data;
-        g_print("[%4ld ms]:", (long)e->timestamp);
-        for (GSList *s = e->data_list; s; s = s->next) {
-            activation_data_t *a = s->data;
-            g_print(" [Activate Task %u (%s)]", a->task_id, a->task_name->str);
+        g_print("[%9.3f ms]:", (gdouble)e->timestamp_ns / EM_NSEC_PER_MSEC);
+        for (guint i = 0; i < e->items->len; i++) {
+            activation_data_t *a = timeline_entry_activation(e, i);
+            g_print(" [Activate Task %u (%s)%s]", a->task_id, schedule_task_name(sched, a->name_id), (a->criticality == TASK_CRIT_HI) ? " HI" : "");
         }
         g_print("\n");
     }
@@ -325,6 +1058,7 @@ void schedule_print(schedule_t *sched) {
         g_print("Task ID %u: Runs Left: %u, Last Output: %s\n", 
                 id, res->remaining_runs, (res->output_list) ? ((GString*)res->output_list->data)->str : "N/A");
     }
+    schedule_print_resources(sched);
     g_print("==========================================\n");
 }
 
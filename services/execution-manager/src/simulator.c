@@ -0,0 +1,321 @@
+#include "simulator.h"
+#include "em_time.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* --- Internal Structures --- */
+
+typedef struct {
+    activation_data_t *act;     // Activation of the job (owned by the schedule)
+    gint64 release_ns;          // Virtual release time, pairs the job with its expiration
+    guint16 task_id;            // Task of the job, key of the unfinished set with release_ns
+    gint64 remaining_ns;        // Execution time still to be served
+    gint64 start_ns;            // First time the job got the core, -1 if never
+    gint eff_priority;          // RT priority, SCHED_OTHER jobs below every RT job
+    guint64 seq;                // Release order, FIFO among equal priorities
+} sim_job_t;
+
+typedef struct {
+    gint cpu;
+    sim_job_t *running;         // Job on the core, NULL if idle
+    GQueue *ready;              // Ready jobs sorted by (eff_priority desc, seq asc)
+} sim_core_t;
+
+
+/* -----------------Helper Functions ----------------- */
+
+static gint sim_effective_priority(const activation_data_t *act) {
+    return (act->policy == SCHED_FIFO || act->policy == SCHED_RR) ? act->priority : -1;
+}
+
+static gint compare_jobs(gconstpointer a, gconstpointer b, gpointer user_data) {
+    const sim_job_t *ja = (const sim_job_t *)a;
+    const sim_job_t *jb = (const sim_job_t *)b;
+    if (ja->eff_priority != jb->eff_priority) return (ja->eff_priority > jb->eff_priority) ? -1 : 1;
+    return (ja->seq < jb->seq) ? -1 : (ja->seq > jb->seq) ? 1 : 0;
+}
+
+/* Unfinished jobs are looked up by (task_id, release_ns), the pair of an expiration */
+static guint sim_job_hash(gconstpointer key) {
+    const sim_job_t *job = (const sim_job_t *)key;
+    return g_int64_hash(&job->release_ns) ^ ((guint)job->task_id * 2654435761u);
+}
+
+static gboolean sim_job_equal(gconstpointer a, gconstpointer b) {
+    const sim_job_t *ja = (const sim_job_t *)a;
+    const sim_job_t *jb = (const sim_job_t *)b;
+    return ja->task_id == jb->task_id && ja->release_ns == jb->release_ns;
+}
+
+static void sim_core_free(gpointer data) {
+    sim_core_t *core = (sim_core_t *)data;
+    if (core) {
+        g_free(core->running);
+        g_queue_free_full(core->ready, g_free);
+        g_free(core);
+    }
+}
+
+static sim_core_t *sim_get_core(GHashTable *cores, GPtrArray *core_list, gint cpu) {
+    sim_core_t *core = g_hash_table_lookup(cores, GINT_TO_POINTER(cpu));
+    if (!core) {
+        core = g_new0(sim_core_t, 1);
+        core->cpu = cpu;
+        core->ready = g_queue_new();
+        g_hash_table_insert(cores, GINT_TO_POINTER(cpu), core);
+        g_ptr_array_add(core_list, core);
+    }
+    return core;
+}
+
+static gint64 sim_measure_exec_ns(activation_data_t *act) {
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t0);
+    resource_set_current_task(act->task_id);
+    gpointer res = act->task_exec ? act->task_exec(input_pool_job_input(act->input_data, act->input_size, act->input_flags == TASK_INPUT_MUTABLE)) : NULL;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t1);
+    g_free(res);
+
+    gint64 ns = (gint64)(t1.tv_sec - t0.tv_sec) * EM_NSEC_PER_SEC + (t1.tv_nsec - t0.tv_nsec);
+    return MAX(ns, 1);
+}
+
+/* Profiles are in microseconds, the virtual clock runs in nanoseconds */
+static gint64 sim_exec_time_ns(sim_config_t *cfg, GRand *rand, activation_data_t *act) {
+    switch (cfg->model) {
+        case SIM_EXEC_PROFILE: {
+            sim_wcet_t *w = g_hash_table_lookup(cfg->wcet_profile, GUINT_TO_POINTER(act->task_id));
+            if (!w) return em_time_us_to_ns(cfg->fixed_exec_us);
+            if (w->max_us <= w->min_us) return em_time_us_to_ns(w->min_us);
+            return em_time_us_to_ns(w->min_us + (gint64)(g_rand_double(rand) * (gdouble)(w->max_us - w->min_us + 1)));
+        }
+        case SIM_EXEC_MEASURED:
+            return sim_measure_exec_ns(act);
+        case SIM_EXEC_FIXED:
+        default:
+            return em_time_us_to_ns(cfg->fixed_exec_us);
+    }
+}
+
+/* Give the core to the highest priority ready job if it beats the running one */
+static void sim_dispatch(sim_core_t *core, gint64 now_ns, trace_buffer_t *trace) {
+    sim_job_t *head = g_queue_peek_head(core->ready);
+    if (!head) return;
+    if (core->running && core->running->eff_priority >= head->eff_priority) return;
+
+    g_queue_pop_head(core->ready);
+    if (core->running) {
+        g_queue_insert_sorted(core->ready, core->running, compare_jobs, NULL);
+    }
+    core->running = head;
+
+    if (head->start_ns < 0) {
+        head->start_ns = now_ns;
+        trace_record_at(trace, em_time_ns_to_us(now_ns), TRACE_EVENT_START, head->act->task_id, core->cpu, em_time_ns_to_us(now_ns - head->release_ns));
+    }
+}
+
+
+
+/* ----------------- Simulation Config Constructor/Destructor ----------------- */
+
+sim_config_t* sim_config_new(sim_exec_model_t model, gint64 fixed_exec_us, guint32 seed) {
+    g_return_val_if_fail(fixed_exec_us >= 0, NULL);
+
+    sim_config_t *cfg = g_new0(sim_config_t, 1);
+    cfg->model = model;
+    cfg->fixed_exec_us = fixed_exec_us;
+    cfg->seed = seed;
+    cfg->wcet_profile = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    return cfg;
+}
+
+void sim_config_free(sim_config_t *cfg) {
+    if (!cfg) return;
+
+    g_hash_table_destroy(cfg->wcet_profile);
+    g_free(cfg);
+}
+
+
+/* ----------------- Simulation Config Setters ----------------- */
+
+void sim_config_set_wcet(sim_config_t *cfg, guint16 task_id, gint64 min_us, gint64 max_us) {
+    g_return_if_fail(cfg != NULL);
+    g_return_if_fail(min_us >= 0 && min_us <= max_us);
+
+    sim_wcet_t *w = g_new0(sim_wcet_t, 1);
+    w->min_us = min_us;
+    w->max_us = max_us;
+    g_hash_table_replace(cfg->wcet_profile, GUINT_TO_POINTER(task_id), w);
+}
+
+/* Profile format: one "task_id min_us max_us" per line, '#' starts a comment */
+gboolean sim_config_load_wcet_profile(sim_config_t *cfg, const gchar *path) {
+    g_return_val_if_fail(cfg != NULL, FALSE);
+    g_return_val_if_fail(path != NULL, FALSE);
+
+    gchar *contents = NULL;
+    if (!g_file_get_contents(path, &contents, NULL, NULL)) {
+        g_printerr("[ERROR] Simulator: cannot read WCET profile %s\n", path);
+        return FALSE;
+    }
+
+    gchar **lines = g_strsplit(contents, "\n", -1);
+    for (guint i = 0; lines[i]; i++) {
+        gchar *line = g_strstrip(lines[i]);
+        if (line[0] == '\0' || line[0] == '#') continue;
+
+        guint id;
+        long min_us, max_us;
+        if (sscanf(line, "%u %ld %ld", &id, &min_us, &max_us) != 3 || id > G_MAXUINT16 || min_us < 0 || min_us > max_us) {
+            g_printerr("[WARNING] Simulator: invalid WCET profile line %u: %s\n", i + 1, line);
+            continue;
+        }
+        sim_config_set_wcet(cfg, (guint16)id, min_us, max_us);
+    }
+
+    g_strfreev(lines);
+    g_free(contents);
+    return TRUE;
+}
+
+
+/* ----------------- Simulation Backend ----------------- */
+
+gboolean em_simulate_schedule(execution_manager_t *em, schedule_t *sched, sim_config_t *cfg, sim_report_t *report) {
+    g_return_val_if_fail(em != NULL, FALSE);
+    g_return_val_if_fail(sched != NULL, FALSE);
+    g_return_val_if_fail(cfg != NULL, FALSE);
+
+    sim_report_t local_report;
+    if (!report) report = &local_report;
+    memset(report, 0, sizeof(sim_report_t));
+
+    gint64 wall_start_us = g_get_monotonic_time();
+    GRand *rand = g_rand_new_with_seed(cfg->seed);
+    GHashTable *cores = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, sim_core_free);
+    GPtrArray *core_list = g_ptr_array_new();
+    GHashTable *unfinished = g_hash_table_new(sim_job_hash, sim_job_equal);    // Set of the released jobs, owned by the cores
+
+    em->run_count++;
+    if (em->trace) trace_reset(em->trace, 0);
+
+    GList *next_start = sched->schedule_start_info->head;
+    GList *next_end = sched->schedule_end_info->head;
+    gint64 now_ns = 0;
+    guint64 seq = 0;
+
+    g_print("[INFO] Simulator: simulating schedule %s (v%s) [%.3f ms]\n",
+            sched->schedule_name->str, sched->schedule_version->str, (gdouble)sched->schedule_duration_ns / EM_NSEC_PER_MSEC);
+
+    /* The run ends at the last deadline, like em_run_schedule */
+    while (next_start || next_end) {
+
+        /* 1. Next event: release, deadline or job completion */
+        gint64 t = G_MAXINT64;
+        if (next_start) t = MIN(t, ((timeline_entry_t *)next_start->data)->timestamp_ns);
+        if (next_end) t = MIN(t, ((timeline_entry_t *)next_end->data)->timestamp_ns);
+        for (guint i = 0; i < core_list->len; i++) {
+            sim_core_t *core = g_ptr_array_index(core_list, i);
+            if (core->running) t = MIN(t, em_time_add_sat(now_ns, core->running->remaining_ns));
+        }
+
+        /* 2. Advance the virtual clock and charge the running jobs */
+        for (guint i = 0; i < core_list->len; i++) {
+            sim_core_t *core = g_ptr_array_index(core_list, i);
+            if (core->running) core->running->remaining_ns -= (t - now_ns);
+        }
+        now_ns = t;
+
+        /* 3. Completions */
+        for (guint i = 0; i < core_list->len; i++) {
+            sim_core_t *core = g_ptr_array_index(core_list, i);
+            if (!core->running || core->running->remaining_ns > 0) continue;
+
+            sim_job_t *job = core->running;
+            core->running = NULL;
+            trace_record_at(em->trace, em_time_ns_to_us(now_ns), TRACE_EVENT_FINISH, job->act->task_id, core->cpu, 0);
+            schedule_set_result(sched, job->act->task_id, "{}");
+            report->jobs_completed++;
+            g_hash_table_remove(unfinished, job);
+            g_free(job);
+
+            sim_dispatch(core, now_ns, em->trace);
+        }
+
+        /* 4. Deadlines */
+        if (next_end && ((timeline_entry_t *)next_end->data)->timestamp_ns == now_ns) {
+            timeline_entry_t *entry = next_end->data;
+            for (guint k = 0; k < entry->items->len; k++) {
+                expiration_data_t *exp = timeline_entry_expiration(entry, k);
+                if (exp->disabled) continue;
+                trace_record_at(em->trace, em_time_ns_to_us(now_ns), TRACE_EVENT_DEADLINE, exp->task_id, exp->cpu_affinity, 0);
+
+                /* Only the job released with this deadline counts, not the other runs of the task */
+                sim_job_t key = { .task_id = exp->task_id, .release_ns = exp->release_ns };
+                if (!g_hash_table_contains(unfinished, &key)) continue;
+
+                report->deadline_misses++;
+                trace_record_at(em->trace, em_time_ns_to_us(now_ns), TRACE_EVENT_ABORT, exp->task_id, exp->cpu_affinity, 0);
+                g_print("[MISS] Simulator: Task %u (%s) missed its deadline at %.3f ms\n",
+                        exp->task_id, schedule_task_name(sched, exp->name_id), (gdouble)entry->timestamp_ns / EM_NSEC_PER_MSEC);
+            }
+            next_end = next_end->next;
+        }
+
+        /* 5. Releases */
+        if (next_start && ((timeline_entry_t *)next_start->data)->timestamp_ns == now_ns) {
+            timeline_entry_t *entry = next_start->data;
+            for (guint k = 0; k < entry->items->len; k++) {
+                activation_data_t *act = timeline_entry_activation(entry, k);
+                if (act->disabled) continue;
+                sim_core_t *core = sim_get_core(cores, core_list, act->cpu_affinity);
+
+                sim_job_t *job = g_new0(sim_job_t, 1);
+                job->act = act;
+                job->release_ns = now_ns;
+                job->task_id = act->task_id;
+                job->remaining_ns = MAX(sim_exec_time_ns(cfg, rand, act), 0);
+                job->start_ns = -1;
+                job->eff_priority = sim_effective_priority(act);
+                job->seq = seq++;
+
+                trace_record_at(em->trace, em_time_ns_to_us(now_ns), TRACE_EVENT_RELEASE, act->task_id, act->cpu_affinity, 0);
+                g_queue_insert_sorted(core->ready, job, compare_jobs, NULL);
+                g_hash_table_add(unfinished, job);
+                report->jobs_released++;
+            }
+            for (guint i = 0; i < core_list->len; i++) {
+                sim_dispatch(g_ptr_array_index(core_list, i), now_ns, em->trace);
+            }
+            next_start = next_start->next;
+        }
+    }
+
+    /* Jobs that the last deadline left behind */
+    for (guint i = 0; i < core_list->len; i++) {
+        sim_core_t *core = g_ptr_array_index(core_list, i);
+        report->jobs_unfinished += g_queue_get_length(core->ready) + (core->running ? 1 : 0);
+    }
+
+    report->virtual_end_ns = now_ns;
+    report->wall_time_us = g_get_monotonic_time() - wall_start_us;
+
+    g_print("\n=== SIMULATION REPORT: %s (v%s) ===\n", sched->schedule_name->str, sched->schedule_version->str);
+    g_print("Virtual time: %.3f ms, wall time: %ld us\n", (gdouble)report->virtual_end_ns / EM_NSEC_PER_MSEC, (long)report->wall_time_us);
+    g_print("Jobs released: %" G_GUINT64_FORMAT ", completed: %" G_GUINT64_FORMAT ", unfinished: %" G_GUINT64_FORMAT "\n",
+            report->jobs_released, report->jobs_completed, report->jobs_unfinished);
+    g_print("Deadline misses: %" G_GUINT64_FORMAT "\n", report->deadline_misses);
+    g_print("==========================================\n");
+
+    em_export_trace(em, sched, "sim");
+
+    g_hash_table_destroy(unfinished);
+    g_ptr_array_free(core_list, TRUE);
+    g_hash_table_destroy(cores);
+    g_rand_free(rand);
+    return TRUE;
+}
@@ -0,0 +1,106 @@
+#define _GNU_SOURCE
+#include "stack_pool.h"
+#include "em_numa.h"
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/* -----------------Helper Functions ----------------- */
+
+static void stack_pool_cpu_free(gpointer data) {
+    stack_pool_cpu_t *cpu = (stack_pool_cpu_t *)data;
+    if (!cpu) return;
+
+    /* The memory goes away with the mapping: wait for the jobs still running on it */
+    for (guint i = 0; i < cpu->n_stacks; i++) {
+        if (cpu->stacks[i].busy) pthread_join(cpu->stacks[i].thread, NULL);
+    }
+    em_numa_free(cpu->map, cpu->map_size);
+    g_free(cpu->stacks);
+    g_free(cpu);
+}
+
+
+/* ----------------- Stack Pool Constructor/Destructor ----------------- */
+
+stack_pool_t* stack_pool_new(gsize stack_size, guint per_cpu) {
+    g_return_val_if_fail(stack_size > 0 && per_cpu > 0, NULL);
+
+    gsize page = (gsize)sysconf(_SC_PAGESIZE);
+    stack_pool_t *pool = g_new0(stack_pool_t, 1);
+    pool->cpus = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, stack_pool_cpu_free);
+    pool->stack_size = (stack_size + page - 1) & ~(page - 1);
+    pool->per_cpu = per_cpu;
+    return pool;
+}
+
+void stack_pool_free(stack_pool_t *pool) {
+    if (!pool) return;
+
+    g_hash_table_destroy(pool->cpus);
+    g_free(pool);
+}
+
+
+/* ----------------- Stack Pool Methods ----------------- */
+
+/* Called before time zero for every CPU of the schedules; stacks are faulted in on the node of the CPU */
+gboolean stack_pool_reserve(stack_pool_t *pool, gint cpu) {
+    g_return_val_if_fail(pool != NULL, FALSE);
+    if (cpu < 0 || g_hash_table_contains(pool->cpus, GINT_TO_POINTER(cpu))) return TRUE;
+
+    gsize page = (gsize)sysconf(_SC_PAGESIZE);
+    gsize span = page + pool->stack_size;
+    gint node = em_numa_node_of_cpu(cpu);
+
+    guint8 *map = em_numa_alloc(span * pool->per_cpu, node);
+    if (!map) return FALSE;
+
+    stack_pool_cpu_t *entry = g_new0(stack_pool_cpu_t, 1);
+    entry->cpu = cpu;
+    entry->node = node;
+    entry->map = map;
+    entry->map_size = span * pool->per_cpu;
+    entry->stacks = g_new0(em_stack_t, pool->per_cpu);
+    entry->n_stacks = pool->per_cpu;
+
+    for (guint i = 0; i < pool->per_cpu; i++) {
+        guint8 *guard = map + i * span;
+        if (mprotect(guard, page, PROT_NONE) < 0) {
+            g_printerr("[WARNING] Execution Manager: no guard page for the stacks of CPU %d (%s)\n", cpu, g_strerror(errno));
+        }
+        entry->stacks[i].base = guard + page;
+        entry->stacks[i].size = pool->stack_size;
+    }
+
+    g_hash_table_insert(pool->cpus, GINT_TO_POINTER(cpu), entry);
+    return TRUE;
+}
+
+/* Dispatcher only: a free stack of cpu, NULL if the CPU has none (reserved or free) */
+em_stack_t* stack_pool_acquire(stack_pool_t *pool, gint cpu) {
+    if (!pool || cpu < 0) return NULL;
+
+    stack_pool_cpu_t *entry = g_hash_table_lookup(pool->cpus, GINT_TO_POINTER(cpu));
+    if (!entry) return NULL;
+
+    for (guint i = 0; i < entry->n_stacks; i++) {
+        em_stack_t *stack = &entry->stacks[i];
+        if (!stack->busy) return stack;
+
+        /* Finished jobs are joined lazily, which hands their stack back */
+        if (pthread_tryjoin_np(stack->thread, NULL) == 0) {
+            stack->busy = FALSE;
+            return stack;
+        }
+    }
+    return NULL;
+}
+
+/* The thread created on the stack must stay joinable */
+void stack_pool_commit(em_stack_t *stack, pthread_t thread) {
+    g_return_if_fail(stack != NULL);
+
+    stack->thread = thread;
+    stack->busy = TRUE;
+}
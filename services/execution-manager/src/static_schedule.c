@@ -0,0 +1,86 @@
+#include "static_schedule.h"
+
+/* -----------------Helper Functions ----------------- */
+
+/* Entries come sorted and with distinct timestamps from the generator, so they are only appended */
+static void static_load_timeline(GQueue *timeline, GTree *index, const static_entry_t *entries, guint32 n_entries,
+                                 gconstpointer records, guint item_size) {
+    for (guint32 i = 0; i < n_entries; i++) {
+        timeline_entry_t *entry = g_new0(timeline_entry_t, 1);
+        entry->timestamp_ns = entries[i].timestamp_ns;
+        entry->items = g_array_sized_new(FALSE, FALSE, item_size, entries[i].count);
+        g_array_append_vals(entry->items, (const guint8 *)records + (gsize)entries[i].first * item_size, entries[i].count);
+
+        g_queue_push_tail(timeline, entry);
+        g_tree_insert(index, &entry->timestamp_ns, timeline->tail);
+    }
+}
+
+/* Mutable inputs need a scratch area next to them: they are the only ones copied out of .rodata */
+static void static_stage_inputs(schedule_t *sched) {
+    GHashTable *staged = g_hash_table_new(g_direct_hash, g_direct_equal);     // Map: .rodata input -> pooled copy
+    for (GList *l = sched->schedule_start_info->head; l; l = l->next) {
+        timeline_entry_t *entry = l->data;
+        for (guint i = 0; i < entry->items->len; i++) {
+            activation_data_t *act = timeline_entry_activation(entry, i);
+            if (!act->input_data || act->input_flags != TASK_INPUT_MUTABLE) continue;
+
+            gpointer copy = g_hash_table_lookup(staged, act->input_data);
+            if (!copy) {
+                copy = input_pool_stage(sched->schedule_inputs, act->input_data, act->input_size, TRUE);
+                g_hash_table_insert(staged, act->input_data, copy);
+            }
+            act->input_data = copy;
+        }
+    }
+    g_hash_table_destroy(staged);
+}
+
+
+/* ----------------- Static Schedule Loader ----------------- */
+
+schedule_t* schedule_new_static(const static_schedule_t *table) {
+    g_return_val_if_fail(table != NULL, NULL);
+
+    schedule_t *sched = schedule_new(table->name, table->version);
+    if (!sched) return NULL;
+    if (!schedule_set_clock(sched, table->clock)) {
+        schedule_free(sched);
+        return NULL;
+    }
+
+    /* 1. Names and dependency lists, indexed as the generator laid them out */
+    for (guint32 i = 0; i < table->n_task_names; i++) {
+        gchar *name = g_strdup(table->task_names[i]);
+        g_ptr_array_add(sched->schedule_task_names, name);
+        g_hash_table_insert(sched->schedule_name_index, name, GUINT_TO_POINTER(i + 1));
+    }
+    if (table->n_dependencies > 0) g_array_append_vals(sched->schedule_dependencies, table->dependencies, table->n_dependencies);
+
+    /* 2. Timelines, one bulk copy of the records per entry */
+    static_load_timeline(sched->schedule_start_info, sched->schedule_start_index, table->starts, table->n_starts,
+                         table->activations, sizeof(activation_data_t));
+    static_load_timeline(sched->schedule_end_info, sched->schedule_end_index, table->ends, table->n_ends,
+                         table->expirations, sizeof(expiration_data_t));
+    static_stage_inputs(sched);
+
+    /* 3. Result slots of the table, reset for this schedule */
+    gint pending_runs = 0;
+    pthread_mutex_lock(&sched->schedule_results_mutex);     // LOCK MUTEX
+    for (guint32 i = 0; i < table->n_results; i++) {
+        task_result_t *res = &table->results[i].result;
+        res->output_list = NULL;
+        res->remaining_runs = res->repetition;
+        res->placed = TRUE;
+        g_hash_table_insert(sched->schedule_results, GINT_TO_POINTER((gint)table->result_ids[i]), res);
+        pending_runs += res->repetition;
+    }
+    g_atomic_int_set(&sched->schedule_pending_runs, pending_runs);
+    pthread_mutex_unlock(&sched->schedule_results_mutex);   // UNLOCK MUTEX
+
+    sched->schedule_duration_ns = table->duration_ns;
+    sched->schedule_max_window_ns = table->max_window_ns;
+    g_print("[INFO] Execution Manager: schedule %s %s loaded from its static tables (%u activation(s), %u task(s)).\n",
+            table->name, table->version, table->n_activations, table->n_results);
+    return sched;
+}
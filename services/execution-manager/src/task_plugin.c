@@ -0,0 +1,63 @@
+#include "task_plugin.h"
+#include <dlfcn.h>
+
+/* ----------------- Plugin Constructor/Destructor ----------------- */
+
+task_plugin_t* task_plugin_load(const gchar *path) {
+    g_return_val_if_fail(path != NULL, NULL);
+
+    /* RTLD_NOW binds every symbol here, nothing is looked up lazily at release */
+    void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        g_printerr("[ERROR] Execution Manager: cannot load task plugin %s (%s)\n", path, dlerror());
+        return NULL;
+    }
+
+    task_plugin_init_func init = (task_plugin_init_func)dlsym(handle, TASK_PLUGIN_INIT_SYMBOL);
+    task_plugin_hook_func warmup = (task_plugin_hook_func)dlsym(handle, TASK_PLUGIN_WARMUP_SYMBOL);
+
+    if (init && !init()) {
+        g_printerr("[ERROR] Execution Manager: task plugin %s rejected its initialization.\n", path);
+        dlclose(handle);
+        return NULL;
+    }
+
+    /* Fault in the pages the task uses before time zero (mlockall keeps them resident) */
+    if (warmup) warmup();
+
+    task_plugin_t *plugin = g_new0(task_plugin_t, 1);
+    plugin->path = g_string_new(path);
+    plugin->handle = handle;
+    plugin->teardown = (task_plugin_hook_func)dlsym(handle, TASK_PLUGIN_TEARDOWN_SYMBOL);
+    plugin->task_exec = task_plugin_resolve(plugin, TASK_PLUGIN_ENTRY_SYMBOL);
+
+    g_print("[INFO] Execution Manager: task plugin %s loaded (init: %s, warmup: %s, teardown: %s)\n",
+            path, init ? "yes" : "no", warmup ? "yes" : "no", plugin->teardown ? "yes" : "no");
+    return plugin;
+}
+
+void task_plugin_free(task_plugin_t *plugin) {
+    if (!plugin) return;
+
+    if (plugin->teardown) plugin->teardown();
+    dlclose(plugin->handle);
+    g_string_free(plugin->path, TRUE);
+    g_free(plugin);
+}
+
+
+/* ----------------- Plugin Methods ----------------- */
+
+GThreadFunc task_plugin_resolve(task_plugin_t *plugin, const gchar *symbol) {
+    g_return_val_if_fail(plugin != NULL, NULL);
+    g_return_val_if_fail(symbol != NULL, NULL);
+
+    dlerror();
+    GThreadFunc func = (GThreadFunc)dlsym(plugin->handle, symbol);
+    const gchar *err = dlerror();
+    if (err || !func) {
+        g_printerr("[ERROR] Execution Manager: symbol %s not found in %s (%s)\n", symbol, plugin->path->str, err ? err : "NULL");
+        return NULL;
+    }
+    return func;
+}
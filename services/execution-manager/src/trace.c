@@ -0,0 +1,217 @@
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+/* -----------------Helper Functions ----------------- */
+
+static const gchar *trace_event_name(guint8 type) {
+    switch (type) {
+        case TRACE_EVENT_RELEASE:  return "release";
+        case TRACE_EVENT_START:    return "start";
+        case TRACE_EVENT_FINISH:   return "finish";
+        case TRACE_EVENT_DEADLINE: return "deadline";
+        case TRACE_EVENT_ABORT:    return "abort";
+        case TRACE_EVENT_WAKEUP:   return "wakeup";
+        case TRACE_EVENT_MODE:     return "mode_switch";
+        case TRACE_EVENT_DROP:     return "drop";
+        case TRACE_EVENT_COMPLETE: return "complete";
+        case TRACE_EVENT_OVERLOAD: return "overload";
+        case TRACE_EVENT_BUDGET:   return "budget_overrun";
+        default:                   return "unknown";
+    }
+}
+
+static gint open_trace_marker(void) {
+    const gchar *paths[] = {
+        "/sys/kernel/tracing/trace_marker",
+        "/sys/kernel/debug/tracing/trace_marker"
+    };
+    for (guint i = 0; i < G_N_ELEMENTS(paths); i++) {
+        gint fd = open(paths[i], O_WRONLY | O_CLOEXEC);
+        if (fd >= 0) return fd;
+    }
+    return -1;
+}
+
+static gint compare_trace_events(const void *a, const void *b) {
+    const trace_event_t *ev_a = (const trace_event_t *)a;
+    const trace_event_t *ev_b = (const trace_event_t *)b;
+    return (ev_a->timestamp_us < ev_b->timestamp_us) ? -1 : (ev_a->timestamp_us > ev_b->timestamp_us) ? 1 : 0;
+}
+
+/* Dispatcher events are drawn on their own track after the CPU tracks */
+#define TRACE_DISPATCHER_TID 1000
+
+static gint trace_event_tid(const trace_event_t *ev) {
+    return (ev->cpu < 0) ? TRACE_DISPATCHER_TID : ev->cpu;
+}
+
+
+
+/* ----------------- Trace Constructor/Destructor ----------------- */
+
+trace_buffer_t* trace_new(guint capacity, gboolean use_trace_marker) {
+    g_return_val_if_fail(capacity > 0, NULL);
+
+    trace_buffer_t *tb = g_new0(trace_buffer_t, 1);
+    tb->events = g_new0(trace_event_t, capacity);
+    tb->capacity = capacity;
+    tb->marker_fd = -1;
+
+    if (use_trace_marker) {
+        tb->marker_fd = open_trace_marker();
+        if (tb->marker_fd < 0)
+            g_printerr("[WARNING] Execution Manager: trace_marker not available, kernel mirroring disabled.\n");
+    }
+
+    return tb;
+}
+
+void trace_free(trace_buffer_t *tb) {
+    if (!tb) return;
+
+    if (tb->marker_fd >= 0) close(tb->marker_fd);
+    g_free(tb->events);
+    g_free(tb);
+}
+
+
+/* ----------------- Trace Methods ----------------- */
+
+void trace_reset(trace_buffer_t *tb, gint64 time_zero_us) {
+    g_return_if_fail(tb != NULL);
+
+    /* Only the slots used by the previous run have to be cleared */
+    guint used = MIN((guint)g_atomic_int_get(&tb->next), tb->capacity);
+    memset(tb->events, 0, used * sizeof(trace_event_t));
+
+    tb->time_zero_us = time_zero_us;
+    g_atomic_int_set(&tb->dropped, 0);
+    g_atomic_int_set(&tb->next, 0);
+}
+
+void trace_record(trace_buffer_t *tb, trace_event_type_t type, guint16 task_id, gint cpu, gint64 arg) {
+    if (!tb) return;
+
+    trace_record_at(tb, g_get_monotonic_time() - tb->time_zero_us, type, task_id, cpu, arg);
+}
+
+/* Same as trace_record with an explicit timestamp, used by the virtual time backends */
+void trace_record_at(trace_buffer_t *tb, gint64 timestamp_us, trace_event_type_t type, guint16 task_id, gint cpu, gint64 arg) {
+    if (!tb) return;
+
+    /* Reserve a slot without locking, the buffer never wraps */
+    gint idx = g_atomic_int_add(&tb->next, 1);
+    if (G_UNLIKELY(idx < 0 || (guint)idx >= tb->capacity)) {
+        g_atomic_int_inc(&tb->dropped);
+        return;
+    }
+
+    trace_event_t *ev = &tb->events[idx];
+    ev->timestamp_us = timestamp_us;
+    ev->arg = arg;
+    ev->task_id = task_id;
+    ev->cpu = (gint16)cpu;
+    ev->type = (guint8)type;
+    g_atomic_int_set(&ev->committed, 1);
+
+    /* Mirror the event in the ftrace buffer to correlate with sched_switch */
+    if (tb->marker_fd >= 0) {
+        gchar line[96];
+        gint len = g_snprintf(line, sizeof(line), "em: %s task=%u cpu=%d t=%ld arg=%ld\n",
+                              trace_event_name(ev->type), task_id, cpu, (long)ev->timestamp_us, (long)arg);
+        if (write(tb->marker_fd, line, len) < 0) {
+            /* Nothing to do on the hot path, the in-memory event is kept */
+        }
+    }
+}
+
+gboolean trace_export_chrome(trace_buffer_t *tb, const gchar *path) {
+    g_return_val_if_fail(tb != NULL, FALSE);
+    g_return_val_if_fail(path != NULL, FALSE);
+
+    /* 1. Snapshot the committed events in time order */
+    guint used = MIN((guint)g_atomic_int_get(&tb->next), tb->capacity);
+    trace_event_t *events = g_new0(trace_event_t, used > 0 ? used : 1);
+    guint count = 0;
+    for (guint i = 0; i < used; i++) {
+        if (g_atomic_int_get(&tb->events[i].committed))
+            events[count++] = tb->events[i];
+    }
+    qsort(events, count, sizeof(trace_event_t), compare_trace_events);
+
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        g_printerr("[ERROR] Execution Manager: cannot open trace file %s (%s)\n", path, g_strerror(errno));
+        g_free(events);
+        return FALSE;
+    }
+
+    /* 2. Track names */
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"dispatcher\"}}",
+            TRACE_DISPATCHER_TID);
+    GHashTable *named_cpus = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (guint i = 0; i < count; i++) {
+        if (events[i].cpu < 0 || g_hash_table_contains(named_cpus, GINT_TO_POINTER(events[i].cpu + 1))) continue;
+        g_hash_table_add(named_cpus, GINT_TO_POINTER(events[i].cpu + 1));
+        fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"CPU %d\"}}",
+                events[i].cpu, events[i].cpu);
+    }
+    g_hash_table_destroy(named_cpus);
+
+    /* 3. Pair START/FINISH into complete events, everything else is an instant event */
+    GHashTable *open_jobs = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)g_queue_free);
+    for (guint i = 0; i < count; i++) {
+        trace_event_t *ev = &events[i];
+        gpointer key = GUINT_TO_POINTER(ev->task_id);
+
+        if (ev->type == TRACE_EVENT_START) {
+            GQueue *starts = g_hash_table_lookup(open_jobs, key);
+            if (!starts) {
+                starts = g_queue_new();
+                g_hash_table_insert(open_jobs, key, starts);
+            }
+            g_queue_push_tail(starts, ev);
+            continue;
+        }
+
+        if (ev->type == TRACE_EVENT_FINISH) {
+            GQueue *starts = g_hash_table_lookup(open_jobs, key);
+            trace_event_t *start = starts ? g_queue_pop_head(starts) : NULL;
+            if (start) {
+                fprintf(out, ",\n{\"name\":\"task %u\",\"cat\":\"job\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%ld,\"dur\":%ld,\"args\":{\"task_id\":%u}}",
+                        ev->task_id, trace_event_tid(start), (long)start->timestamp_us,
+                        (long)(ev->timestamp_us - start->timestamp_us), ev->task_id);
+                continue;
+            }
+        }
+
+        fprintf(out, ",\n{\"name\":\"%s\",\"cat\":\"em\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%ld,\"args\":{\"task_id\":%u,\"arg\":%ld}}",
+                trace_event_name(ev->type), trace_event_tid(ev), (long)ev->timestamp_us, ev->task_id, (long)ev->arg);
+    }
+
+    /* 4. Jobs still running at export time only have their start */
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, open_jobs);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        for (GList *l = ((GQueue *)value)->head; l; l = l->next) {
+            trace_event_t *ev = l->data;
+            fprintf(out, ",\n{\"name\":\"start\",\"cat\":\"em\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%ld,\"args\":{\"task_id\":%u,\"arg\":%ld}}",
+                    trace_event_tid(ev), (long)ev->timestamp_us, ev->task_id, (long)ev->arg);
+        }
+    }
+    g_hash_table_destroy(open_jobs);
+
+    fprintf(out, "\n],\"otherData\":{\"dropped_events\":%d}}\n", g_atomic_int_get(&tb->dropped));
+    fclose(out);
+    g_free(events);
+
+    g_print("[INFO] Execution Manager: trace with %u events written to %s\n", count, path);
+    return TRUE;
+}
@@ -0,0 +1,223 @@
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "journal.h"
+#include "em_time.h"
+
+/*
+ * em-journal: offline reader of the execution manager journal.
+ * Rebuilds the results of the last run of every schedule (as schedule_results
+ * held them) and tells which runs were interrupted by a crash.
+ */
+
+/* --- Options --- */
+
+static gboolean opt_dump = FALSE;
+
+static GOptionEntry journal_entries[] = {
+    { "dump", 'd', 0, G_OPTION_ARG_NONE, &opt_dump, "Print every record before the summary", NULL },
+    G_OPTION_ENTRY_NULL
+};
+
+/* --- Reconstructed State --- */
+
+typedef struct {
+    guint64 runs;               // RUN_START records seen
+    gboolean open;              // Last run started and never ended
+    gboolean completed;         // Last run ended with every task run completed
+    gint64 start_ns;            // Monotonic time zero of the last run
+    gint64 start_real_us;       // Wall clock time zero of the last run
+} run_state_t;
+
+typedef struct {
+    guint16 schedule_id;
+    guint16 task_id;
+    guint64 completions;
+    guint64 misses;
+    guint64 aborts;
+    guint32 remaining_runs;
+    gint64 last_ns;             // Offset of the last event from the run time zero
+    gchar output[JOURNAL_OUTPUT_LEN + 1];
+    gboolean truncated;
+} task_state_t;
+
+typedef struct {
+    journal_t *journal;
+    run_state_t runs[JOURNAL_MAX_SCHEDULES];
+    GHashTable *tasks;          // Map: schedule_id << 16 | task_id -> task_state_t*
+} replay_t;
+
+
+/* -----------------Helper Functions ----------------- */
+
+static const gchar *event_name(guint8 type) {
+    switch (type) {
+        case JOURNAL_EVENT_RUN_START: return "run_start";
+        case JOURNAL_EVENT_COMPLETE:  return "complete";
+        case JOURNAL_EVENT_MISS:      return "miss";
+        case JOURNAL_EVENT_ABORT:     return "abort";
+        case JOURNAL_EVENT_RUN_END:   return "run_end";
+        default:                      return "unknown";
+    }
+}
+
+static gchar *format_real_time(gint64 real_us) {
+    GDateTime *dt = g_date_time_new_from_unix_local(real_us / G_USEC_PER_SEC);
+    if (!dt) return g_strdup("?");
+    gchar *date = g_date_time_format(dt, "%F %T");
+    gchar *text = g_strdup_printf("%s.%06ld", date, (long)(real_us % G_USEC_PER_SEC));
+    g_date_time_unref(dt);
+    g_free(date);
+    return text;
+}
+
+static gint compare_tasks(gconstpointer a, gconstpointer b) {
+    const task_state_t *ta = *(task_state_t *const *)a;
+    const task_state_t *tb = *(task_state_t *const *)b;
+    if (ta->schedule_id != tb->schedule_id) return (ta->schedule_id < tb->schedule_id) ? -1 : 1;
+    return (ta->task_id < tb->task_id) ? -1 : (ta->task_id > tb->task_id) ? 1 : 0;
+}
+
+/* A new run of a schedule starts from fresh results, as after schedule_reset */
+static void replay_reset_schedule(replay_t *replay, guint16 schedule_id) {
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, replay->tasks);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        if (((task_state_t *)value)->schedule_id == schedule_id) g_hash_table_iter_remove(&iter);
+    }
+}
+
+static void replay_record(const journal_record_t *rec, gpointer user_data) {
+    replay_t *replay = (replay_t *)user_data;
+    run_state_t *run = (rec->schedule_id < JOURNAL_MAX_SCHEDULES) ? &replay->runs[rec->schedule_id] : NULL;
+    gint64 offset_ns = run ? rec->timestamp_ns - run->start_ns : 0;
+
+    if (opt_dump) {
+        g_print("#%-8" G_GUINT64_FORMAT " %+12.3f ms %-9s %-24s task %5u cpu %3d runs left %3u arg %8ld %.*s\n",
+                rec->seq - 1, (gdouble)offset_ns / EM_NSEC_PER_MSEC, event_name(rec->type),
+                journal_schedule_name(replay->journal, rec->schedule_id), rec->task_id, rec->cpu,
+                rec->remaining_runs, (long)rec->arg, (gint)rec->output_len, rec->output);
+    }
+
+    /* 1. Run boundaries */
+    if (rec->type == JOURNAL_EVENT_RUN_START) {
+        if (!run) return;
+        run->runs++;
+        run->open = TRUE;
+        run->completed = FALSE;
+        run->start_ns = rec->timestamp_ns;
+        run->start_real_us = rec->arg;
+        replay_reset_schedule(replay, rec->schedule_id);
+        return;
+    }
+    if (rec->type == JOURNAL_EVENT_RUN_END) {
+        if (!run) return;
+        run->open = FALSE;
+        run->completed = (rec->arg != 0);
+        return;
+    }
+
+    /* 2. Task events */
+    gpointer key = GUINT_TO_POINTER(((guint)rec->schedule_id << 16) | rec->task_id);
+    task_state_t *task = g_hash_table_lookup(replay->tasks, key);
+    if (!task) {
+        task = g_new0(task_state_t, 1);
+        task->schedule_id = rec->schedule_id;
+        task->task_id = rec->task_id;
+        g_hash_table_insert(replay->tasks, key, task);
+    }
+    task->remaining_runs = rec->remaining_runs;
+    task->last_ns = offset_ns;
+
+    switch (rec->type) {
+        case JOURNAL_EVENT_COMPLETE:
+            task->completions++;
+            memcpy(task->output, rec->output, rec->output_len);
+            task->output[rec->output_len] = '\0';
+            task->truncated = (rec->flags & JOURNAL_FLAG_TRUNCATED) != 0;
+            break;
+        case JOURNAL_EVENT_MISS:
+            task->misses++;
+            break;
+        case JOURNAL_EVENT_ABORT:
+            task->aborts++;
+            break;
+        default:
+            break;
+    }
+}
+
+static void replay_print(replay_t *replay, guint64 valid) {
+    journal_header_t *h = replay->journal->header;
+    gchar *created = format_real_time(h->created_us);
+
+    g_print("\n=== JOURNAL: %s [%" G_GUINT64_FORMAT " record(s), %" G_GUINT64_FORMAT " readable, ring of %" G_GUINT64_FORMAT ", created %s] ===\n",
+            replay->journal->path, h->head, valid, h->capacity, created);
+    g_free(created);
+
+    g_print("\n--- RUNS ---\n");
+    for (guint16 id = 0; id < JOURNAL_MAX_SCHEDULES; id++) {
+        run_state_t *run = &replay->runs[id];
+        if (run->runs == 0) continue;
+        gchar *started = format_real_time(run->start_real_us);
+        g_print("%s: %" G_GUINT64_FORMAT " run(s) in the ring, last started %s, %s\n",
+                journal_schedule_name(replay->journal, id), run->runs, started,
+                run->open ? "INTERRUPTED" : run->completed ? "completed" : "ended with runs left");
+        g_free(started);
+    }
+
+    g_print("\n--- TASK RESULTS (last run) ---\n");
+    GPtrArray *tasks = g_ptr_array_new();
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, replay->tasks);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) g_ptr_array_add(tasks, value);
+    g_ptr_array_sort(tasks, compare_tasks);
+
+    for (guint i = 0; i < tasks->len; i++) {
+        task_state_t *task = g_ptr_array_index(tasks, i);
+        g_print("%s Task ID %u: Runs Left: %u, Completions: %" G_GUINT64_FORMAT ", Misses: %" G_GUINT64_FORMAT
+                ", Aborts: %" G_GUINT64_FORMAT ", Last Event: %.3f ms, Last Output: %s%s\n",
+                journal_schedule_name(replay->journal, task->schedule_id), task->task_id, task->remaining_runs,
+                task->completions, task->misses, task->aborts, (gdouble)task->last_ns / EM_NSEC_PER_MSEC,
+                task->completions ? task->output : "N/A", task->truncated ? "..." : "");
+    }
+    g_print("==========================================\n");
+    g_ptr_array_free(tasks, TRUE);
+}
+
+
+int main(int argc, char *argv[]) {
+    GError *error = NULL;
+    GOptionContext *context = g_option_context_new("<journal> - execution manager journal reader");
+    g_option_context_add_main_entries(context, journal_entries, NULL);
+    if (!g_option_context_parse(context, &argc, &argv, &error)) {
+        g_printerr("[ERROR] em-journal: %s\n", error->message);
+        g_error_free(error);
+        g_option_context_free(context);
+        return 1;
+    }
+    g_option_context_free(context);
+
+    if (argc != 2) {
+        g_printerr("[ERROR] em-journal: expected one journal file\n");
+        return 1;
+    }
+
+    journal_t *journal = journal_open_readonly(argv[1]);
+    if (!journal) return 1;
+
+    replay_t replay = { 0 };
+    replay.journal = journal;
+    replay.tasks = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+
+    guint64 valid = journal_foreach(journal, replay_record, &replay);
+    replay_print(&replay, valid);
+
+    g_hash_table_destroy(replay.tasks);
+    journal_close(journal);
+    return 0;
+}
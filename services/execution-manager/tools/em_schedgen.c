@@ -0,0 +1,582 @@
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * em-schedgen: compiles a schedule description into a C source file of
+ * const tables (static_schedule_t), linked into the execution manager and
+ * loaded with schedule_new_static. Every check of schedule_add_task and the
+ * timeline sort happen here, at build time.
+ *
+ * Description, one directive per line (# starts a comment):
+ *   schedule    <name> <version> [monotonic|tai]
+ *   include     <header>                      declares the input types (and the task functions)
+ *   task        <id> <name> <function> <fifo|rr|other> <start_ms> <end_ms> <priority> <cpu> <repetition> [<dep id>,...]
+ *   criticality <id> <lo|hi> <budget_lo_us> <budget_hi_us>
+ *   cpu_budget  <id> <budget_us> <notify|demote|abort>
+ *   input       <id> <type> <shared|mutable> <initializer>
+ * A task line is one activation, a task id repeated on several lines runs in
+ * several windows (the repetition of the last line is kept, as at runtime).
+ */
+
+#define SCHEDGEN_DEFAULT_SYMBOL "em_static_schedule"
+
+/* --- Options --- */
+
+static gchar *opt_symbol = NULL;
+
+static GOptionEntry schedgen_entries[] = {
+    { "symbol", 's', 0, G_OPTION_ARG_STRING, &opt_symbol, "Name of the static_schedule_t (default " SCHEDGEN_DEFAULT_SYMBOL ")", "NAME" },
+    G_OPTION_ENTRY_NULL
+};
+
+/* --- Description Model --- */
+
+typedef struct {
+    guint16 id;
+    gchar *name;
+    gchar *function;
+    const gchar *policy;        // SCHED_* macro emitted as is
+    gint priority;
+    gint cpu;
+    guint repetition;
+    gint64 start_ns;
+    gint64 end_ns;
+    GArray *deps;               // guint16
+    guint order;                // Line order, ties of the timeline sort
+    guint line;
+} gen_task_t;
+
+typedef struct {
+    gchar *type;
+    gchar *initializer;
+    gboolean mutable_input;
+} gen_input_t;
+
+typedef struct {
+    gboolean hi;
+    gint64 budget_lo_us;
+    gint64 budget_hi_us;
+} gen_criticality_t;
+
+typedef struct {
+    gint64 budget_us;
+    const gchar *action;        // TASK_BUDGET_* macro emitted as is
+} gen_cpu_budget_t;
+
+typedef struct {
+    gchar *name;
+    gchar *version;
+    const gchar *clock;         // CLOCK_* macro emitted as is
+    GPtrArray *includes;        // gchar*
+    GPtrArray *tasks;           // gen_task_t*, in line order
+    GHashTable *inputs;         // Map: task id -> gen_input_t*
+    GHashTable *criticality;    // Map: task id -> gen_criticality_t*
+    GHashTable *cpu_budgets;    // Map: task id -> gen_cpu_budget_t*
+} gen_schedule_t;
+
+
+/* -----------------Helper Functions ----------------- */
+
+static void gen_task_free(gpointer data) {
+    gen_task_t *task = data;
+    g_free(task->name);
+    g_free(task->function);
+    g_array_free(task->deps, TRUE);
+    g_free(task);
+}
+
+static void gen_input_free(gpointer data) {
+    gen_input_t *input = data;
+    g_free(input->type);
+    g_free(input->initializer);
+    g_free(input);
+}
+
+static gboolean parse_int(const gchar *str, gint64 min, gint64 max, gint64 *value) {
+    gchar *end = NULL;
+    gint64 v = g_ascii_strtoll(str, &end, 10);
+    if (end == str || *end != '\0' || v < min || v > max) return FALSE;
+    *value = v;
+    return TRUE;
+}
+
+/* Same conversion as the control socket: ms with fractions, rounded to ns */
+static gboolean parse_ms(const gchar *str, gint64 *ns) {
+    gchar *end = NULL;
+    gdouble ms = g_ascii_strtod(str, &end);
+    if (end == str || *end != '\0' || ms < 0 || ms > (gdouble)G_MAXINT64 / 1000000.0) return FALSE;
+    *ns = (gint64)(ms * 1000000.0 + 0.5);
+    return TRUE;
+}
+
+static gboolean is_identifier(const gchar *str) {
+    if (!g_ascii_isalpha(*str) && *str != '_') return FALSE;
+    for (; *str; str++) {
+        if (!g_ascii_isalnum(*str) && *str != '_') return FALSE;
+    }
+    return TRUE;
+}
+
+static gboolean is_version(const gchar *str) {
+    gchar **parts = g_strsplit(str, ".", -1);
+    gboolean valid = g_strv_length(parts) == 3;
+    for (guint i = 0; valid && parts[i]; i++) {
+        gint64 v;
+        valid = parse_int(parts[i], 0, G_MAXINT32, &v);
+    }
+    g_strfreev(parts);
+    return valid;
+}
+
+static gint compare_start(gconstpointer a, gconstpointer b) {
+    const gen_task_t *ta = *(const gen_task_t *const *)a;
+    const gen_task_t *tb = *(const gen_task_t *const *)b;
+    if (ta->start_ns != tb->start_ns) return (ta->start_ns > tb->start_ns) - (ta->start_ns < tb->start_ns);
+    return (ta->order > tb->order) - (ta->order < tb->order);
+}
+
+static gint compare_end(gconstpointer a, gconstpointer b) {
+    const gen_task_t *ta = *(const gen_task_t *const *)a;
+    const gen_task_t *tb = *(const gen_task_t *const *)b;
+    if (ta->end_ns != tb->end_ns) return (ta->end_ns > tb->end_ns) - (ta->end_ns < tb->end_ns);
+    return (ta->order > tb->order) - (ta->order < tb->order);
+}
+
+static gint compare_ids(gconstpointer a, gconstpointer b) {
+    guint16 ia = *(const guint16 *)a;
+    guint16 ib = *(const guint16 *)b;
+    return (ia > ib) - (ia < ib);
+}
+
+
+/* ----------------- Description Parser ----------------- */
+
+/* One directive, error set to a static message on failure */
+static gboolean parse_directive(gen_schedule_t *gs, gchar **argv, guint argc, const gchar *rest, guint line, const gchar **error) {
+    gint64 v;
+
+    if (g_strcmp0(argv[0], "schedule") == 0) {
+        if (argc != 3 && argc != 4) { *error = "usage: schedule <name> <version> [monotonic|tai]"; return FALSE; }
+        if (!is_version(argv[2])) { *error = "version is not <major>.<minor>.<patch>"; return FALSE; }
+        if (argc == 4 && g_strcmp0(argv[3], "tai") != 0 && g_strcmp0(argv[3], "monotonic") != 0) { *error = "bad clock"; return FALSE; }
+        g_free(gs->name);
+        g_free(gs->version);
+        gs->name = g_strdup(argv[1]);
+        gs->version = g_strdup(argv[2]);
+        gs->clock = (argc == 4 && g_strcmp0(argv[3], "tai") == 0) ? "CLOCK_TAI" : "CLOCK_MONOTONIC";
+
+    } else if (g_strcmp0(argv[0], "include") == 0) {
+        if (argc != 2) { *error = "usage: include <header>"; return FALSE; }
+        g_ptr_array_add(gs->includes, g_strdup(argv[1]));
+
+    } else if (g_strcmp0(argv[0], "task") == 0) {
+        if (argc != 10 && argc != 11) { *error = "usage: task <id> <name> <function> <policy> <start_ms> <end_ms> <priority> <cpu> <repetition> [<dep id>,...]"; return FALSE; }
+        gen_task_t *task = g_new0(gen_task_t, 1);
+        task->deps = g_array_new(FALSE, FALSE, sizeof(guint16));
+        task->order = gs->tasks->len;
+        task->line = line;
+        g_ptr_array_add(gs->tasks, task);
+
+        if (!parse_int(argv[1], 0, G_MAXUINT16, &v)) { *error = "bad task id"; return FALSE; }
+        task->id = (guint16)v;
+        task->name = g_strdup(argv[2]);
+        if (!is_identifier(argv[3])) { *error = "function is not a C identifier"; return FALSE; }
+        task->function = g_strdup(argv[3]);
+
+        if (g_strcmp0(argv[4], "fifo") == 0) task->policy = "SCHED_FIFO";
+        else if (g_strcmp0(argv[4], "rr") == 0) task->policy = "SCHED_RR";
+        else if (g_strcmp0(argv[4], "other") == 0) task->policy = "SCHED_OTHER";
+        else { *error = "bad policy"; return FALSE; }
+
+        if (!parse_ms(argv[5], &task->start_ns) || !parse_ms(argv[6], &task->end_ns) || task->start_ns >= task->end_ns) { *error = "bad window"; return FALSE; }
+        if (!parse_int(argv[7], G_MININT8, G_MAXINT8, &v)) { *error = "bad priority"; return FALSE; }
+        task->priority = (gint)v;
+        if (!parse_int(argv[8], -1, G_MAXINT16, &v)) { *error = "bad cpu"; return FALSE; }
+        task->cpu = (gint)v;
+        if (!parse_int(argv[9], 0, G_MAXUINT8, &v)) { *error = "bad repetition"; return FALSE; }
+        task->repetition = (guint)v;
+
+        gchar **deps = (argc == 11) ? g_strsplit(argv[10], ",", -1) : NULL;
+        for (guint i = 0; deps && deps[i]; i++) {
+            if (!parse_int(deps[i], 0, G_MAXUINT16, &v)) { g_strfreev(deps); *error = "bad dependency id"; return FALSE; }
+            guint16 dep = (guint16)v;
+            g_array_append_val(task->deps, dep);
+        }
+        g_strfreev(deps);
+
+    } else if (g_strcmp0(argv[0], "criticality") == 0) {
+        if (argc != 5) { *error = "usage: criticality <id> <lo|hi> <budget_lo_us> <budget_hi_us>"; return FALSE; }
+        gen_criticality_t *crit = g_new0(gen_criticality_t, 1);
+        gint64 id;
+        gboolean valid = parse_int(argv[1], 0, G_MAXUINT16, &id) &&
+                         (g_strcmp0(argv[2], "lo") == 0 || g_strcmp0(argv[2], "hi") == 0) &&
+                         parse_int(argv[3], 0, G_MAXINT64, &crit->budget_lo_us) &&
+                         parse_int(argv[4], 0, G_MAXINT64, &crit->budget_hi_us) &&
+                         (crit->budget_hi_us == 0 || crit->budget_lo_us <= crit->budget_hi_us);
+        if (!valid) {
+            g_free(crit);
+            *error = "bad criticality";
+            return FALSE;
+        }
+        crit->hi = (g_strcmp0(argv[2], "hi") == 0);
+        g_hash_table_replace(gs->criticality, GINT_TO_POINTER((gint)id), crit);
+
+    } else if (g_strcmp0(argv[0], "cpu_budget") == 0) {
+        if (argc != 4) { *error = "usage: cpu_budget <id> <budget_us> <notify|demote|abort>"; return FALSE; }
+        gen_cpu_budget_t *budget = g_new0(gen_cpu_budget_t, 1);
+        gint64 id;
+        budget->action = g_strcmp0(argv[3], "notify") == 0 ? "TASK_BUDGET_NOTIFY" :
+                         g_strcmp0(argv[3], "demote") == 0 ? "TASK_BUDGET_DEMOTE" :
+                         g_strcmp0(argv[3], "abort") == 0 ? "TASK_BUDGET_ABORT" : NULL;
+        if (!parse_int(argv[1], 0, G_MAXUINT16, &id) || !parse_int(argv[2], 1, G_MAXUINT32, &budget->budget_us) || !budget->action) {
+            g_free(budget);
+            *error = "bad cpu_budget";
+            return FALSE;
+        }
+        g_hash_table_replace(gs->cpu_budgets, GINT_TO_POINTER((gint)id), budget);
+
+    } else if (g_strcmp0(argv[0], "input") == 0) {
+        if (argc < 5 || !rest) { *error = "usage: input <id> <type> <shared|mutable> <initializer>"; return FALSE; }
+        gint64 id;
+        if (!parse_int(argv[1], 0, G_MAXUINT16, &id)) { *error = "bad task id"; return FALSE; }
+        if (g_strcmp0(argv[3], "shared") != 0 && g_strcmp0(argv[3], "mutable") != 0) { *error = "input is shared or mutable"; return FALSE; }
+        gen_input_t *input = g_new0(gen_input_t, 1);
+        input->type = g_strdup(argv[2]);
+        input->initializer = g_strdup(rest);
+        input->mutable_input = (g_strcmp0(argv[3], "mutable") == 0);
+        g_hash_table_replace(gs->inputs, GINT_TO_POINTER((gint)id), input);
+
+    } else {
+        *error = "unknown directive";
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static gboolean parse_description(gen_schedule_t *gs, const gchar *path) {
+    gchar *contents = NULL;
+    GError *err = NULL;
+    if (!g_file_get_contents(path, &contents, NULL, &err)) {
+        g_printerr("em-schedgen: %s\n", err->message);
+        g_error_free(err);
+        return FALSE;
+    }
+
+    gboolean ok = TRUE;
+    gchar **lines = g_strsplit(contents, "\n", -1);
+    for (guint i = 0; lines[i]; i++) {
+        gchar *comment = strchr(lines[i], '#');
+        if (comment) *comment = '\0';
+        gchar *text = g_strstrip(lines[i]);
+        if (*text == '\0') continue;
+
+        /* The initializer of an input is the rest of the line, spaces included */
+        gchar **argv = g_strsplit_set(text, " \t", -1);
+        GPtrArray *fields = g_ptr_array_new();
+        const gchar *rest = NULL;
+        const gchar *cursor = text;
+        for (guint f = 0; argv[f]; f++) {
+            if (*argv[f] == '\0') continue;
+            cursor = strstr(cursor, argv[f]);
+            if (fields->len == 4 && g_strcmp0(g_ptr_array_index(fields, 0), "input") == 0) {
+                rest = cursor;
+                g_ptr_array_add(fields, argv[f]);
+                break;
+            }
+            g_ptr_array_add(fields, argv[f]);
+            cursor += strlen(argv[f]);
+        }
+        g_ptr_array_add(fields, NULL);
+
+        const gchar *error = NULL;
+        if (!parse_directive(gs, (gchar **)fields->pdata, fields->len - 1, rest, i + 1, &error)) {
+            g_printerr("%s:%u: %s\n", path, i + 1, error);
+            ok = FALSE;
+        }
+        g_ptr_array_free(fields, TRUE);
+        g_strfreev(argv);
+    }
+    g_strfreev(lines);
+    g_free(contents);
+    return ok;
+}
+
+/* References between directives, checked once the whole file is read */
+static gboolean check_description(gen_schedule_t *gs, const gchar *path) {
+    gboolean ok = TRUE;
+    GHashTable *ids = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (guint i = 0; i < gs->tasks->len; i++) {
+        gen_task_t *task = g_ptr_array_index(gs->tasks, i);
+        g_hash_table_add(ids, GINT_TO_POINTER((gint)task->id));
+    }
+
+    if (!gs->name) {
+        g_printerr("%s: no schedule directive\n", path);
+        ok = FALSE;
+    }
+    if (gs->tasks->len == 0) {
+        g_printerr("%s: no task\n", path);
+        ok = FALSE;
+    }
+    for (guint i = 0; i < gs->tasks->len; i++) {
+        gen_task_t *task = g_ptr_array_index(gs->tasks, i);
+        for (guint d = 0; d < task->deps->len; d++) {
+            if (g_hash_table_contains(ids, GINT_TO_POINTER((gint)g_array_index(task->deps, guint16, d)))) continue;
+            g_printerr("%s:%u: task %u depends on unknown task %u\n", path, task->line, task->id, g_array_index(task->deps, guint16, d));
+            ok = FALSE;
+        }
+    }
+
+    GHashTable *refs[] = { gs->inputs, gs->criticality, gs->cpu_budgets };
+    const gchar *ref_names[] = { "input", "criticality", "cpu_budget" };
+    for (guint r = 0; r < G_N_ELEMENTS(refs); r++) {
+        GHashTableIter iter;
+        gpointer key;
+        g_hash_table_iter_init(&iter, refs[r]);
+        while (g_hash_table_iter_next(&iter, &key, NULL)) {
+            if (g_hash_table_contains(ids, key)) continue;
+            g_printerr("%s: %s of unknown task %d\n", path, ref_names[r], GPOINTER_TO_INT(key));
+            ok = FALSE;
+        }
+    }
+    g_hash_table_destroy(ids);
+    return ok;
+}
+
+
+/* ----------------- Table Emitter ----------------- */
+
+/* One entry per distinct start (or end) timestamp of the sorted tasks */
+static void emit_timeline(GString *out, const gchar *name, GPtrArray *sorted, gboolean starts) {
+    g_string_append_printf(out, "static const static_entry_t %s[] = {\n", name);
+    for (guint i = 0; i < sorted->len;) {
+        gen_task_t *task = g_ptr_array_index(sorted, i);
+        gint64 ts = starts ? task->start_ns : task->end_ns;
+        guint first = i;
+        while (i < sorted->len) {
+            gen_task_t *next = g_ptr_array_index(sorted, i);
+            if ((starts ? next->start_ns : next->end_ns) != ts) break;
+            i++;
+        }
+        g_string_append_printf(out, "    { %" G_GINT64_FORMAT ", %u, %u },\n", ts, first, i - first);
+    }
+    g_string_append(out, "};\n\n");
+}
+
+static guint count_entries(GPtrArray *sorted, gboolean starts) {
+    guint n = 0;
+    for (guint i = 0; i < sorted->len; i++) {
+        gen_task_t *task = g_ptr_array_index(sorted, i);
+        gen_task_t *prev = i > 0 ? g_ptr_array_index(sorted, i - 1) : NULL;
+        if (!prev || (starts ? prev->start_ns != task->start_ns : prev->end_ns != task->end_ns)) n++;
+    }
+    return n;
+}
+
+static GString *emit_tables(gen_schedule_t *gs, const gchar *source, const gchar *symbol) {
+    GString *out = g_string_new(NULL);
+
+    /* 1. Interned names, in first appearance order */
+    GPtrArray *names = g_ptr_array_new();
+    GHashTable *name_ids = g_hash_table_new(g_str_hash, g_str_equal);     // Map: name -> name_id + 1
+    for (guint i = 0; i < gs->tasks->len; i++) {
+        gen_task_t *task = g_ptr_array_index(gs->tasks, i);
+        if (g_hash_table_contains(name_ids, task->name)) continue;
+        g_ptr_array_add(names, task->name);
+        g_hash_table_insert(name_ids, task->name, GUINT_TO_POINTER(names->len));
+    }
+
+    /* 2. Activations by start, expirations by end, results by id (last repetition wins) */
+    GPtrArray *by_start = g_ptr_array_new();
+    GPtrArray *by_end = g_ptr_array_new();
+    GHashTable *repetitions = g_hash_table_new(g_direct_hash, g_direct_equal);
+    gint64 duration_ns = 0, max_window_ns = 0;
+    for (guint i = 0; i < gs->tasks->len; i++) {
+        gen_task_t *task = g_ptr_array_index(gs->tasks, i);
+        g_ptr_array_add(by_start, task);
+        g_ptr_array_add(by_end, task);
+        g_hash_table_replace(repetitions, GINT_TO_POINTER((gint)task->id), GUINT_TO_POINTER(task->repetition + 1));
+        duration_ns = MAX(duration_ns, task->end_ns);
+        max_window_ns = MAX(max_window_ns, task->end_ns - task->start_ns);
+    }
+    g_ptr_array_sort(by_start, compare_start);
+    g_ptr_array_sort(by_end, compare_end);
+
+    GArray *result_ids = g_array_new(FALSE, FALSE, sizeof(guint16));
+    GHashTableIter iter;
+    gpointer key;
+    g_hash_table_iter_init(&iter, repetitions);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        guint16 id = (guint16)GPOINTER_TO_INT(key);
+        g_array_append_val(result_ids, id);
+    }
+    g_array_sort(result_ids, compare_ids);
+
+    /* 3. Prologue */
+    g_string_append_printf(out, "/* Generated by em-schedgen from %s, do not edit */\n\n", source);
+    g_string_append(out, "#include \"static_schedule.h\"\n");
+    for (guint i = 0; i < gs->includes->len; i++) g_string_append_printf(out, "#include \"%s\"\n", (gchar *)g_ptr_array_index(gs->includes, i));
+    g_string_append(out, "\n");
+
+    GHashTable *declared = g_hash_table_new(g_str_hash, g_str_equal);
+    for (guint i = 0; i < gs->tasks->len; i++) {
+        gen_task_t *task = g_ptr_array_index(gs->tasks, i);
+        if (!g_hash_table_add(declared, task->function)) continue;
+        g_string_append_printf(out, "gpointer %s(gpointer data);\n", task->function);
+    }
+    g_hash_table_destroy(declared);
+    g_string_append(out, "\n");
+
+    for (guint i = 0; i < result_ids->len; i++) {
+        guint16 id = g_array_index(result_ids, guint16, i);
+        gen_input_t *input = g_hash_table_lookup(gs->inputs, GINT_TO_POINTER((gint)id));
+        if (input) g_string_append_printf(out, "static const %s em_input_%u = %s;\n", input->type, id, input->initializer);
+    }
+    if (g_hash_table_size(gs->inputs) > 0) g_string_append(out, "\n");
+
+    /* 4. Names and dependency lists */
+    g_string_append(out, "static const gchar *const em_task_names[] = {\n");
+    for (guint i = 0; i < names->len; i++) {
+        gchar *escaped = g_strescape(g_ptr_array_index(names, i), NULL);
+        g_string_append_printf(out, "    \"%s\",\n", escaped);
+        g_free(escaped);
+    }
+    g_string_append(out, "};\n\n");
+
+    guint n_deps = 0;
+    GString *deps = g_string_new(NULL);
+    for (guint i = 0; i < by_start->len; i++) {
+        gen_task_t *task = g_ptr_array_index(by_start, i);
+        for (guint d = 0; d < task->deps->len; d++, n_deps++) g_string_append_printf(deps, " %u,", g_array_index(task->deps, guint16, d));
+    }
+    if (n_deps > 0) g_string_append_printf(out, "static const guint16 em_dependencies[] = {%s };\n\n", deps->str);
+
+    /* 5. Records */
+    g_string_append(out, "static const activation_data_t em_activations[] = {\n");
+    guint deps_offset = 0;
+    for (guint i = 0; i < by_start->len; i++) {
+        gen_task_t *task = g_ptr_array_index(by_start, i);
+        gen_input_t *input = g_hash_table_lookup(gs->inputs, GINT_TO_POINTER((gint)task->id));
+        gen_criticality_t *crit = g_hash_table_lookup(gs->criticality, GINT_TO_POINTER((gint)task->id));
+        gen_cpu_budget_t *budget = g_hash_table_lookup(gs->cpu_budgets, GINT_TO_POINTER((gint)task->id));
+
+        g_string_append_printf(out, "    { .task_exec = %s, .task_id = %u, .name_id = %u, .policy = %s, .priority = %d, .cpu_affinity = %d, .repetition = %u,\n",
+                               task->function, task->id, GPOINTER_TO_UINT(g_hash_table_lookup(name_ids, task->name)) - 1,
+                               task->policy, task->priority, task->cpu, task->repetition);
+        g_string_append_printf(out, "      .deps_offset = %u, .deps_count = %u", deps_offset, task->deps->len);
+        if (input) {
+            g_string_append_printf(out, ",\n      .input_data = (gpointer)&em_input_%u, .input_size = sizeof(%s), .input_flags = %s",
+                                   task->id, input->type, input->mutable_input ? "TASK_INPUT_MUTABLE" : "TASK_INPUT_SHARED");
+        }
+        if (crit) {
+            g_string_append_printf(out, ",\n      .criticality = %s, .budget_lo_us = %" G_GINT64_FORMAT ", .budget_hi_us = %" G_GINT64_FORMAT,
+                                   crit->hi ? "TASK_CRIT_HI" : "TASK_CRIT_LO", crit->budget_lo_us, crit->budget_hi_us);
+        }
+        if (budget) {
+            g_string_append_printf(out, ",\n      .cpu_budget_us = %" G_GINT64_FORMAT ", .budget_action = %s", budget->budget_us, budget->action);
+        }
+        g_string_append(out, " },\n");
+        deps_offset += task->deps->len;
+    }
+    g_string_append(out, "};\n\n");
+
+    g_string_append(out, "static const expiration_data_t em_expirations[] = {\n");
+    for (guint i = 0; i < by_end->len; i++) {
+        gen_task_t *task = g_ptr_array_index(by_end, i);
+        g_string_append_printf(out, "    { .release_ns = %" G_GINT64_FORMAT ", .task_id = %u, .cpu_affinity = %d, .name_id = %u },\n",
+                               task->start_ns, task->id, task->cpu, GPOINTER_TO_UINT(g_hash_table_lookup(name_ids, task->name)) - 1);
+    }
+    g_string_append(out, "};\n\n");
+
+    emit_timeline(out, "em_starts", by_start, TRUE);
+    emit_timeline(out, "em_ends", by_end, FALSE);
+
+    /* 6. Result slots (.data), reset by every load */
+    g_string_append(out, "static static_result_slot_t em_results[] = {\n");
+    for (guint i = 0; i < result_ids->len; i++) {
+        guint repetition = GPOINTER_TO_UINT(g_hash_table_lookup(repetitions, GINT_TO_POINTER((gint)g_array_index(result_ids, guint16, i)))) - 1;
+        g_string_append_printf(out, "    { .result = { .remaining_runs = %u, .repetition = %u, .placed = TRUE } },\n", repetition, repetition);
+    }
+    g_string_append(out, "};\n\nstatic const guint16 em_result_ids[] = {");
+    for (guint i = 0; i < result_ids->len; i++) g_string_append_printf(out, " %u,", g_array_index(result_ids, guint16, i));
+    g_string_append(out, " };\n\n");
+
+    /* 7. Table */
+    gchar *name = g_strescape(gs->name, NULL);
+    g_string_append_printf(out, "const static_schedule_t %s = {\n", symbol);
+    g_string_append_printf(out, "    .name = \"%s\",\n    .version = \"%s\",\n    .clock = %s,\n    .duration_ns = %" G_GINT64_FORMAT ",\n    .max_window_ns = %" G_GINT64_FORMAT ",\n",
+                           name, gs->version, gs->clock, duration_ns, max_window_ns);
+    g_string_append_printf(out, "    .starts = em_starts,\n    .n_starts = %u,\n", count_entries(by_start, TRUE));
+    g_string_append_printf(out, "    .activations = em_activations,\n    .n_activations = %u,\n", by_start->len);
+    g_string_append_printf(out, "    .ends = em_ends,\n    .n_ends = %u,\n", count_entries(by_end, FALSE));
+    g_string_append_printf(out, "    .expirations = em_expirations,\n    .n_expirations = %u,\n", by_end->len);
+    g_string_append_printf(out, "    .task_names = em_task_names,\n    .n_task_names = %u,\n", names->len);
+    g_string_append_printf(out, "    .dependencies = %s,\n    .n_dependencies = %u,\n", n_deps > 0 ? "em_dependencies" : "NULL", n_deps);
+    g_string_append_printf(out, "    .results = em_results,\n    .result_ids = em_result_ids,\n    .n_results = %u,\n};\n", result_ids->len);
+    g_free(name);
+
+    g_string_free(deps, TRUE);
+    g_array_free(result_ids, TRUE);
+    g_hash_table_destroy(repetitions);
+    g_ptr_array_free(by_end, TRUE);
+    g_ptr_array_free(by_start, TRUE);
+    g_hash_table_destroy(name_ids);
+    g_ptr_array_free(names, TRUE);
+    return out;
+}
+
+
+/* ----------------- Main ----------------- */
+
+int main(int argc, char *argv[]) {
+    GError *err = NULL;
+    GOptionContext *context = g_option_context_new("<description> <output.c> - compile a schedule into static C tables");
+    g_option_context_add_main_entries(context, schedgen_entries, NULL);
+    if (!g_option_context_parse(context, &argc, &argv, &err) || argc != 3) {
+        g_printerr("em-schedgen: %s\n", err ? err->message : "usage: em-schedgen [--symbol NAME] <description> <output.c>");
+        g_clear_error(&err);
+        g_option_context_free(context);
+        return EXIT_FAILURE;
+    }
+    g_option_context_free(context);
+
+    const gchar *symbol = opt_symbol ? opt_symbol : SCHEDGEN_DEFAULT_SYMBOL;
+    if (!is_identifier(symbol)) {
+        g_printerr("em-schedgen: %s is not a C identifier\n", symbol);
+        return EXIT_FAILURE;
+    }
+
+    gen_schedule_t gs = { 0 };
+    gs.includes = g_ptr_array_new_with_free_func(g_free);
+    gs.tasks = g_ptr_array_new_with_free_func(gen_task_free);
+    gs.inputs = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, gen_input_free);
+    gs.criticality = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    gs.cpu_budgets = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+
+    int rc = EXIT_FAILURE;
+    if (parse_description(&gs, argv[1]) && check_description(&gs, argv[1])) {
+        gchar *source = g_path_get_basename(argv[1]);
+        GString *out = emit_tables(&gs, source, symbol);
+        if (g_file_set_contents(argv[2], out->str, out->len, &err)) {
+            g_print("em-schedgen: %s -> %s (%u activation(s))\n", argv[1], argv[2], gs.tasks->len);
+            rc = EXIT_SUCCESS;
+        } else {
+            g_printerr("em-schedgen: %s\n", err->message);
+            g_error_free(err);
+        }
+        g_string_free(out, TRUE);
+        g_free(source);
+    }
+
+    g_hash_table_destroy(gs.cpu_budgets);
+    g_hash_table_destroy(gs.criticality);
+    g_hash_table_destroy(gs.inputs);
+    g_ptr_array_free(gs.tasks, TRUE);
+    g_ptr_array_free(gs.includes, TRUE);
+    g_free(gs.name);
+    g_free(gs.version);
+    g_free(opt_symbol);
+    return rc;
+}